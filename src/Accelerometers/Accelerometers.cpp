@@ -55,6 +55,7 @@ static unsigned int GetDecimalPlaces(uint8_t dataResolution) noexcept
 // Local accelerometer handling
 
 #include "LIS3DH.h"
+#include "ResonanceAnalyser.h"
 
 constexpr uint8_t DefaultResolution = 10;
 
@@ -75,6 +76,20 @@ static uint8_t axisLookup[3];
 static bool axisInverted[3];
 static volatile bool successfulStart = false;
 static volatile bool failedStart = false;
+static ResonanceAnalyser *resonanceAnalyser = nullptr;		// created the first time it is used
+static volatile bool analysingResonances = false;				// true if the current run was started with A1
+
+// Report the results of resonance analysis if it was requested
+static void ReportResonances(unsigned int sampleRate, uint8_t axes) noexcept
+{
+	if (analysingResonances)
+	{
+		String<StringLength100> temp;
+		resonanceAnalyser->Report(sampleRate, axes, temp.GetRef());
+		reprap.GetPlatform().MessageF(GenericMessage, "%s\n", temp.c_str());
+		analysingResonances = false;
+	}
+}
 
 static IoPort spiCsPort;
 static IoPort irqPort;
@@ -177,6 +192,10 @@ static uint8_t TranslateAxes(uint8_t axes) noexcept
 
 									// Convert it to a float number of g
 									const float fVal = (float)(int16_t)dataVal/(float)(1u << GetBitsAfterPoint(resolution));
+									if (analysingResonances)
+									{
+										resonanceAnalyser->AddSample(axis, fVal);
+									}
 
 									// Append it to the buffer
 									temp.catf(",%.*f", decimalPlaces, (double)fVal);
@@ -201,6 +220,7 @@ static uint8_t TranslateAxes(uint8_t axes) noexcept
 					temp.printf("Rate %u, overflows %u\n", dataRate, numOverflows);
 					f->Write(temp.c_str());
 				}
+				ReportResonances(dataRate, axesRequested);
 			}
 			else
 			{
@@ -424,7 +444,20 @@ GCodeResult Accelerometers::StartAccelerometer(GCodeBuffer& gb, const StringRef&
 	// Set up the collection parameters in case the accelerometer task wakes up early
 	axesRequested = axes;
 	numSamplesRequested = numSamples;
-	(void)mode;									// TODO implement mode
+	if (mode == 1)
+	{
+		// Analyse the resonances as well as saving the data
+		if (resonanceAnalyser == nullptr)
+		{
+			resonanceAnalyser = new ResonanceAnalyser;
+		}
+		resonanceAnalyser->Init();
+		analysingResonances = true;
+	}
+	else
+	{
+		analysingResonances = false;
+	}
 
 	// Create the file for saving the data. First calculate the approximate file size so that we can preallocate storage to reduce the risk of overflow.
 	const unsigned int numAxes = (axesRequested & 1u) + ((axesRequested >> 1) & 1u) + ((axesRequested >> 2) & 1u);
@@ -487,7 +520,7 @@ GCodeResult Accelerometers::StartAccelerometer(GCodeBuffer& gb, const StringRef&
 		numRemoteOverflows = 0;
 
 		accelerometerFile = f;
-		const GCodeResult rslt = CanInterface::StartAccelerometer(device, axes, numSamples, mode, gb, reply);
+		const GCodeResult rslt = CanInterface::StartAccelerometer(device, axes, numSamples, 0, gb, reply);		// we do the resonance analysis on this board
 		if (rslt > GCodeResult::warning)
 		{
 			accelerometerFile->Close();
@@ -603,6 +636,7 @@ void Accelerometers::ProcessReceivedData(CanAddress src, const CanMessageAcceler
 				temp.printf("%u", expectedRemoteSampleNumber);
 				++expectedRemoteSampleNumber;
 
+				uint8_t axesLeft = expectedRemoteAxes;
 				for (unsigned int axis = 0; axis < numAxes; ++axis)
 				{
 					// Extract one value from the message. A value spans at most two words in the buffer.
@@ -629,6 +663,12 @@ void Accelerometers::ProcessReceivedData(CanAddress src, const CanMessageAcceler
 
 					// Convert it to a float number of g
 					const float fVal = (float)(int16_t)val/(float)(1u << GetBitsAfterPoint(receivedResolution));
+					if (analysingResonances)
+					{
+						const unsigned int axisLetter = LowestSetBit(axesLeft);
+						resonanceAnalyser->AddSample(axisLetter, fVal);
+						axesLeft &= ~(1u << axisLetter);
+					}
 
 					// Append it to the buffer
 					temp.catf(",%.*f", decimalPlaces, (double)fVal);
@@ -644,6 +684,7 @@ void Accelerometers::ProcessReceivedData(CanAddress src, const CanMessageAcceler
 				String<StringLength50> temp;
 				temp.printf("Rate %u, overflows %u\n", (unsigned int)msg.actualSampleRate, numRemoteOverflows);
 				f->Write(temp.c_str());
+				ReportResonances(msg.actualSampleRate, expectedRemoteAxes);
 				f->Truncate();				// truncate the file in case we didn't write all the preallocated space
 				f->Close();
 				accelerometerFile = nullptr;
@@ -0,0 +1,119 @@
+/*
+ * ResonanceAnalyser.cpp
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ */
+
+#include "ResonanceAnalyser.h"
+
+#if SUPPORT_ACCELEROMETERS
+
+void ResonanceAnalyser::Init() noexcept
+{
+	for (unsigned int bin = 0; bin < NumBins; ++bin)
+	{
+		coefficients[bin] = 2.0 * cosf(TwoPi * (MinNormalisedFrequency + bin * BinWidth));
+	}
+	for (unsigned int axis = 0; axis < 3; ++axis)
+	{
+		for (unsigned int bin = 0; bin < NumBins; ++bin)
+		{
+			s1[axis][bin] = s2[axis][bin] = 0.0;
+		}
+		offset[axis] = 0.0;
+		numSamples[axis] = 0;
+	}
+}
+
+void ResonanceAnalyser::AddSample(unsigned int axis, float val) noexcept
+{
+	if (numSamples[axis] == 0)
+	{
+		offset[axis] = val;
+	}
+	++numSamples[axis];
+	val -= offset[axis];
+
+	float *_ecv_array const p1 = s1[axis];
+	float *_ecv_array const p2 = s2[axis];
+	for (unsigned int bin = 0; bin < NumBins; ++bin)
+	{
+		const float s = val + coefficients[bin] * p1[bin] - p2[bin];
+		p2[bin] = p1[bin];
+		p1[bin] = s;
+	}
+}
+
+// Get the power in a bin, scaled by the square of the number of samples
+inline float ResonanceAnalyser::GetPower(unsigned int axis, unsigned int bin) const noexcept
+{
+	const float a = s1[axis][bin], b = s2[axis][bin];
+	return fsquare(a) + fsquare(b) - coefficients[bin] * a * b;
+}
+
+void ResonanceAnalyser::Report(unsigned int sampleRate, uint8_t axes, const StringRef& reply) const noexcept
+{
+	reply.copy("Resonances:");
+	for (unsigned int axis = 0; axis < 3; ++axis)
+	{
+		if ((axes & (1u << axis)) == 0)
+		{
+			continue;
+		}
+
+		reply.catf(" %c ", "XYZ"[axis]);
+
+		// Find the bin with the most power, ignoring the end bins because we can't interpolate them
+		unsigned int peakBin = 0;
+		float peakPower = 0.0;
+		for (unsigned int bin = 1; bin + 1 < NumBins; ++bin)
+		{
+			const float power = GetPower(axis, bin);
+			if (power > peakPower)
+			{
+				peakPower = power;
+				peakBin = bin;
+			}
+		}
+
+		if (peakBin == 0 || numSamples[axis] < 2 * NumBins)
+		{
+			reply.cat("none");
+			continue;
+		}
+
+		// Fit a parabola through the magnitudes of the peak bin and its neighbours to get a better estimate of the peak frequency
+		const float before = sqrtf(GetPower(axis, peakBin - 1)), peak = sqrtf(peakPower), after = sqrtf(GetPower(axis, peakBin + 1));
+		const float denominator = before - 2.0 * peak + after;
+		const float delta = (denominator < 0.0) ? 0.5 * (before - after)/denominator : 0.0;
+		const float peakFrequency = (MinNormalisedFrequency + (peakBin + delta) * BinWidth) * sampleRate;
+		reply.catf("%.1fHz", (double)peakFrequency);
+
+		// Estimate the damping ratio from the width of the peak at half power, interpolating between bins
+		const float halfPower = 0.5 * peakPower;
+		unsigned int lowBin = peakBin;
+		while (lowBin != 0 && GetPower(axis, lowBin - 1) > halfPower)
+		{
+			--lowBin;
+		}
+		unsigned int highBin = peakBin;
+		while (highBin + 1 < NumBins && GetPower(axis, highBin + 1) > halfPower)
+		{
+			++highBin;
+		}
+		if (lowBin != 0 && highBin + 1 < NumBins)
+		{
+			const float lowPower = GetPower(axis, lowBin), belowPower = GetPower(axis, lowBin - 1);
+			const float highPower = GetPower(axis, highBin), abovePower = GetPower(axis, highBin + 1);
+			const float lowEdge = lowBin - (lowPower - halfPower)/(lowPower - belowPower);
+			const float highEdge = highBin + (highPower - halfPower)/(highPower - abovePower);
+			const float bandwidth = (highEdge - lowEdge) * BinWidth * sampleRate;
+			reply.catf(" damping %.3f", (double)(bandwidth/(2.0 * peakFrequency)));
+		}
+	}
+}
+
+#endif
+
+// End
@@ -0,0 +1,47 @@
+/*
+ * ResonanceAnalyser.h
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ *
+ * This class estimates the dominant resonance of each axis from accelerometer samples as they are received, so that no file needs to be transferred and analysed.
+ * We don't know the actual sampling rate until the end of the run, so the spectrum is calculated using the Goertzel algorithm at fixed fractions of the sampling rate.
+ * This needs no sample buffer and the frequencies are converted to Hz when the run is complete.
+ */
+
+#ifndef SRC_ACCELEROMETERS_RESONANCEANALYSER_H_
+#define SRC_ACCELEROMETERS_RESONANCEANALYSER_H_
+
+#include <RepRapFirmware.h>
+
+#if SUPPORT_ACCELEROMETERS
+
+class ResonanceAnalyser
+{
+public:
+	void Init() noexcept;
+
+	// Add a sample in g for axis 0, 1 or 2
+	void AddSample(unsigned int axis, float val) noexcept;
+
+	// Append the peak frequency and damping ratio of each requested axis to the reply
+	void Report(unsigned int sampleRate, uint8_t axes, const StringRef& reply) const noexcept;
+
+	static constexpr unsigned int NumBins = 96;
+	static constexpr float MinNormalisedFrequency = 0.004;		// the lowest frequency we analyse as a fraction of the sampling rate, 5.4Hz at 1344 samples/sec
+	static constexpr float MaxNormalisedFrequency = 0.2;		// the highest frequency we analyse as a fraction of the sampling rate, 269Hz at 1344 samples/sec
+	static constexpr float BinWidth = (MaxNormalisedFrequency - MinNormalisedFrequency)/(NumBins - 1);
+
+private:
+	float GetPower(unsigned int axis, unsigned int bin) const noexcept;
+
+	float coefficients[NumBins];								// 2 * cos(2 * pi * normalised frequency) for each bin
+	float s1[3][NumBins];										// Goertzel filter state for each axis and bin
+	float s2[3][NumBins];
+	float offset[3];											// the first sample of each axis, subtracted from all samples to remove the effect of gravity
+	unsigned int numSamples[3];
+};
+
+#endif
+
+#endif /* SRC_ACCELEROMETERS_RESONANCEANALYSER_H_ */
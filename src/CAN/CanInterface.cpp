@@ -75,6 +75,17 @@ static uint16_t longestWaitMessageType = 0;
 
 static uint32_t peakTimeSyncTxDelay = 0;
 
+// Motion message statistics, so that we can see how much of the bus bandwidth motion commands are using
+static unsigned int motionMessagesSent = 0;
+static uint32_t motionBytesSent = 0;
+static uint32_t lastMotionStatsTime = 0;
+
+// Motion message queue latency measurement. Motion buffers are sent in the order they are queued, so we can keep their queue times in a parallel FIFO.
+static uint32_t motionQueueTimes[NumCanBuffers];
+static unsigned int motionQueueTimesIn = 0, motionQueueTimesOut = 0;
+static volatile uint32_t motionLatency = 0;						// decaying peak of the time between queueing a motion message and it having been sent, in step clocks
+static uint32_t maxMotionLatency = 0;							// the peak value since the last diagnostics report
+
 // Debug
 static unsigned int goodTimeStamps = 0;
 static unsigned int badTimeStamps = 0;
@@ -136,6 +147,7 @@ static uint32_t can0Memory[Can0Config.GetMemorySize()] __attribute__ ((section (
 static CanDevice *can0dev = nullptr;
 
 static unsigned int txTimeouts[Can0Config.numTxBuffers + 1] = { 0 };
+static uint32_t txMaxWaitTicks[Can0Config.numTxBuffers + 1] = { 0 };		// the longest time we have waited for space in each transmit buffer or the FIFO
 static uint32_t lastCancelledId = 0;
 
 #if DUAL_CAN
@@ -469,7 +481,13 @@ uint16_t CanInterface::GetTimeStampPeriod() noexcept
 // Send a message on the CAN FD channel and record any errors
 static void SendCanMessage(CanDevice::TxBufferNumber whichBuffer, uint32_t timeout, CanMessageBuffer *buffer) noexcept
 {
+	const uint32_t startTime = StepTimer::GetTimerTicks();
 	const uint32_t cancelledId = can0dev->SendMessage(whichBuffer, timeout, buffer);
+	const uint32_t waitTime = StepTimer::GetTimerTicks() - startTime;
+	if (waitTime > txMaxWaitTicks[(unsigned int)whichBuffer])
+	{
+		txMaxWaitTicks[(unsigned int)whichBuffer] = waitTime;
+	}
 	if (cancelledId != 0)
 	{
 		++txTimeouts[(unsigned int)whichBuffer];
@@ -516,10 +534,13 @@ extern "C" [[noreturn]] void CanSenderLoop(void *) noexcept
 				else if (pendingMotionBuffers != nullptr)
 				{
 					CanMessageBuffer *buf;
+					uint32_t whenQueued;
 					{
 						TaskCriticalSectionLocker lock;
 						buf = pendingMotionBuffers;
 						pendingMotionBuffers = buf->next;
+						whenQueued = motionQueueTimes[motionQueueTimesOut];
+						motionQueueTimesOut = (motionQueueTimesOut + 1) % NumCanBuffers;
 #if 0	//unused
 						--numPendingMotionBuffers;
 #endif
@@ -529,6 +550,17 @@ extern "C" [[noreturn]] void CanSenderLoop(void *) noexcept
 					SendCanMessage(TxBufferIndexMotion, MaxMotionSendWait, buf);
 					reprap.GetPlatform().OnProcessingCanMessage();
 
+					// Update the latency statistics
+					{
+						const uint32_t latency = StepTimer::GetTimerTicks() - whenQueued;
+						const uint32_t decayedLatency = motionLatency - (motionLatency >> 6);
+						motionLatency = max<uint32_t>(latency, decayedLatency);
+						if (latency > maxMotionLatency)
+						{
+							maxMotionLatency = latency;
+						}
+					}
+
 #ifdef CAN_DEBUG
 					// Display a debug message too
 					debugPrintf("CCCR %08" PRIx32 ", PSR %08" PRIx32 ", ECR %08" PRIx32 ", TXBRP %08" PRIx32 ", TXBTO %08" PRIx32 ", st %08" PRIx32 "\n",
@@ -731,6 +763,11 @@ void CanInterface::SendMotion(CanMessageBuffer *buf) noexcept
 	{
 		TaskCriticalSectionLocker lock;
 
+		++motionMessagesSent;
+		motionBytesSent += buf->dataLength;
+		motionQueueTimes[motionQueueTimesIn] = StepTimer::GetTimerTicks();
+		motionQueueTimesIn = (motionQueueTimesIn + 1) % NumCanBuffers;
+
 		if (pendingMotionBuffers == nullptr)
 		{
 			pendingMotionBuffers = buf;
@@ -748,6 +785,12 @@ void CanInterface::SendMotion(CanMessageBuffer *buf) noexcept
 	canSenderTask.Give();
 }
 
+// Return the recent peak latency of motion messages in step clocks. The peak decays slowly so that a single late message does not keep the motion lead time long for ever.
+uint32_t CanInterface::GetMotionLatency() noexcept
+{
+	return motionLatency;
+}
+
 #if 0	// not currently used
 
 // Get the number of motion messages waiting to be sent through the Tx fifo
@@ -1351,6 +1394,41 @@ void CanInterface::Diagnostics(MessageType mtype) noexcept
 	}
 
 	reprap.GetPlatform().MessageF(mtype, "Tx timeouts%s\n", str.c_str());
+
+	// Report the longest time each sender had to wait for its transmit buffer, in the same order as the timeouts
+	str.Clear();
+	c = ' ';
+	for (uint32_t& wt : txMaxWaitTicks)
+	{
+		str.catf("%c%.2f", c, (double)((float)wt * (1000.0/(float)StepClockRate)));
+		wt = 0;
+		c = ',';
+	}
+	reprap.GetPlatform().MessageF(mtype, "Tx max waits (ms)%s\n", str.c_str());
+
+	{
+		const uint32_t now = millis();
+		const uint32_t interval = now - lastMotionStatsTime;
+		lastMotionStatsTime = now;
+		unsigned int msgs;
+		uint32_t bytes;
+		{
+			TaskCriticalSectionLocker lock;
+			msgs = motionMessagesSent;
+			bytes = motionBytesSent;
+			motionMessagesSent = 0;
+			motionBytesSent = 0;
+		}
+		p.MessageF(mtype, "Motion messages sent %u (%" PRIu32 "/sec), data bytes %" PRIu32 " (%" PRIu32 "/sec, mean %u/msg)\n",
+					msgs, (interval == 0) ? 0 : (uint32_t)(((uint64_t)msgs * 1000u)/interval),
+					bytes, (interval == 0) ? 0 : (uint32_t)(((uint64_t)bytes * 1000u)/interval),
+					(msgs == 0) ? 0 : (unsigned int)(bytes/msgs));
+	}
+	p.MessageF(mtype, "Motion latency max %.2fms, current %.2fms, prepare-ahead time %.1fms\n",
+				(double)((float)maxMotionLatency * (1000.0/(float)StepClockRate)),
+				(double)((float)motionLatency * (1000.0/(float)StepClockRate)),
+				(double)((float)CanMotion::GetPreparedTimeTarget() * (1000.0/(float)StepClockRate)));
+	maxMotionLatency = 0;
 	longestWaitTime = 0;
 	longestWaitMessageType = 0;
 	peakTimeSyncTxDelay = 0;
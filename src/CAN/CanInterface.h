@@ -70,6 +70,7 @@ namespace CanInterface
 
 	// Motor control functions
 	void SendMotion(CanMessageBuffer *buf) noexcept;
+	uint32_t GetMotionLatency() noexcept;
 	GCodeResult EnableRemoteDrivers(const CanDriversList& drivers, const StringRef& reply) noexcept;
 	void EnableRemoteDrivers(const CanDriversList& drivers) noexcept;
 	GCodeResult DisableRemoteDrivers(const CanDriversList& drivers, const StringRef& reply) noexcept;
@@ -44,6 +44,11 @@ namespace CanMotion
 	static volatile uint32_t whenRevertedAll;
 	static Mutex stopListMutex;
 	static uint8_t nextSeq[CanId::MaxCanAddress + 1] = { 0 };
+	static uint32_t whenLastSentMotion = 0;							// the millis() time at which we last sent a movement message
+	static bool haveSentMotion = false;
+
+	constexpr uint32_t RemoteMovePrepareTime = StepClockRate/100;		// 10ms allowance for an expansion board to receive a movement message and prepare the move
+	constexpr uint32_t RemoteDriversIdleTimeout = 2000;				// if we haven't sent a movement message for this many milliseconds then we assume that no remote drivers are in use
 
 	static CanMessageBuffer *GetBuffer(const PrepParams& params, DriverId canDriver) noexcept;
 	static void InternalStopDriverWhenProvisional(DriverId driver) noexcept;
@@ -259,6 +264,8 @@ uint32_t CanMotion::FinishMovement(const DDA& dda, uint32_t moveStartTime, bool
 					}
 					CanInterface::SendMotion(buf);								// queues the buffer for sending and frees it when done
 					clocks = currentMoveClocks;
+					whenLastSentMotion = millis();
+					haveSentMotion = true;
 				}
 				else
 				{
@@ -278,6 +285,20 @@ bool CanMotion::CanPrepareMove() noexcept
 	return CanMessageBuffer::GetFreeBuffers() >= MaxCanBoards;
 }
 
+// Return how far ahead in step clocks we should prepare moves.
+// If remote drivers are in use then we allow twice the motion latency on top of the minimum, but never more than the usual fixed prepare-ahead time,
+// so that pausing and stopping respond faster when the CAN bus is lightly loaded. The latency is the recent peak time to get a movement message onto the bus,
+// plus an allowance for the expansion board to process it, because expansion boards don't report how long that takes.
+// If no remote drivers are in use then we use the usual fixed prepare-ahead time, because the CAN latency tells us nothing about local moves.
+uint32_t CanMotion::GetPreparedTimeTarget() noexcept
+{
+	if (!haveSentMotion || millis() - whenLastSentMotion > RemoteDriversIdleTimeout)
+	{
+		return DDA::UsualMinimumPreparedTime;
+	}
+	return min<uint32_t>(DDA::MinimumAdaptivePreparedTime + 2 * (CanInterface::GetMotionLatency() + RemoteMovePrepareTime), DDA::UsualMinimumPreparedTime);
+}
+
 // This is called by the CanSender task to check if we have any urgent messages to send
 // The only urgent messages we may have currently are messages to stop drivers, or to tell them that all drivers have now been stopped and they need to revert to the requested stop position.
 CanMessageBuffer *CanMotion::GetUrgentMessage() noexcept
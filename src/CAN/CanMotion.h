@@ -26,6 +26,7 @@ namespace CanMotion
 #endif
 	uint32_t FinishMovement(const DDA& dda, uint32_t moveStartTime, bool simulating) noexcept;
 	bool CanPrepareMove() noexcept;
+	uint32_t GetPreparedTimeTarget() noexcept;
 	CanMessageBuffer *GetUrgentMessage() noexcept;
 
 	// The next 4 functions may be called from the step ISR, so they can't send CAN messages directly
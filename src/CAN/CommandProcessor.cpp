@@ -40,10 +40,68 @@
 
 #if HAS_SBC_INTERFACE
 # include "SBC/SbcInterface.h"
+#endif
+
+#if HAS_MASS_STORAGE
+# include <Storage/FileStore.h>
+#endif
+
+// Cache of the most recently read part of a firmware file, so that each block request from a bootloader doesn't need its own file read or SBC round trip
+constexpr size_t MaxFileChunkSize = 448;	// Maximum size of file chunks for reading firmware files. Should be a multiple of sizeof(CanMessageFirmwareUpdateResponse::data) for best CAN performance
+static char firmwareChunk[MaxFileChunkSize];
+static String<MaxFilenameLength> firmwareChunkFileName;
+static uint32_t firmwareChunkOffset = 0, firmwareChunkLength = 0, firmwareFileLength = 0;
+
+// Make sure that firmwareChunk holds the data at fileOffset in the specified firmware file, reading ahead as much as it can hold. Return false if the file can't be read.
+static bool LoadFirmwareChunk(const char *fname, uint32_t fileOffset) noexcept
+{
+	// A request for offset zero starts a new update, so read the file again in case it has been replaced
+	if (fileOffset != 0 && fileOffset >= firmwareChunkOffset && fileOffset < firmwareChunkOffset + firmwareChunkLength && firmwareChunkFileName.Equals(fname))
+	{
+		return true;
+	}
 
-constexpr size_t MaxFileChunkSize = 448;	// Maximum size of file chunks for reading files from the SBC. Should be a multiple of sizeof(CanMessageFirmwareUpdateResponse::data) for best CAN performance
-char sbcFirmwareChunk[MaxFileChunkSize];
+	firmwareChunkLength = 0;
+	uint32_t bytesRead = MaxFileChunkSize;
+#if HAS_SBC_INTERFACE
+	if (reprap.UsingSbcInterface())
+	{
+		if (!reprap.GetSbcInterface().GetFileChunk(fname, fileOffset, firmwareChunk, bytesRead, firmwareFileLength))
+		{
+			return false;
+		}
+	}
+	else
+#endif
+	{
+#if HAS_MASS_STORAGE
+		FileStore * const f = reprap.GetPlatform().OpenFile(FIRMWARE_DIRECTORY, fname, OpenMode::read);
+		if (f == nullptr)
+		{
+			return false;
+		}
+		firmwareFileLength = f->Length();
+		bytesRead = (fileOffset < firmwareFileLength) ? min<uint32_t>(firmwareFileLength - fileOffset, MaxFileChunkSize) : 0;
+		const bool ok = bytesRead == 0 || (f->Seek(fileOffset) && f->Read(firmwareChunk, bytesRead) == (int)bytesRead);
+		f->Close();
+		if (!ok)
+		{
+			return false;
+		}
+#else
+		return false;
 #endif
+	}
+
+	if (bytesRead == 0 && fileOffset < firmwareFileLength)
+	{
+		return false;
+	}
+	firmwareChunkFileName.copy(fname);
+	firmwareChunkOffset = fileOffset;
+	firmwareChunkLength = bytesRead;
+	return true;
+}
 
 // Handle a firmware update request
 static void HandleFirmwareBlockRequest(CanMessageBuffer *buf) noexcept
@@ -63,157 +121,65 @@ pre(buf->id.MsgType() == CanMessageType::firmwareBlockRequest)
 		uint32_t fileOffset = msg.fileOffset, fileLength = 0;
 		uint32_t lreq = msg.lengthRequested;
 
-#if HAS_SBC_INTERFACE
-		if (reprap.UsingSbcInterface())
+		if (LoadFirmwareChunk(fname.c_str(), fileOffset))
 		{
-			// Fetch the firmware file from the SBC
-			uint32_t bytesRead = min<uint32_t>(lreq, MaxFileChunkSize);
-			if (reprap.GetSbcInterface().GetFileChunk(fname.c_str(), fileOffset, sbcFirmwareChunk, bytesRead, fileLength))
-			{
-				if (fileOffset >= fileLength)
-				{
-					CanMessageFirmwareUpdateResponse * const msgp = buf->SetupResponseMessage<CanMessageFirmwareUpdateResponse>(0, CanInterface::GetCurrentMasterAddress(), src);
-					msgp->dataLength = 0;
-					msgp->err = CanMessageFirmwareUpdateResponse::ErrBadOffset;
-					msgp->fileLength = fileLength;
-					msgp->fileOffset = 0;
-					buf->dataLength = msgp->GetActualDataLength();
-					CanInterface::SendResponseNoFree(buf);
-
-					reprap.GetPlatform().MessageF(ErrorMessage, "Received firmware update request with bad file offset, actual %" PRIu32 " max %" PRIu32 "\n", fileOffset, fileLength);
-				}
-				else
-				{
-					if (fileLength - fileOffset < lreq)
-					{
-						lreq = fileLength - fileOffset;
-					}
-
-//debugPrintf("Sending %" PRIu32 " bytes at offset %" PRIu32 "\n", lreq, fileOffset);
-
-					size_t bytesSent = 0;
-					for (;;)
-					{
-						CanMessageFirmwareUpdateResponse * msgp = buf->SetupResponseMessage<CanMessageFirmwareUpdateResponse>(0, CanInterface::GetCurrentMasterAddress(), src);
-						const size_t lengthToSend = min<size_t>(bytesRead - bytesSent, sizeof(msgp->data));
-						memcpy(msgp->data, sbcFirmwareChunk + bytesSent, lengthToSend);
-						msgp->dataLength = lengthToSend;
-						msgp->err = CanMessageFirmwareUpdateResponse::ErrNone;
-						msgp->fileLength = fileLength;
-						msgp->fileOffset = fileOffset;
-						buf->dataLength = msgp->GetActualDataLength();
-						CanInterface::SendResponseNoFree(buf);
-
-						bytesSent += lengthToSend;
-						fileOffset += lengthToSend;
-						lreq -= lengthToSend;
-						if (lreq == 0)
-						{
-							break;
-						}
-
-						if (bytesSent == (size_t)bytesRead)
-						{
-							bytesRead = min<uint32_t>(lreq, MaxFileChunkSize);
-							if (!reprap.GetSbcInterface().GetFileChunk(fname.c_str(), fileOffset, sbcFirmwareChunk, bytesRead, fileLength))
-							{
-								msgp = buf->SetupResponseMessage<CanMessageFirmwareUpdateResponse>(0, CanInterface::GetCurrentMasterAddress(), src);
-								msgp->dataLength = 0;
-								msgp->err = CanMessageFirmwareUpdateResponse::ErrOther;
-								msgp->fileLength = fileLength;
-								msgp->fileOffset = 0;
-								buf->dataLength = msgp->GetActualDataLength();
-								CanInterface::SendResponseNoFree(buf);
-
-								reprap.GetPlatform().MessageF(ErrorMessage, "Error reading firmware update file '%s'\n", fname.c_str());
-								reprap.GetExpansion().UpdateFailed(src);
-								return;
-							}
-							bytesSent = 0;
-						}
-					}
-				}
-			}
-			else
+			fileLength = firmwareFileLength;
+			if (fileOffset >= fileLength)
 			{
 				CanMessageFirmwareUpdateResponse * const msgp = buf->SetupResponseMessage<CanMessageFirmwareUpdateResponse>(0, CanInterface::GetCurrentMasterAddress(), src);
 				msgp->dataLength = 0;
-				msgp->err = CanMessageFirmwareUpdateResponse::ErrNoFile;
+				msgp->err = CanMessageFirmwareUpdateResponse::ErrBadOffset;
 				msgp->fileLength = fileLength;
 				msgp->fileOffset = 0;
 				buf->dataLength = msgp->GetActualDataLength();
 				CanInterface::SendResponseNoFree(buf);
-				reprap.GetPlatform().MessageF(ErrorMessage, "Firmware file %s not found", fname.c_str());
-				reprap.GetExpansion().UpdateFailed(src);
-				return;
+
+				reprap.GetPlatform().MessageF(ErrorMessage, "Received firmware update request with bad file offset, actual %" PRIu32 " max %" PRIu32 "\n", fileOffset, fileLength);
 			}
-		}
-		else
-#endif
-		{
-#if HAS_MASS_STORAGE
-			// Fetch the firmware file from the local SD card
-			FileStore * const f = reprap.GetPlatform().OpenFile(FIRMWARE_DIRECTORY, fname.c_str(), OpenMode::read);
-			if (f != nullptr)
+			else
 			{
-				fileLength = f->Length();
-				if (fileOffset >= fileLength)
+				if (fileLength - fileOffset < lreq)
 				{
-					CanMessageFirmwareUpdateResponse * const msgp = buf->SetupResponseMessage<CanMessageFirmwareUpdateResponse>(0, CanInterface::GetCurrentMasterAddress(), src);
-					msgp->dataLength = 0;
-					msgp->err = CanMessageFirmwareUpdateResponse::ErrBadOffset;
+					lreq = fileLength - fileOffset;
+				}
+
+//debugPrintf("Sending %" PRIu32 " bytes at offset %" PRIu32 "\n", lreq, fileOffset);
+
+				for (;;)
+				{
+					CanMessageFirmwareUpdateResponse * msgp = buf->SetupResponseMessage<CanMessageFirmwareUpdateResponse>(0, CanInterface::GetCurrentMasterAddress(), src);
+					const size_t lengthToSend = min<size_t>(min<uint32_t>(lreq, firmwareChunkOffset + firmwareChunkLength - fileOffset), sizeof(msgp->data));
+					memcpy(msgp->data, firmwareChunk + (fileOffset - firmwareChunkOffset), lengthToSend);
+					msgp->dataLength = lengthToSend;
+					msgp->err = CanMessageFirmwareUpdateResponse::ErrNone;
 					msgp->fileLength = fileLength;
-					msgp->fileOffset = 0;
+					msgp->fileOffset = fileOffset;
 					buf->dataLength = msgp->GetActualDataLength();
 					CanInterface::SendResponseNoFree(buf);
 
-					reprap.GetPlatform().MessageF(ErrorMessage, "Received firmware update request with bad file offset, actual %" PRIu32 " max %" PRIu32 "\n", fileOffset, fileLength);
-				}
-				else
-				{
-					f->Seek(fileOffset);
-					if (fileLength - fileOffset < lreq)
+					fileOffset += lengthToSend;
+					lreq -= lengthToSend;
+					if (lreq == 0)
 					{
-						lreq = fileLength - fileOffset;
+						break;
 					}
 
-//debugPrintf("Sending %" PRIu32 " bytes at offset %" PRIu32 "\n", lreq, fileOffset);
-
-					for (;;)
+					if (!LoadFirmwareChunk(fname.c_str(), fileOffset))
 					{
-						CanMessageFirmwareUpdateResponse * const msgp = buf->SetupResponseMessage<CanMessageFirmwareUpdateResponse>(0, CanInterface::GetCurrentMasterAddress(), src);
-						const size_t lengthToSend = min<size_t>(lreq, sizeof(msgp->data));
-						if (f->Read(msgp->data, lengthToSend) != (int)lengthToSend)
-						{
-							msgp->dataLength = 0;
-							msgp->err = CanMessageFirmwareUpdateResponse::ErrOther;
-							msgp->fileLength = fileLength;
-							msgp->fileOffset = 0;
-							buf->dataLength = msgp->GetActualDataLength();
-							CanInterface::SendResponseNoFree(buf);
-
-							reprap.GetPlatform().MessageF(ErrorMessage, "Error reading firmware update file '%s'\n", fname.c_str());
-							reprap.GetExpansion().UpdateFailed(src);
-							return;
-						}
-
-						msgp->dataLength = lengthToSend;
-						msgp->err = CanMessageFirmwareUpdateResponse::ErrNone;
+						msgp = buf->SetupResponseMessage<CanMessageFirmwareUpdateResponse>(0, CanInterface::GetCurrentMasterAddress(), src);
+						msgp->dataLength = 0;
+						msgp->err = CanMessageFirmwareUpdateResponse::ErrOther;
 						msgp->fileLength = fileLength;
-						msgp->fileOffset = fileOffset;
+						msgp->fileOffset = 0;
 						buf->dataLength = msgp->GetActualDataLength();
 						CanInterface::SendResponseNoFree(buf);
-						fileOffset += lengthToSend;
-						lreq -= lengthToSend;
-						if (lreq == 0)
-						{
-							break;
-						}
+
+						reprap.GetPlatform().MessageF(ErrorMessage, "Error reading firmware update file '%s'\n", fname.c_str());
+						reprap.GetExpansion().UpdateFailed(src);
+						return;
 					}
 				}
-				f->Close();
 			}
-#endif
 		}
 
 		if (lreq != 0)			// if we didn't complete the request
@@ -209,11 +209,19 @@ void ClosedLoop::ProcessReceivedData(CanAddress src, const CanMessageClosedLoopD
 				// Compile the data
 				String<StringLength256> currentLine;
 				size_t sampleIndex = msg.numSamples - numSamples;
-				//TODO use more intelligent formatting depending on the data type, to reduce the amount of data written
 				currentLine.printf("%u", msg.firstSampleNumber + sampleIndex);
 				for (size_t i = 0; i < variableCount; i++)
 				{
-					currentLine.catf(",%.2f", (double)msg.data[sampleIndex*variableCount + i]);
+					// Many of the variables are integers such as encoder counts and step phases, so write those without decimal places to reduce the amount of data written
+					const float val = msg.data[sampleIndex*variableCount + i];
+					if (fabsf(val) < 1.0e7 && (float)lrintf(val) == val)
+					{
+						currentLine.catf(",%ld", lrintf(val));
+					}
+					else
+					{
+						currentLine.catf(",%.2f", (double)val);
+					}
 				}
 				currentLine.cat("\n");
 
@@ -57,6 +57,7 @@ constexpr unsigned int MinVisibleAxes = 2;				// the minimum number of axes that
 
 // Timeouts
 constexpr uint32_t LogFlushInterval = 15000;			// Milliseconds
+constexpr uint32_t LogWriteInterval = 1000;				// Maximum time in milliseconds that event log messages wait in RAM before being written to the file
 constexpr float DefaultMessageTimeout = 10.0;			// How long a message is displayed by default, in seconds
 constexpr uint16_t MinimumGpinReportInterval = 30;		// Minimum interval in milliseconds between input change reports sent over CAN bus
 
@@ -186,28 +187,60 @@ constexpr size_t ShortGCodeLength = 64;
 constexpr size_t OUTPUT_BUFFER_SIZE = 256;				// How many bytes does each OutputBuffer hold?
 constexpr size_t OUTPUT_BUFFER_COUNT = 40;				// How many OutputBuffer instances do we have?
 constexpr size_t RESERVED_OUTPUT_BUFFERS = 4;			// Number of reserved output buffers after long responses, enough to hold a status response
+constexpr size_t LARGE_OUTPUT_BUFFER_SIZE = 1024;		// How many bytes does each large OutputBuffer hold?
+constexpr size_t LARGE_OUTPUT_BUFFER_COUNT = 8;			// How many large OutputBuffer instances do we have? These are only used to extend long chains.
 #elif SAM4E || SAM4S
 constexpr size_t OUTPUT_BUFFER_SIZE = 256;				// How many bytes does each OutputBuffer hold?
 constexpr size_t OUTPUT_BUFFER_COUNT = 26;				// How many OutputBuffer instances do we have?
 constexpr size_t RESERVED_OUTPUT_BUFFERS = 4;			// Number of reserved output buffers after long responses, enough to hold a status response
+constexpr size_t LARGE_OUTPUT_BUFFER_SIZE = 1024;		// How many bytes does each large OutputBuffer hold?
+constexpr size_t LARGE_OUTPUT_BUFFER_COUNT = 0;			// How many large OutputBuffer instances do we have? Not enough RAM for them on these processors.
 #elif __LPC17xx__
 constexpr uint16_t OUTPUT_BUFFER_SIZE = 256;            // How many bytes does each OutputBuffer hold?
 constexpr size_t OUTPUT_BUFFER_COUNT = 16;              // How many OutputBuffer instances do we have?
 constexpr size_t RESERVED_OUTPUT_BUFFERS = 2;           // Number of reserved output buffers after long responses. Must be enough for an HTTP header
+constexpr size_t LARGE_OUTPUT_BUFFER_SIZE = 1024;       // How many bytes does each large OutputBuffer hold?
+constexpr size_t LARGE_OUTPUT_BUFFER_COUNT = 0;         // How many large OutputBuffer instances do we have?
 #else
 # error
 #endif
 
-constexpr size_t maxQueuedCodes = 16;					// How many codes can be queued?
+// Largest file list we return in a single response to an HTTP request. Clients fetch the remainder using the "next" value in the response,
+// so this bounds the output buffer space that one connection can hold however large the directory is.
+constexpr size_t MaxHttpFilelistResponseBytes = (OUTPUT_BUFFER_SIZE * (OUTPUT_BUFFER_COUNT - RESERVED_OUTPUT_BUFFERS) + LARGE_OUTPUT_BUFFER_SIZE * LARGE_OUTPUT_BUFFER_COUNT)/4;
+
+// How long in seconds we let browsers cache web files whose names include a content hash, such as the DWC JavaScript and CSS bundles
+#ifndef HTTP_IMMUTABLE_ASSET_MAX_AGE
+# define HTTP_IMMUTABLE_ASSET_MAX_AGE	(30 * 24 * 3600)
+#endif
+constexpr uint32_t HttpImmutableAssetMaxAge = HTTP_IMMUTABLE_ASSET_MAX_AGE;
+
+#ifndef MAX_QUEUED_CODES
+# if SAME70 || SAME5x
+#  define MAX_QUEUED_CODES		32
+# else
+#  define MAX_QUEUED_CODES		16
+# endif
+#endif
+constexpr size_t maxQueuedCodes = MAX_QUEUED_CODES;		// How many codes can be queued? Each one needs about ShortGCodeLength bytes of RAM.
 
 // These two definitions are only used if TRACK_OBJECT_NAMES is defined, however that definition isn't available in this file
+// The object directory is allocated from the heap in blocks of ObjectDirectoryBlockSize entries as build plate objects are found, so unused entries cost no RAM.
 #if SAME70 || SAME5x
-constexpr size_t MaxTrackedObjects = 40;				// How many build plate objects we track. Each one needs 16 bytes of storage, in addition to the string space.
+constexpr size_t MaxTrackedObjects = 256;				// How many build plate objects we track. Each one needs 12 bytes of heap once used, in addition to the string space.
 constexpr size_t ObjectNamesStringSpace = 1000;			// How much space we reserve for the names of objects on the build plate
 #else
-constexpr size_t MaxTrackedObjects = 20;				// How many build plate objects we track. Each one needs 16 bytes of storage, in addition to the string space.
+constexpr size_t MaxTrackedObjects = 64;				// How many build plate objects we track. Each one needs 12 bytes of heap once used, in addition to the string space.
 constexpr size_t ObjectNamesStringSpace = 500;			// How much space we reserve for the names of objects on the build plate
 #endif
+constexpr size_t ObjectDirectoryBlockSize = 16;			// How many object directory entries we allocate at a time
+
+// Size of the RAM buffer that event log messages are queued in until Platform::Spin writes them to the log file
+#if SAME70 || SAME5x
+constexpr size_t LogBufferSize = 4096;
+#else
+constexpr size_t LogBufferSize = 1024;
+#endif
 
 // How many filaments we can return in the file information. Each one uses 4 bytes of statically-allocated RAM.
 #if SAME70 || SAME5x
@@ -225,7 +258,7 @@ constexpr float DefaultRetractLength = 2.0;
 
 constexpr float MaxArcDeviation = 0.005;				// maximum deviation from ideal arc due to segmentation
 constexpr float MinArcSegmentLength = 0.1;				// G2 and G3 arc movement commands get split into segments at least this long
-constexpr float MaxArcSegmentLength = 1.0;				// G2 and G3 arc movement commands get split into segments at most this long
+constexpr float MaxArcSegmentLength = 4.0;				// G2 and G3 arc movement commands get split into segments at most this long, subject to MaxArcDeviation
 constexpr float MinArcSegmentsPerSec = 200.0;
 constexpr float SegmentsPerFulArcCalculation = 8.0;		// we do the full sine/cosine calculation every this number of segments
 
@@ -42,9 +42,11 @@ void Lcd::Init(Pin p_csPin, Pin p_a0Pin, bool csPolarity, uint32_t freq, uint8_t
 
 	numContinuationBytesLeft = 0;
 	textInverted = false;
-	startRow = numRows;
-	startCol = numCols;
-	endRow = endCol = nextFlushRow = 0;
+	nextFlushRow = 0;
+	memset(image, 0, imageSize);
+	startRow = startCol = 0;						// the display contents are unknown, so flag the whole image as dirty
+	endRow = numRows;
+	endCol = numCols;
 
 	HardwareInit();
 	currentFontNumber = 0;
@@ -74,7 +76,7 @@ PixelNumber Lcd::GetFontHeight(size_t fontNumber) const noexcept
 	return fonts[fontNumber]->height;
 }
 
-// Flag a rectangle as dirty. Inline because it is called from only two places.
+// Flag a rectangle as dirty. Inline because it is called from only a few places.
 inline void Lcd::SetRectDirty(PixelNumber top, PixelNumber left, PixelNumber bottom, PixelNumber right) noexcept
 {
 	if (top < startRow) startRow = top;
@@ -388,6 +390,13 @@ void Lcd::TextInvert(bool b) noexcept
 	}
 }
 
+// Clear the whole display. Always flag it as dirty, because this is used to get the display back in step with the image.
+void Lcd::Clear() noexcept
+{
+	Clear(0, 0, numRows, numCols);
+	SetRectDirty(0, 0, numRows, numCols);
+}
+
 // Clear a rectangular block of pixels starting at rows, scol ending just before erow, ecol
 void Lcd::Clear(PixelNumber sRow, PixelNumber sCol, PixelNumber eRow, PixelNumber eCol) noexcept
 {
@@ -401,29 +410,36 @@ void Lcd::Clear(PixelNumber sRow, PixelNumber sCol, PixelNumber eRow, PixelNumbe
 		{
 			sMask |= eMask;							// special case of just clearing some middle bits
 		}
+		uint8_t changedBits = 0;					// nonzero if we cleared any pixels that were set
 		for (PixelNumber r = sRow; r < eRow; ++r)
 		{
 			uint8_t * p = image + ((r * (numCols/8)) + (sCol/8));
 			uint8_t * const endp = image + ((r * (numCols/8)) + (eCol/8));
+			changedBits |= *p & ~sMask;
 			*p &= sMask;
 			if (p != endp)
 			{
 				while (++p < endp)
 				{
+					changedBits |= *p;
 					*p = 0;
 				}
 				if ((eCol & 7) != 0)
 				{
+					changedBits |= *p & ~eMask;
 					*p &= eMask;
 				}
 			}
 		}
 
-		// Flag cleared part as dirty
-		if (sCol < startCol) { startCol = sCol; }
-		if (eCol >= endCol) { endCol = eCol; }
-		if (sRow < startRow) { startRow = sRow; }
-		if (eRow >= endRow) { endRow = eRow; }
+		// Flag cleared part as dirty, but only if it has changed, so that we don't send unchanged data to the display
+		if (changedBits != 0)
+		{
+			if (sCol < startCol) { startCol = sCol; }
+			if (eCol >= endCol) { endCol = eCol; }
+			if (sRow < startRow) { startRow = sRow; }
+			if (eRow >= endRow) { endRow = eRow; }
+		}
 
 		SetCursor(sRow, sCol);
 		textInverted = false;
@@ -73,10 +73,7 @@ public:
 	void Clear(PixelNumber top, PixelNumber left, PixelNumber bottom, PixelNumber right) noexcept;
 
 	// Clear the whole display and select non-inverted text.
-	void Clear() noexcept
-	{
-		Clear(0, 0, numRows, numCols);
-	}
+	void Clear() noexcept;
 
 	// Set the cursor position
 	//  r = row, the number of pixels from the top of the display to the top of the character.
@@ -23,7 +23,7 @@ LocalFan::LocalFan(unsigned int fanNum) noexcept
 	: Fan(fanNum),
 	  lastPwm(-1.0),									// force a refresh
 	  lastVal(-1.0),
-	  fanInterruptCount(0), fanLastResetTime(0), fanInterval(0),
+	  fanInterruptCount(0), fanLastResetTime(0), fanLastEdgeTime(0), fanInterval(0),
 	  blipping(false)
 {
 }
@@ -197,23 +197,51 @@ int32_t LocalFan::GetRPM() const noexcept
 	// The ISR sets fanInterval to the number of step interrupt clocks it took to get fanMaxInterruptCount interrupts.
 	// We get 2 tacho pulses per revolution, hence 2 interrupts per revolution.
 	// When the fan stops, we get no interrupts and fanInterval stops getting updated. We must recognise this and return zero.
-	return (!tachoPort.IsValid())
-			? -1																			// we return -1 if there is no tacho configured
-			: (fanInterval != 0 && StepTimer::GetTimerTicks() - fanLastResetTime < 3 * StepClockRate)	// if we have a reading and it is less than 3 seconds old
-			  ? (StepClockRate * fanMaxInterruptCount * (60/2))/fanInterval					// then calculate RPM assuming 2 interrupts per rev
-			  : 0;																			// else assume fan is off or tacho not connected
+	if (!tachoPort.IsValid())
+	{
+		return -1;																			// we return -1 if there is no tacho configured
+	}
+
+	const uint32_t now = StepTimer::GetTimerTicks();
+	if (now - fanLastResetTime < 3 * StepClockRate)
+	{
+		return (fanInterval != 0)
+				? (StepClockRate * fanMaxInterruptCount * (60/2))/fanInterval				// calculate RPM assuming 2 interrupts per rev
+				: 0;
+	}
+
+	// We haven't had fanMaxInterruptCount interrupts in the last 3 seconds, so the fan is stopped or turning slowly.
+	// The ISR restarts the count at the first edge after a gap of fanEdgeTimeout, so the edges counted since the last reset span whole tacho periods.
+	// If the last edge was recent enough, estimate the speed from those edges. This allows us to read speeds down to (1/3) * (60/2) = 10rpm.
+	uint32_t count, lastResetTime, lastEdgeTime;
+	{
+		AtomicCriticalSectionLocker lock;
+		count = fanInterruptCount;
+		lastResetTime = fanLastResetTime;
+		lastEdgeTime = fanLastEdgeTime;
+	}
+	return (count != 0 && now - lastEdgeTime < fanEdgeTimeout)
+			? (int32_t)(((uint64_t)StepClockRate * count * (60/2))/(lastEdgeTime - lastResetTime))
+			: 0;																			// else assume fan is off or tacho not connected
 }
 
 void LocalFan::Interrupt() noexcept
 {
-	++fanInterruptCount;
-	if (fanInterruptCount == fanMaxInterruptCount)
+	const uint32_t now = StepTimer::GetTimerTicks();
+	if (now - fanLastEdgeTime >= fanEdgeTimeout)
+	{
+		// The fan was stopped or turning very slowly, so start counting again from this edge
+		fanInterval = 0;
+		fanInterruptCount = 0;
+		fanLastResetTime = now;
+	}
+	else if (++fanInterruptCount == fanMaxInterruptCount)
 	{
-		const uint32_t now = StepTimer::GetTimerTicks();
 		fanInterval = now - fanLastResetTime;
 		fanLastResetTime = now;
 		fanInterruptCount = 0;
 	}
+	fanLastEdgeTime = now;
 }
 
 // End
@@ -182,7 +182,7 @@ bool PulsedFilamentMonitor::Interrupt() noexcept
 	const uint32_t now = millis();
 	if (now - lastMeasurementTime >= 50)
 	{
-		lastMeasurementTime = millis();
+		lastMeasurementTime = now;
 		return true;
 	}
 	return false;
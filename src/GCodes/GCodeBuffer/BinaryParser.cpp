@@ -34,6 +34,20 @@ void BinaryParser::Put(const uint32_t *data, size_t len) noexcept
 {
 	memcpyu32(reinterpret_cast<uint32_t *>(gb.buffer), data, len);
 	bufferLength = len * sizeof(uint32_t);
+
+	// Record which parameter letters are present, so that Seen() can reject absent letters without searching the parameter list.
+	// Commands such as G1 look for many letters that are usually absent (all the axes, E, F, H, R, S...), which makes this worthwhile.
+	parametersPresent.Clear();
+	const CodeParameter *param = reinterpret_cast<const CodeParameter*>(reinterpret_cast<const char*>(gb.buffer) + sizeof(CodeHeader));
+	for (size_t i = 0; i < header->numParameters; i++)
+	{
+		if (param->letter >= 'A' && param->letter <= 'Z')
+		{
+			parametersPresent.SetBit(param->letter - 'A');
+		}
+		++param;
+	}
+
 	gb.bufferState = GCodeBufferState::parsingGCode;
 	gb.LatestMachineState().g53Active = (header->flags & CodeFlags::EnforceAbsolutePosition) != 0;
 	gb.CurrentFileMachineState().lineNumber = header->lineNumber;
@@ -55,6 +69,12 @@ void BinaryParser::DecodeCommand() noexcept
 
 bool BinaryParser::Seen(char c) noexcept
 {
+	if (c >= 'A' && c <= 'Z' && !parametersPresent.IsBitSet(c - 'A'))
+	{
+		seenParameter = nullptr;
+		return false;
+	}
+
 	if (bufferLength != 0 && header->numParameters != 0)
 	{
 		const char *parameterStart = reinterpret_cast<const char*>(gb.buffer) + sizeof(CodeHeader);
@@ -93,16 +113,7 @@ bool BinaryParser::SeenAny(Bitmap<uint32_t> bm) const noexcept
 {
 	if (bufferLength != 0 && header->numParameters != 0)
 	{
-		const char *parameterStart = reinterpret_cast<const char*>(gb.buffer) + sizeof(CodeHeader);
-		for (size_t i = 0; i < header->numParameters; i++)
-		{
-			const CodeParameter *param = reinterpret_cast<const CodeParameter*>(parameterStart + i * sizeof(CodeParameter));
-			const char paramLetter = param->letter;
-			if (paramLetter >= 'A' && paramLetter <= 'Z' && bm.IsBitSet(paramLetter - 'A'))
-			{
-				return true;
-			}
-		}
+		return parametersPresent.Intersects(bm);
 	}
 	return false;
 }
@@ -78,6 +78,7 @@ private:
 
 	size_t bufferLength;
 	const CodeHeader *header;
+	Bitmap<uint32_t> parametersPresent;					// which parameters A-Z are present in this command
 
 	int reducedBytesRead;
 	const CodeParameter *seenParameter;
@@ -514,7 +514,14 @@ void ExpressionParser::ParseInternal(ExpressionValue& val, bool evaluate, uint8_
 					break;
 
 				case '^':
-					StringConcat(val, val2);
+					if (evaluate)
+					{
+						StringConcat(val, val2);
+					}
+					else
+					{
+						val.SetCString("");								// don't allocate heap strings for results that will be discarded
+					}
 					break;
 				}
 			}
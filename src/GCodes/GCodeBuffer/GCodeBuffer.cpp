@@ -101,7 +101,7 @@ GCodeBuffer::GCodeBuffer(GCodeChannel::RawType channel, GCodeInput *normalIn, Fi
 #if HAS_SBC_INTERFACE
 	  isBinaryBuffer(false),
 #endif
-	  timerRunning(false), motionCommanded(false)
+	  timerRunning(false), motionCommanded(false), queueFullCounted(false)
 #if HAS_SBC_INTERFACE
 	  , isWaitingForMacro(false), invalidated(false)
 #endif
@@ -142,6 +142,7 @@ void GCodeBuffer::Init() noexcept
 #endif
 	stringParser.Init();
 	timerRunning = false;
+	queueFullCounted = false;
 }
 
 void GCodeBuffer::StartTimer() noexcept
@@ -242,6 +243,16 @@ bool GCodeBuffer::Put(char c) noexcept
 	return stringParser.Put(c);
 }
 
+// Add a block of characters, stopping at the end of a line. Return true if a line is complete.
+bool GCodeBuffer::PutLine(const char *_ecv_array data, size_t len, size_t& bytesUsed) noexcept
+{
+#if HAS_SBC_INTERFACE
+	machineState->lastCodeFromSbc = false;
+	isBinaryBuffer = false;
+#endif
+	return stringParser.PutLine(data, len, bytesUsed);
+}
+
 // Decode the command in the buffer when it is complete
 void GCodeBuffer::DecodeCommand() noexcept
 {
@@ -744,6 +755,7 @@ void GCodeBuffer::SetFinished(bool f) noexcept
 		sendToSbc = false;
 #endif
 		LatestMachineState().firstCommandAfterRestart = false;
+		queueFullCounted = false;
 		PARSER_OPERATION(SetFinished());
 	}
 	else
@@ -1093,8 +1105,11 @@ void GCodeBuffer::FinishWritingBinary() noexcept
 void GCodeBuffer::RestartFrom(FilePosition pos) noexcept
 {
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
-	fileInput->Reset(machineState->fileState);		// clear the buffered data
-	machineState->fileState.Seek(pos);				// replay the abandoned instructions when we resume
+	if (!fileInput->RewindTo(machineState->fileState, pos))	// if the data is still in the input buffer then we don't need to read it again
+	{
+		fileInput->Reset(machineState->fileState);		// clear the buffered data
+		machineState->fileState.Seek(pos);				// replay the abandoned instructions when we resume
+	}
 #endif
 	Init();											// clear the next move
 }
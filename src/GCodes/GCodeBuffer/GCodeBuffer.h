@@ -50,6 +50,7 @@ public:
 	void Diagnostics(MessageType mtype) noexcept;								// Write some debug info
 
 	bool Put(char c) noexcept SPEED_CRITICAL;									// Add a character to the end
+	bool PutLine(const char *_ecv_array data, size_t len, size_t& bytesUsed) noexcept SPEED_CRITICAL;	// Add characters until a line is complete
 #if HAS_SBC_INTERFACE
 	void PutBinary(const uint32_t *data, size_t len) noexcept;					// Add an entire binary G-Code, overwriting any existing content
 #endif
@@ -238,6 +239,9 @@ public:
 	void MotionStopped() noexcept { motionCommanded = false; }
 	bool WasMotionCommanded() const noexcept { return motionCommanded; }
 
+	void SetQueueFullCounted() noexcept { queueFullCounted = true; }
+	bool WasQueueFullCounted() const noexcept { return queueFullCounted; }
+
 	void AddParameters(VariableSet& vars, int codeRunning) noexcept;
 	VariableSet& GetVariables() const noexcept;
 
@@ -294,6 +298,7 @@ private:
 #endif
 	bool timerRunning;									// True if we are waiting
 	bool motionCommanded;								// true if this GCode stream has commanded motion since it last waited for motion to stop
+	bool queueFullCounted;								// true if we have counted that the code queue was full when we tried to queue the current command
 
 	alignas(4) char buffer[MaxGCodeLength];				// must be aligned because in SBC binary mode we do dword fetches from it
 
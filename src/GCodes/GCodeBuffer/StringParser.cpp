@@ -37,7 +37,7 @@ void StringParser::Init() noexcept
 	gcodeLineEnd = 0;
 	commandStart = commandLength = 0;								// set both to zero so that calls to GetFilePosition don't return negative values
 	readPointer = -1;
-	hadLineNumber = hadChecksum = overflowed = seenExpression = false;
+	hadLineNumber = hadChecksum = overflowed = seenExpression = parameterIndexValid = false;
 	computedChecksum = 0;
 	gb.bufferState = GCodeBufferState::parseNotStarted;
 	commandIndent = 0;
@@ -279,6 +279,87 @@ bool StringParser::Put(char c) noexcept
 	return false;
 }
 
+// Return true if a character needs the full state machine in Put when we are in the parsingGCode state
+static inline bool IsSpecialGCodeChar(char c) noexcept
+{
+	switch (c)
+	{
+	case 0:
+	case '\n':
+	case '\r':
+	case 0x7F:
+	case '*':
+	case ';':
+	case '(':
+	case '"':
+	case '{':
+	case '}':
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+// Add a block of characters, stopping when a line is complete. Set bytesUsed to the number of characters consumed and return true if a line is complete.
+// This is equivalent to calling Put for each character, but runs of ordinary G-code characters and the remainder of a discarded line
+// are handled without going through the state machine one character at a time.
+bool StringParser::PutLine(const char *_ecv_array data, size_t len, size_t& bytesUsed) noexcept
+{
+	size_t i = 0;
+	while (i < len)
+	{
+		if (gb.bufferState == GCodeBufferState::parsingGCode && !hadLineNumber)
+		{
+			// We don't need to compute a checksum, so copy ordinary characters straight into the buffer
+			const size_t start = i;
+			while (i < len && !IsSpecialGCodeChar(data[i]))
+			{
+				++i;
+			}
+			size_t numChars = i - start;
+			if (numChars != 0)
+			{
+				commandLength += numChars;
+				const size_t spaceLeft = ARRAY_SIZE(gb.buffer) - 1 - gcodeLineEnd;		// leave space for a trailing null
+				if (numChars > spaceLeft)
+				{
+					overflowed = true;
+					numChars = spaceLeft;
+				}
+				memcpy(gb.buffer + gcodeLineEnd, data + start, numChars);
+				gcodeLineEnd += numChars;
+				if (i == len)
+				{
+					break;
+				}
+			}
+		}
+		else if (gb.bufferState == GCodeBufferState::discarding)
+		{
+			// Skip to the end of the line
+			while (i < len && data[i] != 0 && data[i] != '\n' && data[i] != '\r')
+			{
+				++i;
+				++commandLength;
+			}
+			if (i == len)
+			{
+				break;
+			}
+		}
+
+		if (Put(data[i++]))
+		{
+			bytesUsed = i;
+			return true;
+		}
+	}
+
+	bytesUsed = len;
+	return false;
+}
+
 // This is called when we are fed a null, CR or LF character.
 // Return true if there is a completed command ready to be executed.
 bool StringParser::LineFinished() noexcept
@@ -881,6 +962,7 @@ bool StringParser::EvaluateCondition() THROWS(GCodeException)
 // On return, the state must be set to 'ready' to indicate that a command is available and we should stop adding characters.
 void StringParser::DecodeCommand() noexcept
 {
+	parameterIndexValid = false;					// FindParameters will set this if it is called
 	// Check for a valid command letter at the start
 	char cl = gb.buffer[commandStart];
 	if (cl == '\'')									// check for a lowercase axis letter in Fanuc mode
@@ -988,11 +1070,14 @@ void StringParser::DecodeCommand() noexcept
 
 // Find where the end of the command is. We assume that a G or M not inside quotes or { } and not preceded by ' is the start of a new command.
 // This isn't true if the command has an unquoted string argument, but we deal with that later.
+// While we are scanning the command we also record where the first occurrence of each uppercase parameter letter is, so that Seen doesn't need to search for it.
 void StringParser::FindParameters() noexcept
 {
 	bool inQuotes = false;
+	bool escaped = false;
 	unsigned int localBraceCount = 0;
 	parametersPresent.Clear();
+	parametersIndexed.Clear();
 	for (commandEnd = parameterStart; commandEnd < gcodeLineEnd; ++commandEnd)
 	{
 		const char c = gb.buffer[commandEnd];
@@ -1022,11 +1107,19 @@ void StringParser::FindParameters() noexcept
 				}
 				if (c2 >= 'A' && c2 <= 'Z' && (c2 != 'E' || commandEnd == parameterStart || !isdigit(gb.buffer[commandEnd - 1])))
 				{
-					parametersPresent.SetBit(c2 - 'A');
+					const unsigned int bit = c2 - 'A';
+					parametersPresent.SetBit(bit);
+					if (!escaped && !parametersIndexed.IsBitSet(bit))
+					{
+						parametersIndexed.SetBit(bit);
+						parameterOffsets[bit] = (uint16_t)commandEnd;
+					}
 				}
 			}
+			escaped = (c == '\'' && !escaped);			// this must track escapes in the same way as Seen does
 		}
 	}
+	parameterIndexValid = true;
 }
 
 // Add an entire string, overwriting any existing content and adding '\n' at the end if necessary to make it a complete line
@@ -1127,6 +1220,17 @@ bool StringParser::Seen(char c) noexcept
 	{
 		return false;
 	}
+	else if (parameterIndexValid)
+	{
+		// FindParameters has already recorded where this parameter is
+		if (parametersIndexed.IsBitSet(c - 'A'))
+		{
+			readPointer = parameterOffsets[c - 'A'] + 1;
+			return true;
+		}
+		readPointer = -1;
+		return false;
+	}
 
 	bool inQuotes = false;
 	bool escaped = false;
@@ -1441,6 +1545,7 @@ void StringParser::InternalGetPossiblyQuotedString(const StringRef& str) THROWS(
 	else
 	{
 		commandEnd = gcodeLineEnd;				// the string is the remainder of the line of gcode
+		parameterIndexValid = false;			// the index only covers the original extent of the command
 		for (;;)
 		{
 			const char c = gb.buffer[readPointer++];
@@ -1798,6 +1903,60 @@ void StringParser::CheckNumberFound(const char *endptr) THROWS(GCodeException)
 	readPointer = endptr - gb.buffer;
 }
 
+// Fast conversion of a plain decimal number such as 123.456 to float. Return true and set 'result' and 'endptr' if successful, else return false.
+// We only handle numbers with no exponent whose digits fit in the 24-bit float mantissa and with no more than 10 digits after the decimal point.
+// The integer mantissa and the power of 10 are then both exactly representable, so the result of the single division is correctly rounded.
+static bool FastStrtof(const char *_ecv_array p, const char *_ecv_array *endptr, float& result) noexcept
+{
+	static constexpr float PowersOfTen[] = { 1.0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9, 1.0e10 };
+
+	const bool negative = (*p == '-');
+	if (negative || *p == '+')
+	{
+		++p;
+	}
+
+	uint32_t mantissa = 0;
+	unsigned int numDigits = 0, digitsAfterPoint = 0;
+	bool seenPoint = false;
+	for (;;)
+	{
+		const char c = *p;
+		if (isdigit(c))
+		{
+			mantissa = (10 * mantissa) + (c - '0');
+			if (mantissa > (1u << 24))
+			{
+				return false;									// too many significant digits
+			}
+			++numDigits;
+			if (seenPoint)
+			{
+				++digitsAfterPoint;
+			}
+		}
+		else if (c == '.' && !seenPoint)
+		{
+			seenPoint = true;
+		}
+		else
+		{
+			break;
+		}
+		++p;
+	}
+
+	if (numDigits == 0 || digitsAfterPoint >= ARRAY_SIZE(PowersOfTen) || *p == 'e' || *p == 'E')
+	{
+		return false;
+	}
+
+	const float val = (float)mantissa/PowersOfTen[digitsAfterPoint];
+	result = (negative) ? -val : val;
+	*endptr = p;
+	return true;
+}
+
 // Functions to read values from lines of GCode, allowing for expressions and variable substitution
 float StringParser::ReadFloatValue() THROWS(GCodeException)
 {
@@ -1810,7 +1969,14 @@ float StringParser::ReadFloatValue() THROWS(GCodeException)
 	}
 
 	const char *endptr;
-	const float rslt = SafeStrtof(gb.buffer + readPointer, &endptr);
+	float rslt;
+	if (FastStrtof(gb.buffer + readPointer, &endptr, rslt))
+	{
+		readPointer = endptr - gb.buffer;
+		return rslt;
+	}
+
+	rslt = SafeStrtof(gb.buffer + readPointer, &endptr);
 	CheckNumberFound(endptr);
 	return rslt;
 }
@@ -28,6 +28,7 @@ public:
 	void Init() noexcept; 													// Set it up to parse another G-code
 	void Diagnostics(MessageType mtype) noexcept;							// Write some debug info
 	bool Put(char c) noexcept SPEED_CRITICAL;				// Add a character to the end
+	bool PutLine(const char *_ecv_array data, size_t len, size_t& bytesUsed) noexcept SPEED_CRITICAL;	// Add characters until a line is complete or we run out of data
 	void PutCommand(const char *str) noexcept;								// Put a complete command but don't decode it
 	void DecodeCommand() noexcept;											// Decode the next command in the line
 	void PutAndDecode(const char *str, size_t len) noexcept;				// Add an entire string, overwriting any existing content
@@ -133,6 +134,8 @@ private:
 	unsigned int braceCount;							// how many nested { } we are inside
 	unsigned int gcodeLineEnd;							// Number of characters in the entire line of gcode
 	Bitmap<uint32_t> parametersPresent;					// which parameters are present in this command
+	Bitmap<uint32_t> parametersIndexed;					// which uppercase parameters have an entry in parameterOffsets
+	uint16_t parameterOffsets[26];						// index in the buffer of the first occurrence of each uppercase parameter letter, valid if the corresponding bit in parametersIndexed is set
 	int readPointer;									// Where in the buffer to read next, or -1
 
 	FileStore *fileBeingWritten;						// If we are copying GCodes to a file, which file it is
@@ -164,6 +167,7 @@ private:
 	bool warnedAboutMixedSpacesAndTabs;
 	bool overflowed;
 	bool seenExpression;
+	bool parameterIndexValid;							// true if FindParameters has built parametersIndexed and parameterOffsets for the current command
 
 	bool checksumRequired;								// True if we only accept commands with a valid checksum
 	bool crcRequired;									// True if we only accept commands with a valid CRC, except for M409 commands
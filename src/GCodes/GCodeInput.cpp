@@ -13,6 +13,7 @@
 
 const size_t GCodeInputFileReadThreshold = 128;		// How many free bytes must be available before data is read from the file
 const size_t GCodeInputUSBReadThreshold = 128;		// How many free bytes must be available before we read more data from USB
+const size_t FileReadSectorSize = 512;				// The sector size of the file system, used to align reads from file
 
 // Read some input bytes into the GCode buffer. Return true if there is a line of GCode waiting to be processed.
 // This needs to be efficient
@@ -80,8 +81,8 @@ size_t StreamGCodeInput::BytesCached() const noexcept
 
 // Dynamic G-code input class for caching codes from software-defined sources
 
-RegularGCodeInput::RegularGCodeInput() noexcept
-	: state(GCodeInputState::idle), writingPointer(0), readingPointer(0)
+RegularGCodeInput::RegularGCodeInput(char *_ecv_array buf, size_t size) noexcept
+	: state(GCodeInputState::idle), writingPointer(0), readingPointer(0), buffer(buf), bufferSize(size)
 {
 }
 
@@ -94,21 +95,57 @@ void RegularGCodeInput::Reset() noexcept
 char RegularGCodeInput::ReadByte() noexcept
 {
 	char c = buffer[readingPointer++];
-	if (readingPointer == GCodeInputBufferSize)
+	if (readingPointer == bufferSize)
 	{
 		readingPointer = 0;
 	}
 	return c;
 }
 
+// Pass the cached data to the GCode buffer in contiguous blocks, so that most characters don't need a separate call to the parser.
+// Return true if there is a line of GCode waiting to be processed.
+bool RegularGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept
+{
+#if HAS_MASS_STORAGE
+	if (gb->IsWritingBinary())
+	{
+		return StandardGCodeInput::FillBuffer(gb);
+	}
+#endif
+
+	const size_t endPointer = writingPointer;
+	while (readingPointer != endPointer)
+	{
+		const size_t bytesAvailable = ((endPointer > readingPointer) ? endPointer : bufferSize) - readingPointer;
+		size_t bytesUsed;
+		const bool lineComplete = gb->PutLine(buffer + readingPointer, bytesAvailable, bytesUsed);
+		readingPointer = (readingPointer + bytesUsed) & (bufferSize - 1);
+		if (lineComplete)
+		{
+#if HAS_MASS_STORAGE
+			if (gb->IsWritingFile())
+			{
+				gb->WriteToFile();
+			}
+			else
+#endif
+			{
+				return true;			// a line of GCode is complete, so stop here
+			}
+		}
+	}
+
+	return false;
+}
+
 size_t RegularGCodeInput::BytesCached() const noexcept
 {
-	return (writingPointer - readingPointer) % GCodeInputBufferSize;
+	return (writingPointer - readingPointer) & (bufferSize - 1);
 }
 
 size_t RegularGCodeInput::BufferSpaceLeft() const noexcept
 {
-	return (readingPointer - writingPointer - 1u) % GCodeInputBufferSize;
+	return (readingPointer - writingPointer - 1u) & (bufferSize - 1);
 }
 
 // BufferedStreamGCodeInput methods
@@ -126,10 +163,10 @@ bool BufferedStreamGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept
 	const size_t spaceLeft = BufferSpaceLeft();
 	if (spaceLeft >= GCodeInputUSBReadThreshold)
 	{
-		const size_t maxToTransfer = (readingPointer > writingPointer) ? spaceLeft : GCodeInputBufferSize - writingPointer;
-		writingPointer = (writingPointer + device.readBytes(buffer + writingPointer, maxToTransfer)) % GCodeInputBufferSize;
+		const size_t maxToTransfer = (readingPointer > writingPointer) ? spaceLeft : bufferSize - writingPointer;
+		writingPointer = (writingPointer + device.readBytes(buffer + writingPointer, maxToTransfer)) & (bufferSize - 1);
 	}
-	return StandardGCodeInput::FillBuffer(gb);
+	return RegularGCodeInput::FillBuffer(gb);
 }
 
 // NetworkGCodeInput methods
@@ -211,7 +248,7 @@ void NetworkGCodeInput::Put(MessageType mtype, char c) noexcept
 
 	// Feed another character into the buffer
 	buffer[writingPointer++] = c;
-	if (writingPointer == GCodeInputBufferSize)
+	if (writingPointer == bufferSize)
 	{
 		writingPointer = 0;
 	}
@@ -236,7 +273,7 @@ bool NetworkGCodeInput::Put(MessageType mtype, const char *buf) noexcept
 	return false;
 }
 
-NetworkGCodeInput::NetworkGCodeInput() noexcept : RegularGCodeInput()
+NetworkGCodeInput::NetworkGCodeInput() noexcept : RegularGCodeInput(storage, GCodeInputBufferSize)
 {
 	bufMutex.Create("NetworkGCodeInput");
 }
@@ -257,6 +294,7 @@ void FileGCodeInput::Reset() noexcept
 {
 	lastFileRead.Close();
 	RegularGCodeInput::Reset();
+	ClearHistory();
 }
 
 // Reset this input. Should be called when a specific G-code or macro file is closed outside of the reading context
@@ -268,6 +306,19 @@ void FileGCodeInput::Reset(const FileData &file) noexcept
 	}
 }
 
+// Go back to an earlier position in the file, for example to start another iteration of a 'while' loop.
+// If the data from that position onwards is still in the buffer then we reuse it instead of seeking and reading the file again, and return true.
+// Otherwise return false without changing anything, in which case the caller must reset this input and seek the file.
+bool FileGCodeInput::RewindTo(const FileData &file, FilePosition pos) noexcept
+{
+	if (lastFileRead == file && file.IsLive() && file.GetPosition() == validDataEndPosition && pos <= validDataEndPosition && validDataEndPosition - pos <= validBytes)
+	{
+		readingPointer = (writingPointer + bufferSize - (size_t)(validDataEndPosition - pos)) & (bufferSize - 1);
+		return true;
+	}
+	return false;
+}
+
 // Read another chunk of G-codes from the file and return true if more data is available
 GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 {
@@ -284,29 +335,37 @@ GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 		}
 
 		RegularGCodeInput::Reset();
+		ClearHistory();
 	}
 	lastFileRead.CopyFrom(file);
 
-	// Read more from the file
-	if (bytesCached < GCodeInputFileReadThreshold)
+	// Read more from the file. With a large buffer we top it up whenever there is room for a whole sector, so that we have plenty of data in hand if the card is slow.
+	if (bytesCached < GCodeInputFileReadThreshold || (bufferSize > GCodeInputBufferSize && BufferSpaceLeft() >= FileReadSectorSize))
 	{
 		// Reset the read+write pointers for better performance if possible
 		if (readingPointer == writingPointer)
 		{
 			readingPointer = writingPointer = 0;
+			ClearHistory();
 		}
 
-		// The code here used to read into a local buffer in blocks that are multiples of 4 bytes.
-		// However, unless we can use a buffer of at least 512 bytes then that is redundant,
-		// because the data will be copied via the sector buffer in FatFS anyway. So we don't do that any more.
-		const int bytesRead = file.Read(buffer + writingPointer, min<size_t>(BufferSpaceLeft(), GCodeInputBufferSize - writingPointer));
+		// If we can read at least a whole sector, end the read on a sector boundary of the file.
+		// Then subsequent reads of whole sectors are transferred by FatFS directly into our buffer instead of via its sector buffer.
+		size_t bytesToRead = min<size_t>(BufferSpaceLeft(), bufferSize - writingPointer);
+		if (bytesToRead >= FileReadSectorSize)
+		{
+			bytesToRead -= (size_t)((file.GetPosition() + bytesToRead) % FileReadSectorSize);
+		}
+		const int bytesRead = file.Read(buffer + writingPointer, bytesToRead);
 		if (bytesRead < 0)
 		{
 			return GCodeInputReadResult::error;
 		}
 		if (bytesRead > 0)
 		{
-			writingPointer = (writingPointer + (size_t)bytesRead) % GCodeInputBufferSize;
+			writingPointer = (writingPointer + (size_t)bytesRead) & (bufferSize - 1);
+			validBytes = min<size_t>(validBytes + (size_t)bytesRead, bufferSize - 1);
+			validDataEndPosition = file.GetPosition();
 			return GCodeInputReadResult::haveData;
 		}
 	}
@@ -14,7 +14,13 @@
 
 #include <Stream.h>
 
-const size_t GCodeInputBufferSize = 256;						// How many bytes can we cache per input source? Make this a power of 2 for efficiency
+const size_t GCodeInputBufferSize = 256;						// How many bytes can we cache per input source? Must be a power of 2
+
+#if SAME70 || SAME5x
+const size_t FileGCodeInputBufferSize = 2048;					// How many bytes we cache from the file being printed. Must be a power of 2.
+#else
+const size_t FileGCodeInputBufferSize = GCodeInputBufferSize;
+#endif
 
 // This base class provides incoming G-codes for the GCodeBuffer class
 class GCodeInput
@@ -72,31 +78,34 @@ enum class GCodeInputState
 class RegularGCodeInput : public StandardGCodeInput
 {
 public:
-	RegularGCodeInput() noexcept;
-
 	void Reset() noexcept override;
+	bool FillBuffer(GCodeBuffer *gb) noexcept override;			// Fill a GCodeBuffer with the last available G-code
 	size_t BytesCached() const noexcept override;				// How many bytes have been cached?
 	size_t BufferSpaceLeft() const noexcept;					// How much space do we have left?
 
 protected:
+	RegularGCodeInput(char *_ecv_array buf, size_t size) noexcept;		// the derived class provides the buffer, whose size must be a power of 2
+
 	char ReadByte() noexcept override;
 
 	GCodeInputState state;
 	size_t writingPointer, readingPointer;
-	char buffer[GCodeInputBufferSize];
+	char *_ecv_array const buffer;
+	const size_t bufferSize;
 };
 
 // Class to buffer input from streams that have very slow single-character interfaces, in particular the Microchip SAM4E/4S/E70 USB driver
 class BufferedStreamGCodeInput : public RegularGCodeInput
 {
 public:
-	BufferedStreamGCodeInput(Stream &dev) noexcept : RegularGCodeInput(), device(dev) { }
+	BufferedStreamGCodeInput(Stream &dev) noexcept : RegularGCodeInput(storage, GCodeInputBufferSize), device(dev) { }
 
 	void Reset() noexcept override;
 	bool FillBuffer(GCodeBuffer *gb) noexcept override;			// Fill a GCodeBuffer with the last available G-code
 
 private:
 	Stream &device;
+	char storage[GCodeInputBufferSize];
 };
 
 enum class GCodeInputReadResult : uint8_t { haveData, noData, error };
@@ -109,15 +118,21 @@ class FileGCodeInput : public RegularGCodeInput
 {
 public:
 
-	FileGCodeInput() noexcept : RegularGCodeInput() { }
+	FileGCodeInput() noexcept : RegularGCodeInput(storage, FileGCodeInputBufferSize), validBytes(0), validDataEndPosition(0) { }
 
 	void Reset() noexcept override;								// Clears the buffer. Should be called when the associated file is being closed
 	void Reset(const FileData &file) noexcept;					// Clears the buffer of a specific file. Should be called when it is closed or re-opened outside the reading context
+	bool RewindTo(const FileData &file, FilePosition pos) noexcept;	// Go back to an earlier position in the file without re-reading it if the data is still in the buffer
 
 	GCodeInputReadResult ReadFromFile(FileData &file) noexcept;	// Read another chunk of G-codes from the file and return true if more data is available
 
 private:
+	void ClearHistory() noexcept { validBytes = 0; }
+
 	FileData lastFileRead;
+	size_t validBytes;											// how many bytes before writingPointer hold file data, including data already passed to the parser
+	FilePosition validDataEndPosition;							// the file position that corresponds to writingPointer
+	alignas(4) char storage[FileGCodeInputBufferSize];
 };
 
 #endif
@@ -135,6 +150,7 @@ private:
 	void Put(MessageType mtype, char c) noexcept;				// Append a single character. This does NOT lock the mutex!
 
 	Mutex bufMutex;
+	char storage[GCodeInputBufferSize];
 };
 
 #endif
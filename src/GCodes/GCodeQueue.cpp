@@ -15,7 +15,7 @@
 
 // GCodeQueue class
 
-GCodeQueue::GCodeQueue() noexcept : freeItems(nullptr), queuedItems(nullptr)
+GCodeQueue::GCodeQueue() noexcept : freeItems(nullptr), queuedItems(nullptr), lastQueuedItem(nullptr), timesFull(0)
 {
 	for (size_t i = 0; i < maxQueuedCodes; i++)
 	{
@@ -123,6 +123,11 @@ bool GCodeQueue::QueueCode(GCodeBuffer &gb, uint32_t scheduleAt) noexcept
 	// Can we queue this code somewhere?
 	if (freeItems == nullptr)
 	{
+		if (!gb.WasQueueFullCounted())
+		{
+			++timesFull;								// count each code only once, although we are called repeatedly until it can be queued
+			gb.SetQueueFullCounted();
+		}
 		return false;
 	}
 
@@ -133,20 +138,16 @@ bool GCodeQueue::QueueCode(GCodeBuffer &gb, uint32_t scheduleAt) noexcept
 	code->executeAtMove = scheduleAt;
 	code->next = nullptr;
 
-	// Append it to the list of queued codes
+	// Append it to the list of queued codes. The codes are in order of increasing move number, so FillBuffer only needs to look at the first one.
 	if (queuedItems == nullptr)
 	{
 		queuedItems = code;
 	}
 	else
 	{
-		QueuedCode *last = queuedItems;
-		while (last->Next() != nullptr)
-		{
-			last = last->Next();
-		}
-		last->next = code;
+		lastQueuedItem->next = code;
 	}
+	lastQueuedItem = code;
 
 	return true;
 }
@@ -166,6 +167,10 @@ bool GCodeQueue::FillBuffer(GCodeBuffer *gb) noexcept
 
 	// Release this item again
 	queuedItems = queuedItems->next;
+	if (queuedItems == nullptr)
+	{
+		lastQueuedItem = nullptr;
+	}
 	code->next = freeItems;
 	freeItems = code;
 	return true;
@@ -219,6 +224,7 @@ void GCodeQueue::PurgeEntries() noexcept
 			item = item->Next();
 		}
 	}
+	lastQueuedItem = lastItem;
 }
 
 void GCodeQueue::Clear() noexcept
@@ -230,13 +236,14 @@ void GCodeQueue::Clear() noexcept
 		item->next = freeItems;
 		freeItems = item;
 	}
+	lastQueuedItem = nullptr;
 }
 
 void GCodeQueue::Diagnostics(MessageType mtype) noexcept
 {
 	if (queuedItems == nullptr)
 	{
-		reprap.GetPlatform().Message(mtype, "Code queue is empty\n");
+		reprap.GetPlatform().MessageF(mtype, "Code queue is empty, full count %u\n", timesFull);
 	}
 	else
 	{
@@ -252,7 +259,9 @@ void GCodeQueue::Diagnostics(MessageType mtype) noexcept
 				reprap.GetPlatform().MessageF(mtype, "Queued '%.*s' for move %" PRIu32 "\n", item->dataLength, item->data, item->executeAtMove);
 			}
 		} while ((item = item->Next()) != nullptr);
+		reprap.GetPlatform().MessageF(mtype, "Code queue full count %u\n", timesFull);
 	}
+	timesFull = 0;
 }
 
 // QueuedCode class
@@ -35,6 +35,8 @@ public:
 private:
 	QueuedCode *freeItems;
 	QueuedCode *queuedItems;
+	QueuedCode *lastQueuedItem;											// the last item in the queuedItems list, so that we can append to it quickly
+	unsigned int timesFull;												// how many times a code could not be queued because the queue was full
 };
 
 class QueuedCode
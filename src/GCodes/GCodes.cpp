@@ -279,6 +279,8 @@ void GCodes::Reset() noexcept
 		tr.Init();
 	}
 	triggersPending.Clear();
+	triggersConfigured.Clear();
+	mergeBarrierPending = false;
 
 	simulationMode = SimulationMode::off;
 	exitSimulationWhenFileComplete = updateFileWhenSimulationComplete = false;
@@ -461,6 +463,10 @@ void GCodes::Spin() noexcept
 		}
 	} while (nextGcodeSource != originalNextGCodeSource);
 
+	// While the current object is cancelled, most of the commands in the file are moves that we discard. Process several of them per spin so that we skip over the cancelled object quickly.
+	for (unsigned int i = 0; i < MaxCancelledObjectCommandsPerSpin && buildObjects.IsCurrentObjectCancelled() && SpinGCodeBuffer(*fileGCode); ++i) { }
+
+	QueueWaitingMove();
 
 #if HAS_SBC_INTERFACE
 	// Need to check if the print has been stopped by the SBC
@@ -810,13 +816,15 @@ void GCodes::EndSimulation(GCodeBuffer *gb) noexcept
 // Check for and execute triggers
 void GCodes::CheckTriggers() noexcept
 {
-	for (unsigned int i = 0; i < MaxTriggers; ++i)
-	{
-		if (!triggersPending.IsBitSet(i) && triggers[i].Check())
-		{
-			triggersPending.SetBit(i);
-		}
-	}
+	// Only look at triggers that have been configured, so that this costs almost nothing on machines that use few or no triggers
+	triggersConfigured.Iterate([this](unsigned int i, unsigned int) noexcept
+								{
+									if (!triggersPending.IsBitSet(i) && triggers[i].Check())
+									{
+										triggersPending.SetBit(i);
+									}
+								}
+							  );
 
 	// If any triggers are pending, activate the one with the lowest number
 	if (triggersPending.IsNonEmpty())
@@ -1988,12 +1996,22 @@ bool GCodes::DoStraightMove(GCodeBuffer& gb, bool isCoordinated, const char *& e
 			const float moveLength = fastSqrtf(moveLengthSquared);
 			const float moveTime = moveLength/(moveState.feedRate * StepClockRate);		// this is a best-case time, often the move will take longer
 			moveState.totalSegments = (unsigned int)max<long>(1, lrintf(min<float>(moveLength * kin.GetReciprocalMinSegmentLength(), moveTime * kin.GetSegmentsPerSecond())));
+
+			// If a maximum path error has been configured then the segment rate and minimum length are upper limits, and we use fewer segments where the kinematics is nearly linear
+			const unsigned int segmentsForMaxError = kin.GetSegmentsForMaxError(moveState.initialCoords, moveState.coords, moveState.totalSegments);
+			if (segmentsForMaxError != 0)
+			{
+				moveState.totalSegments = segmentsForMaxError;
+			}
 		}
 		else
 		{
 			moveState.totalSegments = 1;
 		}
-		if (reprap.GetMove().IsUsingMesh() && (moveState.isCoordinated || machineType == MachineType::fff))
+		// Segment the move to follow the mesh, unless it is entirely at or above the height at which mesh compensation has been tapered off
+		if (   reprap.GetMove().IsUsingMesh() && (moveState.isCoordinated || machineType == MachineType::fff)
+			&& !reprap.GetMove().IsAboveTaperHeight(moveState.initialCoords[Z_AXIS], moveState.coords[Z_AXIS], reprap.GetCurrentTool())
+		   )
 		{
 			const HeightMap& heightMap = reprap.GetMove().AccessHeightMap();
 			const GridDefinition& grid = heightMap.GetGrid();
@@ -2351,6 +2369,7 @@ bool GCodes::DoArcMove(GCodeBuffer& gb, bool clockwise, const char *& err)
 	// For the arc to deviate up to MaxArcDeviation from the ideal, the segment length should be sqrtf(8 * arcRadius * MaxArcDeviation + fsquare(MaxArcDeviation))
 	// We leave out the square term because it is very small
 	// In CNC applications even very small deviations can be visible, so we use a smaller segment length at low speeds
+	// At high speeds the segment length is the smaller of the length allowed by the deviation limit and MaxArcSegmentLength
 	const float arcSegmentLength = constrain<float>
 									(	min<float>(fastSqrtf(8 * moveState.arcRadius * MaxArcDeviation), moveState.feedRate * StepClockRate * (1.0/MinArcSegmentsPerSec)),
 										MinArcSegmentLength,
@@ -2460,6 +2479,7 @@ bool GCodes::ReadMove(RawMove& m) noexcept
 	while (true)		// loop while we skip move segments
 	{
 		m = moveState;
+		moveState.mergeBarrier = false;			// only the first segment follows any queued codes
 
 		if (moveState.segmentsLeft == 1)
 		{
@@ -2582,16 +2602,52 @@ void GCodes::ClearMove() noexcept
 void GCodes::NewSingleSegmentMoveAvailable() noexcept
 {
 	moveState.totalSegments = 1;
+	moveState.mergeBarrier = mergeBarrierPending;
+	mergeBarrierPending = false;
 	__DMB();									// make sure that all the move details have been written first
 	moveState.segmentsLeft = 1;					// set the number of segments to indicate that a move is available to be taken
 	reprap.GetMove().MoveAvailable();			// notify the Move task that we have a move
 }
 
+// If we are holding a complete single-segment move from a file being printed, pass it to the raw move queue in Move so that we can carry on processing commands.
+// We don't queue other moves because the pause and restore logic relies on them being taken directly from moveState.
+void GCodes::QueueWaitingMove() noexcept
+{
+	if (   moveState.segmentsLeft == 1 && moveState.totalSegments == 1
+		&& moveState.moveType == 0 && !moveState.checkEndstops && moveState.filePos != noFilePosition
+	   )
+	{
+		RawMoveQueue& queue = reprap.GetMove().GetRawMoveQueue();
+		bool queued = false;
+		{
+			TaskCriticalSectionLocker lock;			// stop the Move task reading this move while we are doing so
+			if (moveState.segmentsLeft == 1)		// check that the Move task didn't take it before we locked it out
+			{
+				if (queue.IsFull())
+				{
+					queue.RecordStall();
+				}
+				else
+				{
+					RawMove m;
+					queued = ReadMove(m) && queue.Put(m);
+				}
+			}
+		}
+		if (queued)
+		{
+			reprap.GetMove().MoveAvailable();		// notify the Move task that we have a move
+		}
+	}
+}
+
 // Flag that a new move is available for consumption by the Move subsystem
 // This version is for when totalSegments has already be set up.
 void GCodes::NewMoveAvailable() noexcept
 {
 	const unsigned int sl = moveState.totalSegments;
+	moveState.mergeBarrier = mergeBarrierPending;
+	mergeBarrierPending = false;
 	__DMB();									// make sure that the move details have been written first
 	moveState.segmentsLeft = sl;				// set the number of segments to indicate that a move is available to be taken
 	reprap.GetMove().MoveAvailable();			// notify the Move task that we have a move
@@ -2681,7 +2737,7 @@ bool GCodes::DoFileMacro(GCodeBuffer& gb, const char* fileName, bool reportMissi
 #endif
 	{
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
-		FileStore * const f = platform.OpenSysFile(fileName, OpenMode::read);
+		FileStore * const f = platform.OpenSysMacroFile(fileName);
 		if (f == nullptr)
 		{
 			if (reportMissing)
@@ -282,6 +282,7 @@ public:
 #endif
 
 	static constexpr const char *AllowedAxisLetters = "XYZUVWABCDabcdefghijkl";
+	static constexpr unsigned int MaxCancelledObjectCommandsPerSpin = 32;		// max additional file commands we process per spin while skipping a cancelled object
 
 	// Standard macro filenames
 #define DEPLOYPROBE		"deployprobe"
@@ -505,6 +506,7 @@ private:
 #endif
 
 	void NewSingleSegmentMoveAvailable() noexcept;								// Flag that a new move is available
+	void QueueWaitingMove() noexcept;											// Pass a waiting single-segment move to the Move raw move queue if possible
 	void NewMoveAvailable() noexcept;											// Flag that a new move is available
 
 	void SetMoveBufferDefaults() noexcept;										// Set up default values in the move buffer
@@ -665,6 +667,8 @@ private:
 	// Triggers
 	TriggerItem triggers[MaxTriggers];				// Trigger conditions
 	TriggerNumbersBitmap triggersPending;		// Bitmap of triggers pending but not yet executed
+	TriggerNumbersBitmap triggersConfigured;	// Bitmap of triggers that watch at least one input
+	bool mergeBarrierPending;					// True if a code has been queued since the last move was set up, so the next move must not be merged with earlier ones
 
 	// Firmware update
 	Bitmap<uint8_t> firmwareUpdateModuleMap;	// Bitmap of firmware modules to be updated
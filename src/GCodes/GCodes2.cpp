@@ -80,6 +80,7 @@ bool GCodes::ActOnCode(GCodeBuffer& gb, const StringRef& reply) noexcept
 
 			if (codeQueue->QueueCode(gb, reprap.GetMove().GetScheduledMoves() + moveState.segmentsLeft))
 			{
+				mergeBarrierPending = true;			// the code must execute between the last move and the next one
 				HandleReply(gb, GCodeResult::ok, "");
 				return true;
 			}
@@ -3408,6 +3409,12 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 						reprap.GetMove().SetJerkPolicy(gb.GetUIValue());
 					}
 
+					if (code == 566 && gb.Seen('J'))
+					{
+						seenAxis = true;
+						reprap.GetMove().SetJunctionDeviation(gb.GetFValue());
+					}
+
 					if (seenAxis)
 					{
 						reprap.MoveUpdated();
@@ -3428,7 +3435,7 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 						}
 						if (code == 566)
 						{
-							reply.catf(", jerk policy: %u", reprap.GetMove().GetJerkPolicy());
+							reply.catf(", jerk policy: %u, junction deviation: %.3fmm", reprap.GetMove().GetJerkPolicy(), (double)reprap.GetMove().GetJunctionDeviation());
 						}
 					}
 				}
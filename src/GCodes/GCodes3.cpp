@@ -533,7 +533,13 @@ GCodeResult GCodes::ConfigureTrigger(GCodeBuffer& gb, const StringRef& reply)
 	const unsigned int triggerNumber = gb.GetUIValue();
 	if (triggerNumber < MaxTriggers)
 	{
-		return triggers[triggerNumber].Configure(triggerNumber, gb, reply);
+		triggersConfigured.SetBit(triggerNumber);					// in case Configure throws after changing the trigger
+		const GCodeResult rslt = triggers[triggerNumber].Configure(triggerNumber, gb, reply);
+		if (triggers[triggerNumber].IsUnused())
+		{
+			triggersConfigured.ClearBit(triggerNumber);
+		}
+		return rslt;
 	}
 
 	reply.copy("Trigger number out of range");
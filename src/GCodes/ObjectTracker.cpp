@@ -51,7 +51,7 @@ constexpr ObjectModelTableEntry ObjectTracker::objectModelTable[] =
 #if TRACK_OBJECT_NAMES
 	// 1. ObjectDirectoryEntry root
 	{ "cancelled",	OBJECT_MODEL_FUNC(self->IsCancelled(context.GetLastIndex())),			ObjectModelEntryFlags::none },
-	{ "name",		OBJECT_MODEL_FUNC(self->objectDirectory[context.GetLastIndex()].name.IncreaseRefCount()),	ObjectModelEntryFlags::none },
+	{ "name",		OBJECT_MODEL_FUNC(self->GetObject(context.GetLastIndex()).name.IncreaseRefCount()),	ObjectModelEntryFlags::none },
 	{ "x",			OBJECT_MODEL_FUNC_NOSELF(&xArrayDescriptor),							ObjectModelEntryFlags::none },
 	{ "y",			OBJECT_MODEL_FUNC_NOSELF(&yArrayDescriptor),							ObjectModelEntryFlags::none },
 #endif
@@ -77,10 +77,16 @@ void ObjectTracker::Init() noexcept
 	numObjects = 0;
 	currentObjectCancelled = printingJustResumed = usingM486Labelling = false;
 #if TRACK_OBJECT_NAMES
-	// Clear out all object names in case of late object model requests
-	for (ObjectDirectoryEntry& ode : objectDirectory)
+	// Clear out all object names in case of late object model requests. We keep the directory blocks for the next print.
+	for (ObjectDirectoryEntry *_ecv_array _ecv_null block : objectDirectoryBlocks)
 	{
-		ode.Init("");
+		if (block != nullptr)
+		{
+			for (size_t i = 0; i < ObjectDirectoryBlockSize; ++i)
+			{
+				block[i].Init("");
+			}
+		}
 	}
 	usingM486Naming = false;
 #endif
@@ -91,6 +97,9 @@ void ObjectTracker::ChangeToObject(GCodeBuffer& gb, int i) noexcept
 	currentObjectNumber = i;
 	if (currentObjectNumber >= (int)numObjects)
 	{
+#if TRACK_OBJECT_NAMES
+		AllocateObjects(currentObjectNumber + 1);
+#endif
 		numObjects = currentObjectNumber + 1;
 	}
 	const bool cancelCurrentObject = currentObjectNumber >= 0 && currentObjectNumber < (int)objectsCancelled.MaxBits() && objectsCancelled.IsBitSet(currentObjectNumber);
@@ -111,7 +120,11 @@ GCodeResult ObjectTracker::HandleM486(GCodeBuffer &gb, const StringRef &reply, O
 	{
 		// Specify how many objects. May be useful for a user interface.
 		seen = true;
-		numObjects = gb.GetUIValue();
+		const uint32_t num = gb.GetUIValue();
+#if TRACK_OBJECT_NAMES
+		AllocateObjects(num);
+#endif
+		numObjects = num;
 		objectsCancelled.Clear();						// assume this command is only used at the start of a print
 		reprap.JobUpdated();
 	}
@@ -137,9 +150,9 @@ GCodeResult ObjectTracker::HandleM486(GCodeBuffer &gb, const StringRef &reply, O
 			{
 				CreateObject(num, objectName.c_str());
 			}
-			else if (num < (int)MaxTrackedObjects && strcmp(objectName.c_str(), objectDirectory[num].name.Get().Ptr()) != 0)
+			else if (num < (int)MaxTrackedObjects && strcmp(objectName.c_str(), GetObject(num).name.Get().Ptr()) != 0)
 			{
-				objectDirectory[num].SetName(objectName.c_str());
+				GetObject(num).SetName(objectName.c_str());
 				reprap.JobUpdated();
 			}
 		}
@@ -218,7 +231,7 @@ GCodeResult ObjectTracker::HandleM486(GCodeBuffer &gb, const StringRef &reply, O
 		{
 			for (size_t i = 0; i < min<unsigned int>(numObjects, MaxTrackedObjects); ++i)
 			{
-				const ObjectDirectoryEntry& obj = objectDirectory[i];
+				const ObjectDirectoryEntry& obj = GetObject(i);
 				buf->lcatf("%2u%s: X %d to %dmm, Y %d to %dmm, %s",
 							i,
 							(objectsCancelled.IsBitSet(i) ? " (cancelled)" : ""),
@@ -277,7 +290,7 @@ bool ObjectTracker::WriteObjectDirectory(FileStore *f) const noexcept
 	for (size_t i = 0; ok && i < min<unsigned int>(numObjects, MaxTrackedObjects); ++i)
 	{
 		String<StringLength100> buf;
-		buf.printf("M486 S%u A\"%s\"\n", i, objectDirectory[i].name.Get().Ptr());
+		buf.printf("M486 S%u A\"%s\"\n", i, GetObject(i).name.Get().Ptr());
 		ok = f->Write(buf.c_str());
 	}
 #else
@@ -380,24 +393,43 @@ void ObjectTracker::UpdateObjectCoordinates(const float coords[], AxesBitmap axe
 {
 	if (currentObjectNumber >= 0 && currentObjectNumber < (int)MaxTrackedObjects)
 	{
-		if (objectDirectory[currentObjectNumber].UpdateObjectCoordinates(coords, axes))
+		if (GetObject(currentObjectNumber).UpdateObjectCoordinates(coords, axes))
 		{
 			reprap.JobUpdated();
 		}
 	}
 }
 
+// Make sure that the directory has entries for the first 'num' objects, or for all the objects we can track if 'num' is larger than that
+void ObjectTracker::AllocateObjects(unsigned int num) noexcept
+{
+	const size_t blocksNeeded = (min<size_t>(num, MaxTrackedObjects) + ObjectDirectoryBlockSize - 1)/ObjectDirectoryBlockSize;
+	for (size_t i = 0; i < blocksNeeded; ++i)
+	{
+		if (objectDirectoryBlocks[i] == nullptr)
+		{
+			ObjectDirectoryEntry *_ecv_array const block = new ObjectDirectoryEntry[ObjectDirectoryBlockSize];
+			for (size_t j = 0; j < ObjectDirectoryBlockSize; ++j)
+			{
+				block[j].Init("");
+			}
+			objectDirectoryBlocks[i] = block;
+		}
+	}
+}
+
 // This is called when we need to create a new named object
 void ObjectTracker::CreateObject(unsigned int number, const char *label) noexcept
 {
 	if (number < MaxTrackedObjects)
 	{
+		AllocateObjects(number + 1);
 		while (numObjects <= number)
 		{
-			objectDirectory[numObjects].Init("");
+			GetObject(numObjects).Init("");
 			++numObjects;
 		}
-		objectDirectory[number].SetName(label);
+		GetObject(number).SetName(label);
 		reprap.JobUpdated();
 	}
 }
@@ -409,7 +441,7 @@ void ObjectTracker::StartObject(GCodeBuffer& gb, const char *label) noexcept
 	{
 		for (size_t i = 0; i < min<size_t>(numObjects, MaxTrackedObjects); ++i)
 		{
-			if (strcmp(objectDirectory[i].name.Get().Ptr(), label) == 0)
+			if (strcmp(GetObject(i).name.Get().Ptr(), label) == 0)
 			{
 				ChangeToObject(gb, i);
 				return;
@@ -442,13 +474,13 @@ void ObjectTracker::StopObject(GCodeBuffer& gb) noexcept
 
 ExpressionValue ObjectTracker::GetXCoordinate(const ObjectExplorationContext& context) const noexcept
 {
-	const int16_t val = objectDirectory[context.GetIndex(1)].x[context.GetIndex(0)];
+	const int16_t val = GetObject(context.GetIndex(1)).x[context.GetIndex(0)];
 	return (val == std::numeric_limits<int16_t>::min()) ? ExpressionValue(nullptr) : ExpressionValue((int32_t)val);
 }
 
 ExpressionValue ObjectTracker::GetYCoordinate(const ObjectExplorationContext& context) const noexcept
 {
-	const int16_t val = objectDirectory[context.GetIndex(1)].y[context.GetIndex(0)];
+	const int16_t val = GetObject(context.GetIndex(1)).y[context.GetIndex(0)];
 	return (val == std::numeric_limits<int16_t>::min()) ? ExpressionValue(nullptr) : ExpressionValue((int32_t)val);
 }
 
@@ -35,6 +35,9 @@ class ObjectTracker
 public:
 	ObjectTracker() noexcept
 		: numObjects(0)
+#if TRACK_OBJECT_NAMES
+		  , objectDirectoryBlocks()
+#endif
 	{ }
 
 	void Init() noexcept;
@@ -66,18 +69,33 @@ protected:
 #endif
 
 private:
-#if SAME70 || SAME5x
-	typedef Bitmap<uint64_t> ObjectCancellationBitmap;	// Type of a bitmap used to represent objects on the build plate that have been cancelled
-#else
-	typedef Bitmap<uint32_t> ObjectCancellationBitmap;	// Type of a bitmap used to represent objects on the build plate that have been cancelled
-#endif
-	static_assert(MaxTrackedObjects <= ObjectCancellationBitmap::MaxBits());
+	// Bitmap used to represent objects on the build plate that have been cancelled. There are too many objects for one of the standard bitmap types.
+	class ObjectCancellationBitmap
+	{
+	public:
+		ObjectCancellationBitmap() noexcept { Clear(); }
+
+		void Clear() noexcept { for (uint32_t& w : words) { w = 0; } }
+		void SetBit(unsigned int n) noexcept { words[n / 32] |= 1u << (n % 32); }
+		void ClearBit(unsigned int n) noexcept { words[n / 32] &= ~(1u << (n % 32)); }
+		bool IsBitSet(unsigned int n) const noexcept { return n < MaxBits() && (words[n / 32] & (1u << (n % 32))) != 0; }
+		static constexpr unsigned int MaxBits() noexcept { return NumWords * 32; }
+
+		// Call a function for each set bit in turn, stopping if it returns false. Return true if we didn't stop early.
+		template<class F> bool IterateWhile(F func) const noexcept;
+
+	private:
+		static constexpr size_t NumWords = (MaxTrackedObjects + 31)/32;
+		uint32_t words[NumWords];
+	};
 
 	void ChangeToObject(GCodeBuffer& gb, int i) noexcept;
 	void StopPrinting(GCodeBuffer& gb) noexcept;
 	void ResumePrinting(GCodeBuffer& gb) noexcept;
 
 #if TRACK_OBJECT_NAMES
+	void AllocateObjects(unsigned int num) noexcept;
+	ObjectDirectoryEntry& GetObject(size_t n) const noexcept { return objectDirectoryBlocks[n / ObjectDirectoryBlockSize][n % ObjectDirectoryBlockSize]; }
 	void CreateObject(unsigned int number, const char *label) noexcept;
 	ExpressionValue GetXCoordinate(const ObjectExplorationContext& context) const noexcept;
 	ExpressionValue GetYCoordinate(const ObjectExplorationContext& context) const noexcept;
@@ -90,7 +108,7 @@ private:
 	int virtualToolNumber;								// the number of the tool that was active when we cancelled an object
 
 #if TRACK_OBJECT_NAMES
-	ObjectDirectoryEntry objectDirectory[MaxTrackedObjects];
+	ObjectDirectoryEntry *_ecv_array _ecv_null objectDirectoryBlocks[(MaxTrackedObjects + ObjectDirectoryBlockSize - 1)/ObjectDirectoryBlockSize];	// allocated when first needed and kept
 	bool usingM486Naming;
 #endif
 
@@ -99,4 +117,21 @@ private:
 	bool printingJustResumed;							// true if we have just restarted printing
 };
 
+template<class F> bool ObjectTracker::ObjectCancellationBitmap::IterateWhile(F func) const noexcept
+{
+	bool first = true;
+	for (unsigned int i = 0; i < MaxBits(); ++i)
+	{
+		if (IsBitSet(i))
+		{
+			if (!func(i, first))
+			{
+				return false;
+			}
+			first = false;
+		}
+	}
+	return true;
+}
+
 #endif /* SRC_GCODES_OBJECTTRACKER_H_ */
@@ -709,7 +709,8 @@ void ethernetif_hardware_init() noexcept
 	hri_gmac_write_NCR_reg(GMAC, GMAC_NCR_MPE);
 	hri_gmac_write_NCFGR_reg(GMAC, GMAC_NCFGR_SPD | GMAC_NCFGR_FD | GMAC_NCFGR_MAXFS | GMAC_NCFGR_CLK(CONF_GMAC_NCFGR_CLK));
 	hri_gmac_write_UR_reg(GMAC, 0);
-	hri_gmac_write_DCFGR_reg(GMAC, GMAC_DCFGR_FBLDO(CONF_GMAC_DCFGR_FBLDO) | GMAC_DCFGR_RXBMS(CONF_GMAC_DCFGR_RXBMS) | GMAC_DCFGR_TXPBMS | GMAC_DCFGR_DRBS(CONF_GMAC_DCFGR_DRBS));
+	// TXCOEN makes the GMAC generate IP, UDP and TCP checksums of transmitted frames. It needs the full size TX packet buffer (TXPBMS).
+	hri_gmac_write_DCFGR_reg(GMAC, GMAC_DCFGR_FBLDO(CONF_GMAC_DCFGR_FBLDO) | GMAC_DCFGR_RXBMS(CONF_GMAC_DCFGR_RXBMS) | GMAC_DCFGR_TXPBMS | GMAC_DCFGR_TXCOEN | GMAC_DCFGR_DRBS(CONF_GMAC_DCFGR_DRBS));
 	hri_gmac_write_WOL_reg(GMAC, 0);
 	hri_gmac_write_IPGS_reg(GMAC, GMAC_IPGS_FL((CONF_GMAC_IPGS_FL_MUL << 8) | CONF_GMAC_IPGS_FL_DIV));
 
@@ -719,11 +720,11 @@ void ethernetif_hardware_init() noexcept
 	/* Enable the copy of data into the buffers ignore broadcasts, and not copy FCS. */
 	gmac_enable_copy_all(GMAC, false);
 	gmac_disable_broadcast(GMAC, false);
-	GMAC->NCR.reg |= GMAC_NCFGR_RXCOEN;			// check IP, UDP and TCP checksums so that we don't need to do it in lwip
+	GMAC->NCFGR.reg |= GMAC_NCFGR_RXCOEN;		// check IP, UDP and TCP checksums so that we don't need to do it in lwip
 
 #if SUPPORT_MULTICAST_DISCOVERY
 	// Without this code, we don't receive any multicast packets
-	GMAC->NCR.reg |= GMAC_NCFGR_MTIHEN;			// enable multicast hash reception
+	GMAC->NCFGR.reg |= GMAC_NCFGR_MTIHEN;		// enable multicast hash reception
 	GMAC->HRB.reg = 0xFFFFFFFF;					// enable reception of all multicast frames
 	GMAC->HRT.reg = 0xFFFFFFFF;
 #endif
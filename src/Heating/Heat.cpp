@@ -27,6 +27,7 @@ Licence: GPL
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include <Tools/Tool.h>
 #include <Platform/TaskPriorities.h>
+#include <Movement/StepTimer.h>
 #include <General/Portability.h>
 
 #if SUPPORT_DHT_SENSOR
@@ -119,7 +120,7 @@ ReadWriteLock Heat::heatersLock;
 ReadWriteLock Heat::sensorsLock;
 
 Heat::Heat() noexcept
-	: sensorCount(0), sensorsRoot(nullptr), sensorOrderingErrors(0), coldExtrude(false), heaterBeingTuned(-1), lastHeaterTuned(-1)
+	: sensorCount(0), sensorsRoot(nullptr), sensorOrderingErrors(0), maxSensorPollTicks(0), slowestSensorNumber(-1), coldExtrude(false), heaterBeingTuned(-1), lastHeaterTuned(-1)
 #if SUPPORT_REMOTE_COMMANDS
 	, newHeaterFaultState(0), newDriverFaultState(0)
 #endif
@@ -384,7 +385,14 @@ void Heat::SendHeatersStatus(CanMessageBuffer& buf) noexcept
 					TemperatureSensor *currentSensor = sensorsRoot;
 					while (currentSensor != nullptr)
 					{
+						const uint32_t pollStartTicks = StepTimer::GetTimerTicks();
 						currentSensor->Poll();
+						const uint32_t pollTicks = StepTimer::GetTimerTicks() - pollStartTicks;
+						if (pollTicks > maxSensorPollTicks)
+						{
+							maxSensorPollTicks = pollTicks;
+							slowestSensorNumber = (int)currentSensor->GetSensorNumber();
+						}
 #if SUPPORT_CAN_EXPANSION
 						if (currentSensor->GetBoardAddress() == CanInterface::GetCanAddress() && sensorsFound < ARRAY_SIZE(msg->temperatureReports))
 						{
@@ -531,6 +539,12 @@ void Heat::Diagnostics(MessageType mtype) noexcept
 	}
 	str.catf(", ordering errs %u\n", sensorOrderingErrors);
 	platform.Message(mtype, str.c_str());
+	if (slowestSensorNumber >= 0)
+	{
+		platform.MessageF(mtype, "Slowest sensor poll %.2fms (sensor %d)\n", (double)(maxSensorPollTicks * StepClocksToMillis), slowestSensorNumber);
+		maxSensorPollTicks = 0;
+		slowestSensorNumber = -1;
+	}
 
 	for (size_t heater : ARRAY_INDICES(heaters))
 	{
@@ -1306,48 +1320,75 @@ bool Heat::WriteBedAndChamberTempSettings(FileStore *f) const noexcept
 
 #if SUPPORT_CAN_EXPANSION
 
+// Process a report of the temperatures of all the sensors on an expansion board.
+// The sensor list is sorted by sensor number and the report lists sensors in ascending order, so we can apply the whole report in a single pass
+// through the list while holding the lock once, instead of searching the list and taking the lock for each sensor.
 void Heat::ProcessRemoteSensorsReport(CanAddress src, const CanMessageSensorTemperatures& msg) noexcept
 {
 	Bitmap<uint64_t> sensorsReported(msg.whichSensors);
-	sensorsReported.Iterate([this, src, &msg](unsigned int sensor, unsigned int index)
-								{
-									if (index < ARRAY_SIZE(msg.temperatureReports))
+	Bitmap<uint64_t> sensorsNotFound;
+	{
+		ReadLocker locker(sensorsLock);
+		TemperatureSensor *ts = sensorsRoot;
+		sensorsReported.Iterate([src, &msg, &ts, &sensorsNotFound](unsigned int sensor, unsigned int index)
 									{
-										const CanSensorReport& sr = msg.temperatureReports[index];
-										auto ts = FindSensor(sensor);
-										if (ts.IsNotNull())
+										if (index < ARRAY_SIZE(msg.temperatureReports))
 										{
-											ts->UpdateRemoteTemperature(src, sr);
+											while (ts != nullptr && ts->GetSensorNumber() < sensor)
+											{
+												ts = ts->GetNext();
+											}
+											if (ts != nullptr && ts->GetSensorNumber() == sensor)
+											{
+												ts->UpdateRemoteTemperature(src, msg.temperatureReports[index]);
+											}
+											else
+											{
+												sensorsNotFound.SetBit(sensor);
+											}
 										}
-# ifdef DUET3_ATE
-										else
+									}
+								);
+	}
+
+# if defined(DUET3_ATE) || SUPPORT_REMOTE_COMMANDS
+	// Deal with any reported sensors that we don't have, now that we no longer hold the lock
+	if (!sensorsNotFound.IsEmpty())
+	{
+		sensorsReported.Iterate([this, src, &msg, sensorsNotFound](unsigned int sensor, unsigned int index)
+									{
+										if (index < ARRAY_SIZE(msg.temperatureReports) && sensorsNotFound.IsBitSet(sensor))
 										{
+											const CanSensorReport& sr = msg.temperatureReports[index];
+#  ifdef DUET3_ATE
 											Duet3Ate::ProcessOrphanedSensorReport(src, sensor, sr);
+#  else
+											if (CanInterface::InExpansionMode())
+											{
+												// Create a new RemoteSensor
+												RemoteSensor * const rs = new RemoteSensor(sensor, src);
+												rs->UpdateRemoteTemperature(src, sr);
+												InsertSensor(rs);
+											}
+#  endif
 										}
-# elif SUPPORT_REMOTE_COMMANDS
-										else if (CanInterface::InExpansionMode())
-										{
-											// Create a new RemoteSensor
-											ts.Release();
-											RemoteSensor * const rs = new RemoteSensor(sensor, src);
-											rs->UpdateRemoteTemperature(src, sr);
-											InsertSensor(rs);
-										}
-# endif
 									}
-								}
-							);
+								);
+	}
+# endif
 }
 
+// Process a report of the status of all the heaters on an expansion board
 void Heat::ProcessRemoteHeatersReport(CanAddress src, const CanMessageHeatersStatus& msg) noexcept
 {
 	Bitmap<uint64_t> heatersReported(msg.whichHeaters);
+	ReadLocker locker(heatersLock);
 	heatersReported.Iterate([this, src, &msg](unsigned int heaterNum, unsigned int index)
 								{
-									if (index < ARRAY_SIZE(msg.reports))
+									if (index < ARRAY_SIZE(msg.reports) && heaterNum < MaxHeaters)
 									{
-										const auto h = FindHeater(heaterNum);
-										if (h.IsNotNull())
+										Heater * const h = heaters[heaterNum];
+										if (h != nullptr)
 										{
 											h->UpdateRemoteStatus(src, msg.reports[index]);
 										}
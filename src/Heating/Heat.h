@@ -182,6 +182,8 @@ private:
 	float extrusionMinTemp;										// Minimum temperature to allow regular extrusion
 	float retractionMinTemp;									// Minimum temperature to allow regular retraction
 	unsigned int sensorOrderingErrors;							// Counts any issue with unordered temperature sensors
+	uint32_t maxSensorPollTicks;								// The longest time taken to poll a single sensor since the last diagnostics report, in step clocks
+	int slowestSensorNumber;									// The sensor that took that time
 	bool coldExtrude;											// Is cold extrusion allowed?
 	int8_t bedHeaters[MaxBedHeaters];							// Indices of the hot bed heaters to use or -1 if none is available
 	int8_t chamberHeaters[MaxChamberHeaters];					// Indices of the chamber heaters to use or -1 if none is available
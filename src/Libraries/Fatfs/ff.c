@@ -3942,7 +3942,23 @@ FRESULT f_read (
 			if (cc > 0) {						/* Read maximum contiguous sectors directly */
 #endif
 				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
+#if 1	//dc42
+					/* Files that were pre-allocated or written in one go are usually contiguous, so extend the transfer into the following
+					 * clusters while they are adjacent. This lets us issue a single multi-block read instead of one per cluster. */
+					if (cc > 255) cc = 255;			/* disk_read takes a BYTE sector count */
+					UINT avail = fs->csize - csect;	/* Sectors available up to the end of the last contiguous cluster */
+					DWORD lclst = fp->clust;
+					while (avail < cc) {
+						const DWORD nclst = get_fat(&fp->obj, lclst);
+						if (nclst != lclst + 1) break;	/* Not contiguous, end of chain or error */
+						lclst = nclst;
+						avail += fs->csize;
+					}
+					if (cc > avail) cc = avail;
+					fp->clust = lclst;			/* The transfer ends in this cluster */
+#else
 					cc = fs->csize - csect;
+#endif
 				}
 				if (disk_read(fs->pdrv, rbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
 #if !FF_FS_READONLY && FF_FS_MINIMIZE <= 2		/* Replace one of the read sectors with cached data if it contains a dirty sector */
@@ -4061,7 +4077,23 @@ FRESULT f_write (
 			if (cc > 0) {					/* Write maximum contiguous sectors directly */
 #endif
 				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
+#if 1	//dc42
+					/* If the following clusters are already allocated and adjacent, which is the case when the file was pre-allocated using f_expand,
+					 * then extend the transfer into them. We don't allocate new clusters here; create_chain does that at the next cluster boundary. */
+					if (cc > 255) cc = 255;			/* disk_write takes a BYTE sector count */
+					UINT avail = fs->csize - csect;	/* Sectors available up to the end of the last contiguous cluster */
+					DWORD lclst = fp->clust;
+					while (avail < cc) {
+						const DWORD nclst = get_fat(&fp->obj, lclst);
+						if (nclst != lclst + 1) break;	/* Not contiguous, end of chain or error */
+						lclst = nclst;
+						avail += fs->csize;
+					}
+					if (cc > avail) cc = avail;
+					fp->clust = lclst;			/* The transfer ends in this cluster */
+#else
 					cc = fs->csize - csect;
+#endif
 				}
 				if (disk_write(fs->pdrv, wbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
 #if FF_FS_MINIMIZE <= 2
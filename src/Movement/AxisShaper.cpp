@@ -9,6 +9,7 @@
 
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include <Platform/RepRap.h>
+#include <Platform/Platform.h>
 #include "StepTimer.h"
 #include "DDA.h"
 #include "MoveSegment.h"
@@ -60,6 +61,10 @@ AxisShaper::AxisShaper() noexcept
 	  minimumAcceleration(ConvertAcceleration(DefaultMinimumAcceleration)),
 	  type(InputShaperType::none)
 {
+#if INPUT_SHAPING_CACHE_ENTRIES
+	ClearShapingCache();
+	shapingCacheHits = shapingCacheMisses = 0;
+#endif
 }
 
 // Process M593
@@ -120,6 +125,9 @@ GCodeResult AxisShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THROW
 
 	if (seen)
 	{
+#if INPUT_SHAPING_CACHE_ENTRIES
+		ClearShapingCache();
+#endif
 		const float sqrtOneMinusZetaSquared = fastSqrtf(1.0 - fsquare(zeta));
 		const float dampedFrequency = frequency * sqrtOneMinusZetaSquared;
 		const float dampedPeriod = StepClockRate/dampedFrequency;
@@ -324,6 +332,10 @@ GCodeResult AxisShaper::Configure(GCodeBuffer& gb, const StringRef& reply) THROW
 				u += speedChange;
 			}
 			overlappedDeltaVPerA = u;
+
+			// Each of acceleration and deceleration may need up to 2 * numExtraImpulses shaping segments plus a middle one, and there may be a steady speed segment.
+			// Create enough segments for several prepared moves now so that the Move task doesn't have to allocate them while printing.
+			MoveSegment::InitialAllocate(MoveSegment::NumShapedMovesToPreallocate * (4 * numExtraImpulses + 3));
 		}
 
 		reprap.MoveUpdated();
@@ -516,22 +528,22 @@ void AxisShaper::PlanShaping(DDA& dda, PrepParams& params, bool shapingEnabled)
 			{
 				if ((dda.GetPrevious()->state != DDA::DDAState::frozen && dda.GetPrevious()->state != DDA::DDAState::executing) || !dda.GetPrevious()->flags.wasAccelOnlyMove)
 				{
-					TryShapeAccelBoth(dda, params);
+					ShapePhase(dda, params, ShapingPhase::accelBoth);
 				}
 				else if (params.unshaped.accelClocks >= minimumShapingEndOriginalClocks)
 				{
-					TryShapeAccelEnd(dda, params);
+					ShapePhase(dda, params, ShapingPhase::accelEnd);
 				}
 			}
 			if (params.unshaped.decelStartDistance < dda.totalDistance)
 			{
 				if (dda.GetNext()->GetState() != DDA::DDAState::provisional || !dda.GetNext()->IsDecelerationMove())
 				{
-					TryShapeDecelBoth(dda, params);
+					ShapePhase(dda, params, ShapingPhase::decelBoth);
 				}
 				else if (params.unshaped.decelClocks >= minimumShapingStartOriginalClocks)
 				{
-					TryShapeDecelStart(dda, params);
+					ShapePhase(dda, params, ShapingPhase::decelStart);
 				}
 			}
 		}
@@ -557,25 +569,74 @@ void AxisShaper::PlanShaping(DDA& dda, PrepParams& params, bool shapingEnabled)
 //	debugPrintf(" final plan %03x\n", (unsigned int)params.shapingPlan.all);
 }
 
-// Try to shape the end of the acceleration. We already know that there is sufficient acceleration time to do this, but we still need to check that there is enough distance.
-void AxisShaper::TryShapeAccelEnd(const DDA& dda, PrepParams& params) const noexcept
+// Try to shape the start or end or both of the acceleration or deceleration phase of a move.
+// We work out the plan for the phase (or fetch it from the cache) without regard to the total distance of the move, then we check that the move is long enough to implement it.
+void AxisShaper::ShapePhase(const DDA& dda, PrepParams& params, ShapingPhase phase) const noexcept
 {
-	const float extraAccelDistance = GetExtraAccelEndDistance(dda.topSpeed, params.unshaped.acceleration);
-	if (ImplementAccelShaping(dda, params, params.unshaped.accelDistance + extraAccelDistance, params.unshaped.accelClocks + extraClocksAtEnd))
+	const bool isAccel = (phase == ShapingPhase::accelBoth || phase == ShapingPhase::accelEnd);
+	const float phaseDistance = (isAccel) ? params.unshaped.accelDistance : dda.totalDistance - params.unshaped.decelStartDistance;
+	ShapingPhasePlan phasePlan;
+
+#if INPUT_SHAPING_CACHE_ENTRIES
+	const float phaseSpeed = (isAccel) ? dda.startSpeed : dda.endSpeed;
+	const float phaseAcceleration = (isAccel) ? params.unshaped.acceleration : params.unshaped.deceleration;
+	if (!FindCachedPlan(phase, phaseSpeed, dda.topSpeed, phaseAcceleration, phaseDistance, phasePlan))
 	{
-		params.shapingPlan.shapeAccelEnd = true;
+		ComputePhasePlan(dda, params, phase, phaseDistance, phasePlan);
+		StoreCachedPlan(phase, phaseSpeed, dda.topSpeed, phaseAcceleration, phaseDistance, phasePlan);
 	}
-	else
+#else
+	ComputePhasePlan(dda, params, phase, phaseDistance, phasePlan);
+#endif
+
+	if (phasePlan.plan.IsShaped() && ((isAccel) ? ApplyAccelPlan(params, phasePlan) : ApplyDecelPlan(dda, params, phasePlan)))
 	{
-		// Not enough constant speed time to the acceleration shaping
-		if (reprap.Debug(Module::moduleDda))
+		return;
+	}
+
+	// Not enough constant speed time to do the shaping
+	if (reprap.Debug(Module::moduleDda))
+	{
+		if (phase == ShapingPhase::accelEnd)
 		{
 			debugPrintf("Can't shape accel end\n");
 		}
+		else if (phase == ShapingPhase::decelStart)
+		{
+			debugPrintf("Can't shape decel start\n");
+		}
 	}
 }
 
-void AxisShaper::TryShapeAccelBoth(DDA& dda, PrepParams& params) const noexcept
+// Work out the distance-independent plan for shaping one phase of a move. If shaping is not possible then the plan flags in the result are left clear.
+void AxisShaper::ComputePhasePlan(const DDA& dda, const PrepParams& params, ShapingPhase phase, float phaseDistance, ShapingPhasePlan& result) const noexcept
+{
+	result.plan.Clear();
+	switch (phase)
+	{
+	case ShapingPhase::accelBoth:
+		PlanAccelBoth(dda, params, result);
+		break;
+
+	case ShapingPhase::accelEnd:
+		// We already know that there is sufficient acceleration time to do this, but ApplyAccelPlan still needs to check that there is enough distance
+		SetAccelPlan(dda, result, params.unshaped.accelDistance + GetExtraAccelEndDistance(dda.topSpeed, params.unshaped.acceleration), params.unshaped.accelClocks + extraClocksAtEnd, params.unshaped.acceleration);
+		result.plan.shapeAccelEnd = true;
+		break;
+
+	case ShapingPhase::decelBoth:
+		PlanDecelBoth(dda, params, phaseDistance, result);
+		break;
+
+	case ShapingPhase::decelStart:
+		// We already know that there is sufficient deceleration time to do this, but ApplyDecelPlan still needs to check that there is enough distance
+		SetDecelPlan(dda, result, phaseDistance + GetExtraDecelStartDistance(dda.topSpeed, params.unshaped.deceleration), params.unshaped.decelClocks + extraClocksAtStart, params.unshaped.deceleration);
+		result.plan.shapeDecelStart = true;
+		break;
+	}
+}
+
+void AxisShaper::PlanAccelBoth(const DDA& dda, const PrepParams& params, ShapingPhasePlan& result) const noexcept
 {
 	const float speedIncrease = dda.topSpeed - dda.startSpeed;
 	if (speedIncrease <= overlappedDeltaVPerA * params.unshaped.acceleration)
@@ -585,11 +646,8 @@ void AxisShaper::TryShapeAccelBoth(DDA& dda, PrepParams& params) const noexcept
 		if (newAcceleration >= minimumAcceleration)
 		{
 			const float newAccelDistance = (dda.startSpeed * overlappedShapingClocks) + (newAcceleration * overlappedDistancePerA);
-			if (ImplementAccelShaping(dda, params, newAccelDistance, overlappedShapingClocks))
-			{
-				params.shapingPlan.shapeAccelOverlapped = true;
-				params.shaped.acceleration = newAcceleration;
-			}
+			SetAccelPlan(dda, result, newAccelDistance, overlappedShapingClocks, newAcceleration);
+			result.plan.shapeAccelOverlapped = true;
 		}
 	}
 	else if (params.unshaped.accelClocks < minimumNonOverlappedOriginalClocks)
@@ -599,65 +657,19 @@ void AxisShaper::TryShapeAccelBoth(DDA& dda, PrepParams& params) const noexcept
 		const float newAcceleration = speedIncrease/minimumNonOverlappedOriginalClocks;
 		const float newUnshapedAccelDistance = (dda.startSpeed + 0.5 * newAcceleration * minimumNonOverlappedOriginalClocks) * minimumNonOverlappedOriginalClocks;
 		const float extraAccelDistance = GetExtraAccelStartDistance(dda.startSpeed, newAcceleration) + GetExtraAccelEndDistance(dda.topSpeed, newAcceleration);
-		if (ImplementAccelShaping(dda, params, newUnshapedAccelDistance + extraAccelDistance, minimumNonOverlappedOriginalClocks + extraClocksAtStart + extraClocksAtEnd))
-		{
-			params.shapingPlan.shapeAccelStart = params.shapingPlan.shapeAccelEnd = true;
-			params.shaped.acceleration = newAcceleration;
-			//params.shapingPlan.debugPrint = true;
-		}
+		SetAccelPlan(dda, result, newUnshapedAccelDistance + extraAccelDistance, minimumNonOverlappedOriginalClocks + extraClocksAtStart + extraClocksAtEnd, newAcceleration);
+		result.plan.shapeAccelStart = result.plan.shapeAccelEnd = true;
 	}
 	else
 	{
 		// We only attempt shaping if we can shape both the start and end of acceleration
 		const float extraAccelDistance = GetExtraAccelStartDistance(dda.startSpeed, params.unshaped.acceleration) + GetExtraAccelEndDistance(dda.topSpeed, params.unshaped.acceleration);
-		if (ImplementAccelShaping(dda, params, params.unshaped.accelDistance + extraAccelDistance, params.unshaped.accelClocks + extraClocksAtStart + extraClocksAtEnd))
-		{
-			params.shapingPlan.shapeAccelStart = params.shapingPlan.shapeAccelEnd = true;
-		}
+		SetAccelPlan(dda, result, params.unshaped.accelDistance + extraAccelDistance, params.unshaped.accelClocks + extraClocksAtStart + extraClocksAtEnd, params.unshaped.acceleration);
+		result.plan.shapeAccelStart = result.plan.shapeAccelEnd = true;
 	}
 }
 
-// Check whether we can implement acceleration shaping using the proposed parameters; if so then implement it and return true; else return false with nothing changed
-bool AxisShaper::ImplementAccelShaping(const DDA& dda, PrepParams& params, float newAccelDistance, float newAccelClocks) const noexcept
-{
-	if (newAccelDistance <= params.shaped.decelStartDistance)
-	{
-		const float speedIncrease = dda.topSpeed - dda.startSpeed;
-		const float unshapedAccelClocks = 2 * (dda.topSpeed * newAccelClocks - newAccelDistance)/speedIncrease;
-		const float unshapedAccelDistance = (dda.startSpeed + dda.topSpeed) * unshapedAccelClocks * 0.5;
-		if (unshapedAccelDistance <= params.unshaped.decelStartDistance)
-		{
-			params.shaped.accelDistance = newAccelDistance;
-			params.shaped.accelClocks = newAccelClocks;
-			params.unshaped.accelClocks = unshapedAccelClocks;
-			params.unshaped.accelDistance = unshapedAccelDistance;
-			params.unshaped.acceleration = speedIncrease/unshapedAccelClocks;
-			return true;
-		}
-	}
-
-	return false;
-}
-
-// Try to shape the start of the deceleration. We already know that there is sufficient deceleration time to do this, but we still need to check that there is enough distance.
-void AxisShaper::TryShapeDecelStart(const DDA& dda, PrepParams& params) const noexcept
-{
-	const float extraDecelDistance = GetExtraDecelStartDistance(dda.topSpeed, params.unshaped.deceleration);
-	if (ImplementDecelShaping(dda, params, params.unshaped.decelStartDistance - extraDecelDistance, params.unshaped.decelClocks + extraClocksAtStart))
-	{
-		params.shapingPlan.shapeDecelStart = true;
-	}
-	else
-	{
-		// Not enough constant speed time to do deceleration shaping
-		if (reprap.Debug(Module::moduleDda))
-		{
-			debugPrintf("Can't shape decel start\n");
-		}
-	}
-}
-
-void AxisShaper::TryShapeDecelBoth(DDA& dda, PrepParams& params) const noexcept
+void AxisShaper::PlanDecelBoth(const DDA& dda, const PrepParams& params, float decelDistance, ShapingPhasePlan& result) const noexcept
 {
 	const float speedDecrease = dda.topSpeed - dda.endSpeed;
 	if (speedDecrease <= overlappedDeltaVPerA * params.unshaped.deceleration)
@@ -667,11 +679,8 @@ void AxisShaper::TryShapeDecelBoth(DDA& dda, PrepParams& params) const noexcept
 		if (newDeceleration >= minimumAcceleration)
 		{
 			const float newDecelDistance = (dda.topSpeed * overlappedShapingClocks) - (newDeceleration * overlappedDistancePerA);
-			if (ImplementDecelShaping(dda, params, dda.totalDistance - newDecelDistance, overlappedShapingClocks))
-			{
-				params.shapingPlan.shapeDecelOverlapped = true;
-				params.shaped.deceleration = newDeceleration;
-			}
+			SetDecelPlan(dda, result, newDecelDistance, overlappedShapingClocks, newDeceleration);
+			result.plan.shapeDecelOverlapped = true;
 		}
 	}
 	else if (params.unshaped.decelClocks < minimumNonOverlappedOriginalClocks)
@@ -681,46 +690,146 @@ void AxisShaper::TryShapeDecelBoth(DDA& dda, PrepParams& params) const noexcept
 		const float newDeceleration = speedDecrease/minimumNonOverlappedOriginalClocks;
 		const float newUnshapedDecelDistance = (dda.endSpeed + (0.5 * newDeceleration * minimumNonOverlappedOriginalClocks)) * minimumNonOverlappedOriginalClocks;
 		const float extraDecelDistance = GetExtraDecelStartDistance(dda.topSpeed, newDeceleration) + GetExtraDecelEndDistance(dda.endSpeed, newDeceleration);
-		if (ImplementDecelShaping(dda, params, dda.totalDistance - (newUnshapedDecelDistance + extraDecelDistance), minimumNonOverlappedOriginalClocks + extraClocksAtStart + extraClocksAtEnd))
-		{
-			params.shapingPlan.shapeDecelStart = params.shapingPlan.shapeDecelEnd = true;
-			params.shaped.deceleration = newDeceleration;
-			//params.shapingPlan.debugPrint = true;
-		}
+		SetDecelPlan(dda, result, newUnshapedDecelDistance + extraDecelDistance, minimumNonOverlappedOriginalClocks + extraClocksAtStart + extraClocksAtEnd, newDeceleration);
+		result.plan.shapeDecelStart = result.plan.shapeDecelEnd = true;
 	}
 	else
 	{
 		// Only perform shaping if we can shape both the start and end of deceleration, otherwise we may not be able to generate a corresponding unshaped move because it might require negative steady distance
 		const float extraDecelDistance = GetExtraDecelStartDistance(dda.topSpeed, params.unshaped.deceleration) + GetExtraDecelEndDistance(dda.endSpeed, params.unshaped.deceleration);
-		if (ImplementDecelShaping(dda, params, params.unshaped.decelStartDistance - extraDecelDistance, params.unshaped.decelClocks + extraClocksAtStart + extraClocksAtEnd))
+		SetDecelPlan(dda, result, decelDistance + extraDecelDistance, params.unshaped.decelClocks + extraClocksAtStart + extraClocksAtEnd, params.unshaped.deceleration);
+		result.plan.shapeDecelStart = result.plan.shapeDecelEnd = true;
+	}
+}
+
+// Compute the unshaped acceleration parameters that correspond to the proposed shaped acceleration distance and time
+void AxisShaper::SetAccelPlan(const DDA& dda, ShapingPhasePlan& result, float newAccelDistance, float newAccelClocks, float newAcceleration) noexcept
+{
+	const float speedIncrease = dda.topSpeed - dda.startSpeed;
+	result.shapedDistance = newAccelDistance;
+	result.shapedClocks = newAccelClocks;
+	result.shapedAcceleration = newAcceleration;
+	result.unshapedClocks = 2 * (dda.topSpeed * newAccelClocks - newAccelDistance)/speedIncrease;
+	result.unshapedDistance = (dda.startSpeed + dda.topSpeed) * result.unshapedClocks * 0.5;
+	result.unshapedAcceleration = speedIncrease/result.unshapedClocks;
+}
+
+// Compute the unshaped deceleration parameters that correspond to the proposed shaped deceleration distance and time. The distances are measured back from the end of the move.
+void AxisShaper::SetDecelPlan(const DDA& dda, ShapingPhasePlan& result, float newDecelDistance, float newDecelClocks, float newDeceleration) noexcept
+{
+	const float speedDecrease = dda.topSpeed - dda.endSpeed;
+	result.shapedDistance = newDecelDistance;
+	result.shapedClocks = newDecelClocks;
+	result.shapedAcceleration = newDeceleration;
+	result.unshapedClocks = 2 * (dda.topSpeed * newDecelClocks - newDecelDistance)/speedDecrease;
+	result.unshapedDistance = (dda.topSpeed + dda.endSpeed) * result.unshapedClocks * 0.5;
+	result.unshapedAcceleration = speedDecrease/result.unshapedClocks;
+}
+
+// Check whether we can implement acceleration shaping using the plan; if so then implement it and return true; else return false with nothing changed
+bool AxisShaper::ApplyAccelPlan(PrepParams& params, const ShapingPhasePlan& phasePlan) noexcept
+{
+	if (phasePlan.shapedDistance <= params.shaped.decelStartDistance && phasePlan.unshapedDistance <= params.unshaped.decelStartDistance)
+	{
+		params.shaped.accelDistance = phasePlan.shapedDistance;
+		params.shaped.accelClocks = phasePlan.shapedClocks;
+		params.shaped.acceleration = phasePlan.shapedAcceleration;
+		params.unshaped.accelClocks = phasePlan.unshapedClocks;
+		params.unshaped.accelDistance = phasePlan.unshapedDistance;
+		params.unshaped.acceleration = phasePlan.unshapedAcceleration;
+		params.shapingPlan.all |= phasePlan.plan.all;
+		return true;
+	}
+
+	return false;
+}
+
+// Check whether we can implement deceleration shaping using the plan; if so then implement it and return true; else return false with nothing changed
+bool AxisShaper::ApplyDecelPlan(const DDA& dda, PrepParams& params, const ShapingPhasePlan& phasePlan) noexcept
+{
+	const float newDecelStartDistance = dda.totalDistance - phasePlan.shapedDistance;
+	if (params.shaped.accelDistance <= newDecelStartDistance && params.unshaped.accelDistance + phasePlan.unshapedDistance <= dda.totalDistance)
+	{
+		params.shaped.decelStartDistance = newDecelStartDistance;
+		params.shaped.decelClocks = phasePlan.shapedClocks;
+		params.shaped.deceleration = phasePlan.shapedAcceleration;
+		params.unshaped.decelClocks = phasePlan.unshapedClocks;
+		params.unshaped.decelStartDistance = dda.totalDistance - phasePlan.unshapedDistance;
+		params.unshaped.deceleration = phasePlan.unshapedAcceleration;
+		params.shapingPlan.all |= phasePlan.plan.all;
+		return true;
+	}
+
+	return false;
+}
+
+#if INPUT_SHAPING_CACHE_ENTRIES
+
+// Look for a previously computed plan for a phase with the same parameters. If we find one, copy it to 'result', mark it as most recently used and return true.
+bool AxisShaper::FindCachedPlan(ShapingPhase phase, float speed, float topSpeed, float acceleration, float distance, ShapingPhasePlan& result) const noexcept
+{
+	for (ShapingCacheEntry& entry : shapingCache)
+	{
+		if (   entry.valid && entry.phase == phase
+			&& entry.speed == speed && entry.topSpeed == topSpeed && entry.acceleration == acceleration && entry.distance == distance
+		   )
 		{
-			params.shapingPlan.shapeDecelStart = params.shapingPlan.shapeDecelEnd = true;
+			entry.lastUsed = ++shapingCacheClock;
+			result = entry.phasePlan;
+			++shapingCacheHits;
+			return true;
 		}
 	}
+	++shapingCacheMisses;
+	return false;
 }
 
-// Check whether we can implement acceleration shaping using the proposed parameters; if so then implement it and return true; else return false with nothing changed
-bool AxisShaper::ImplementDecelShaping(const DDA& dda, PrepParams& params, float newDecelStartDistance, float newDecelClocks) const noexcept
+// Store a newly computed plan, replacing the least recently used entry if the cache is full
+void AxisShaper::StoreCachedPlan(ShapingPhase phase, float speed, float topSpeed, float acceleration, float distance, const ShapingPhasePlan& phasePlan) const noexcept
 {
-	if (params.shaped.accelDistance <= newDecelStartDistance)
+	ShapingCacheEntry *victim = &shapingCache[0];
+	for (ShapingCacheEntry& entry : shapingCache)
 	{
-		const float speedDecrease = dda.topSpeed - dda.endSpeed;
-		const float unshapedDecelClocks = 2 * (dda.topSpeed * newDecelClocks - (dda.totalDistance - newDecelStartDistance))/speedDecrease;
-		const float unshapedDecelDistance = (dda.topSpeed + dda.endSpeed) * unshapedDecelClocks * 0.5;
-		if (params.unshaped.accelDistance + unshapedDecelDistance <= dda.totalDistance)
+		if (!entry.valid)
 		{
-			params.shaped.decelStartDistance = newDecelStartDistance;
-			params.shaped.decelClocks = newDecelClocks;
-			params.unshaped.decelClocks = unshapedDecelClocks;
-			params.unshaped.decelStartDistance = dda.totalDistance - unshapedDecelDistance;
-			params.unshaped.deceleration = speedDecrease/unshapedDecelClocks;
-			return true;
+			victim = &entry;
+			break;
+		}
+		if (entry.lastUsed < victim->lastUsed)
+		{
+			victim = &entry;
 		}
 	}
 
-	return false;
+	victim->phase = phase;
+	victim->speed = speed;
+	victim->topSpeed = topSpeed;
+	victim->acceleration = acceleration;
+	victim->distance = distance;
+	victim->phasePlan = phasePlan;
+	victim->lastUsed = ++shapingCacheClock;
+	victim->valid = true;
+}
+
+// Discard all cached plans. Called when the input shaping parameters are changed.
+void AxisShaper::ClearShapingCache() noexcept
+{
+	for (ShapingCacheEntry& entry : shapingCache)
+	{
+		entry.valid = false;
+	}
+	shapingCacheClock = 0;
+}
+
+// Report and reset the plan cache statistics
+void AxisShaper::Diagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "Shaping plan cache: hits %" PRIu32 ", misses %" PRIu32 "\n", shapingCacheHits, shapingCacheMisses);
+	shapingCacheHits = shapingCacheMisses = 0;
 }
 
+#endif
+
 // If there is an acceleration phase, generate the acceleration segments according to the plan, and set the number of acceleration segments in the plan
 MoveSegment *AxisShaper::GetAccelerationSegments(const DDA& dda, PrepParams& params) const noexcept
 {
@@ -15,6 +15,16 @@
 #include <ObjectModel/ObjectModel.h>
 #include "InputShaperPlan.h"
 
+// Set INPUT_SHAPING_CACHE_ENTRIES to the number of acceleration and deceleration shaping plans to remember.
+// Slicer output repeats the same speed and acceleration profiles many times, so a small cache saves recomputing the plans.
+#ifndef INPUT_SHAPING_CACHE_ENTRIES
+# if SAME70 || SAME5x
+#  define INPUT_SHAPING_CACHE_ENTRIES	(8)
+# else
+#  define INPUT_SHAPING_CACHE_ENTRIES	(0)		// save RAM
+# endif
+#endif
+
 // These names must be in alphabetical order and lowercase
 NamedEnum(InputShaperType, uint8_t,
 	custom,
@@ -48,6 +58,10 @@ public:
 
 	static MoveSegment *GetUnshapedSegments(DDA& dda, const PrepParams& params) noexcept;
 
+#if INPUT_SHAPING_CACHE_ENTRIES
+	void Diagnostics(MessageType mtype) noexcept;
+#endif
+
 protected:
 	DECLARE_OBJECT_MODEL
 	OBJECT_MODEL_ARRAY(amplitudes)
@@ -61,12 +75,48 @@ private:
 	float GetExtraAccelEndDistance(float topSpeed, float acceleration) const noexcept;
 	float GetExtraDecelStartDistance(float topSpeed, float deceleration) const noexcept;
 	float GetExtraDecelEndDistance(float endSpeed, float deceleration) const noexcept;
-	void TryShapeAccelEnd(const DDA& dda, PrepParams& params) const noexcept;
-	void TryShapeAccelBoth(DDA& dda, PrepParams& params) const noexcept;
-	void TryShapeDecelStart(const DDA& dda, PrepParams& params) const noexcept;
-	void TryShapeDecelBoth(DDA& dda, PrepParams& params) const noexcept;
-	bool ImplementAccelShaping(const DDA& dda, PrepParams& params, float newAccelDistance, float newAccelClocks) const noexcept;
-	bool ImplementDecelShaping(const DDA& dda, PrepParams& params, float newDecelStartDistance, float newDecelClocks) const noexcept;
+
+	enum class ShapingPhase : uint8_t { accelBoth, accelEnd, decelBoth, decelStart };
+
+	// The plan for shaping the acceleration or deceleration phase of a move. This does not depend on the total length of the move, so it can be reused for other moves with the same speeds and acceleration.
+	struct ShapingPhasePlan
+	{
+		float shapedDistance;							// the shaped acceleration distance, or the shaped deceleration distance measured back from the end of the move
+		float shapedClocks;
+		float shapedAcceleration;
+		float unshapedDistance;							// the corresponding unshaped acceleration or deceleration distance
+		float unshapedClocks;
+		float unshapedAcceleration;
+		InputShaperPlan plan;							// the plan flags to set if we implement this, all clear if shaping this phase isn't possible
+	};
+
+	void ShapePhase(const DDA& dda, PrepParams& params, ShapingPhase phase) const noexcept;
+	void ComputePhasePlan(const DDA& dda, const PrepParams& params, ShapingPhase phase, float phaseDistance, ShapingPhasePlan& result) const noexcept;
+	void PlanAccelBoth(const DDA& dda, const PrepParams& params, ShapingPhasePlan& result) const noexcept;
+	void PlanDecelBoth(const DDA& dda, const PrepParams& params, float decelDistance, ShapingPhasePlan& result) const noexcept;
+
+	static void SetAccelPlan(const DDA& dda, ShapingPhasePlan& result, float newAccelDistance, float newAccelClocks, float newAcceleration) noexcept;
+	static void SetDecelPlan(const DDA& dda, ShapingPhasePlan& result, float newDecelDistance, float newDecelClocks, float newDeceleration) noexcept;
+	static bool ApplyAccelPlan(PrepParams& params, const ShapingPhasePlan& phasePlan) noexcept;
+	static bool ApplyDecelPlan(const DDA& dda, PrepParams& params, const ShapingPhasePlan& phasePlan) noexcept;
+
+#if INPUT_SHAPING_CACHE_ENTRIES
+	struct ShapingCacheEntry
+	{
+		float speed;									// the start speed for an acceleration phase, or the end speed for a deceleration phase
+		float topSpeed;
+		float acceleration;								// the unshaped acceleration or deceleration
+		float distance;									// the unshaped acceleration or deceleration distance
+		uint32_t lastUsed;								// the value of shapingCacheClock when this entry was last used
+		ShapingPhase phase;
+		bool valid;
+		ShapingPhasePlan phasePlan;
+	};
+
+	bool FindCachedPlan(ShapingPhase phase, float speed, float topSpeed, float acceleration, float distance, ShapingPhasePlan& result) const noexcept;
+	void StoreCachedPlan(ShapingPhase phase, float speed, float topSpeed, float acceleration, float distance, const ShapingPhasePlan& phasePlan) const noexcept;
+	void ClearShapingCache() noexcept;
+#endif
 
 	static constexpr unsigned int MaxExtraImpulses = 4;
 	static constexpr float DefaultFrequency = 40.0;
@@ -94,6 +144,14 @@ private:
 	float overlappedDeltaVPerA;							// the effective acceleration time (velocity change per unit acceleration) when we use overlapping, in step clocks
 	float overlappedDistancePerA;						// the distance needed by an overlapped acceleration or deceleration, less the initial velocity contribution
 	InputShaperType type;
+
+#if INPUT_SHAPING_CACHE_ENTRIES
+	// The plan cache is updated by PlanShaping, which is only ever called from the Move task
+	mutable ShapingCacheEntry shapingCache[INPUT_SHAPING_CACHE_ENTRIES];
+	mutable uint32_t shapingCacheClock;
+	mutable uint32_t shapingCacheHits;
+	mutable uint32_t shapingCacheMisses;
+#endif
 };
 
 #endif /* SRC_MOVEMENT_AXISSHAPER_H_ */
@@ -94,6 +94,7 @@ GridDefinition::GridDefinition() noexcept : radius(-1.0), isValid(false)
 
 	nums[0] = nums[1] = 0;
 	recipAxisSpacings[0] = recipAxisSpacings[1] = 0.0;
+	interpolationLimits[0] = interpolationLimits[1] = 0.0;
 }
 
 // Set the grid parameters ands return true if it is now valid
@@ -150,6 +151,11 @@ void GridDefinition::CheckValidity(bool setNum0Num1) noexcept
 			axisNumbers[1] = axis1NumForLetter;
 			recipAxisSpacings[0] = 1.0/spacings[0];
 			recipAxisSpacings[1] = 1.0/spacings[1];
+
+			// Clamp interpolation to just inside the last grid point so that the cell to the right of or above the point always exists
+			const float fEPSILON = 0.01;
+			interpolationLimits[0] = GetCoordinate(0, nums[0] - 1) - fEPSILON;
+			interpolationLimits[1] = GetCoordinate(1, nums[1] - 1) - fEPSILON;
 		}
 	}
 }
@@ -573,17 +579,11 @@ float HeightMap::GetInterpolatedHeightError(float axis0, float axis1) const noex
 		return 0.0;
 	}
 
-	// Last grid point
-	const float xLast = def.mins[0] + (def.nums[0]-1)*def.spacings[0];
-	const float yLast = def.mins[1] + (def.nums[1]-1)*def.spacings[1];
-
-	// Clamp to rectangle so InterpolateXY will always have valid parameters
-	const float fEPSILON = 0.01;
+	// Clamp to rectangle so InterpolateAxis0Axis1 will always have valid parameters
 	if (axis0 < def.mins[0]) { axis0 = def.mins[0]; }
 	if (axis1 < def.mins[1]) { axis1 = def.mins[1]; }
-	if (axis0 > xLast -fEPSILON) { axis0 = xLast -fEPSILON; }
-	if (axis1 > yLast -fEPSILON) { axis1 = yLast -fEPSILON; }
-
+	if (axis0 > def.interpolationLimits[0]) { axis0 = def.interpolationLimits[0]; }
+	if (axis1 > def.interpolationLimits[1]) { axis1 = def.interpolationLimits[1]; }
 
 	const float xf = (axis0 - def.mins[0]) * def.recipAxisSpacings[0];
 	const float xFloor = floor(xf);
@@ -602,11 +602,10 @@ float HeightMap::InterpolateAxis0Axis1(uint32_t axis0Index, uint32_t axis1Index,
 	const uint32_t indexX0Y1 = indexX0Y0 + def.nums[0];				// (X0 Y1)
 	const uint32_t indexX1Y1 = indexX0Y1 + 1;						// (X1,Y1)
 
-	const float xyFrac = axis0Frac * axis1Frac;
-	return (gridHeights[indexX0Y0] * (1.0 - axis0Frac - axis1Frac + xyFrac))
-			+ (gridHeights[indexX1Y0] * (axis0Frac - xyFrac))
-			+ (gridHeights[indexX0Y1] * (axis1Frac - xyFrac))
-			+ (gridHeights[indexX1Y1] * xyFrac);
+	// Interpolate along axis 0 on both edges of the cell, then along axis 1 between them. This needs only three multiplications.
+	const float heightY0 = gridHeights[indexX0Y0] + (gridHeights[indexX1Y0] - gridHeights[indexX0Y0]) * axis0Frac;
+	const float heightY1 = gridHeights[indexX0Y1] + (gridHeights[indexX1Y1] - gridHeights[indexX0Y1]) * axis0Frac;
+	return heightY0 + (heightY1 - heightY0) * axis1Frac;
 }
 
 void HeightMap::ExtrapolateMissing() noexcept
@@ -64,6 +64,7 @@ private:
 	uint8_t axisNumbers[2];											// Axis numbers for this grid
 	uint32_t nums[2];												// Number of probe points in each direction
 	float recipAxisSpacings[2];										// Reciprocals of the axis spacings
+	float interpolationLimits[2];									// Upper limits of the coordinates we interpolate at, just below the last grid point on each axis
 	bool isValid;
 };
 
@@ -10,6 +10,7 @@
 #include <Platform/Platform.h>
 #include "Move.h"
 #include "StepTimer.h"
+#include "MoveTrace.h"
 #include <Endstops/EndstopsManager.h>
 #include "Kinematics/LinearDeltaKinematics.h"
 #include <Tools/Tool.h>
@@ -145,6 +146,7 @@ DDA::DDA(DDA* n) noexcept : next(n), prev(nullptr), state(empty)
 	activeDMs = completedDMs = nullptr;
 	shapedSegments = unshapedSegments = nullptr;
 	tool = nullptr;						// needed in case we pause before any moves have been done
+	movesRepresented = 1;
 
 	// Set the endpoints to zero, because Move will ask for them.
 	// They will be wrong if we are on a delta. We take care of that when we process the M665 command in config.g.
@@ -218,6 +220,52 @@ inline void DDA::InsertDM(DriveMovement *dm) noexcept
 	*dmp = dm;
 }
 
+// Add a DM to a chain that is kept in step-time order. Drives that step in lockstep (e.g. multiple Z motors) have equal step times, so usually the DM goes on the end.
+inline void DDA::AddToSortedChain(DriveMovement *&head, DriveMovement *&tail, DriveMovement *dm) noexcept
+{
+	if (head == nullptr || tail->nextStepTime <= dm->nextStepTime)
+	{
+		dm->nextDM = nullptr;
+		if (head == nullptr)
+		{
+			head = dm;
+		}
+		else
+		{
+			tail->nextDM = dm;
+		}
+		tail = dm;
+	}
+	else
+	{
+		DriveMovement **dmp = &head;
+		while ((*dmp)->nextStepTime <= dm->nextStepTime)
+		{
+			dmp = &((*dmp)->nextDM);
+		}
+		dm->nextDM = *dmp;
+		*dmp = dm;
+	}
+}
+
+// Merge a chain of DMs that is in step-time order into the active list in a single pass, instead of searching the active list once per DM
+inline void DDA::MergeDMs(DriveMovement *chain) noexcept
+{
+	DriveMovement **dmp = &activeDMs;
+	while (chain != nullptr)
+	{
+		while (*dmp != nullptr && (*dmp)->nextStepTime < chain->nextStepTime)
+		{
+			dmp = &((*dmp)->nextDM);
+		}
+		DriveMovement * const nextInChain = chain->nextDM;
+		chain->nextDM = *dmp;
+		*dmp = chain;
+		dmp = &(chain->nextDM);
+		chain = nextInChain;
+	}
+}
+
 // Remove this drive from the list of drives with steps due and put it in the completed list
 // Called from the step ISR only.
 void DDA::DeactivateDM(size_t drive) noexcept
@@ -312,7 +360,21 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 	const Move& move = reprap.GetMove();
 	if (doMotorMapping)
 	{
-		if (!move.CartesianToMotorSteps(nextMove.coords, endPoint, nextMove.isCoordinated))		// transform the axis coordinates if on a delta or CoreXY printer
+		// Retractions and primes are very frequent, so if none of the visible axes has moved we avoid the kinematic transformation and keep the motor positions
+		bool axesUnchanged = prev->flags.endCoordinatesValid;
+		for (size_t axis = 0; axesUnchanged && axis < numVisibleAxes; ++axis)
+		{
+			axesUnchanged = (nextMove.coords[axis] == prev->endCoordinates[axis]);
+		}
+
+		if (axesUnchanged)
+		{
+			for (size_t axis = 0; axis < numVisibleAxes; ++axis)
+			{
+				endPoint[axis] = positionNow[axis];
+			}
+		}
+		else if (!move.CartesianToMotorSteps(nextMove.coords, endPoint, nextMove.isCoordinated))		// transform the axis coordinates if on a delta or CoreXY printer
 		{
 			return false;												// throw away the move if it couldn't be transformed
 		}
@@ -543,7 +605,9 @@ bool DDA::InitStandardMove(DDARing& ring, const RawMove &nextMove, bool doMotorM
 		// Try to meld this move to the previous move to avoid stop/start
 		// Assuming that this move ends with zero speed, calculate the maximum possible starting speed: u^2 = v^2 - 2as
 		prev->beforePrepare.targetNextSpeed = min<float>(fastSqrtf(deceleration * totalDistance * 2.0), requestedSpeed);
+		const uint32_t lookaheadStartTime = StepTimer::GetTimerTicks();
 		DoLookahead(ring, prev);
+		ring.RecordLookaheadTime(StepTimer::GetTimerTicks() - lookaheadStartTime);
 		startSpeed = prev->endSpeed;
 	}
 	else
@@ -936,6 +1000,8 @@ pre(state == provisional)
 {
 //	if (reprap.Debug(moduleDda)) debugPrintf("Adjusting, %f\n", laDDA->targetNextSpeed);
 	unsigned int laDepth = 0;
+	unsigned int maxDepth = 0;
+	unsigned int numRecalcs = 0;
 	bool goingUp = true;
 
 	for(;;)					// this loop is used to nest lookahead without making recursive calls
@@ -958,8 +1024,12 @@ pre(state == provisional)
 					)
 			{
 				const DDAState st = laDDA->prev->state;
+				const float maxStartSpeed = fastSqrtf(fsquare(laDDA->beforePrepare.targetNextSpeed) + (2 * laDDA->deceleration * laDDA->totalDistance));
+				const float prevTargetSpeed = min<float>(maxStartSpeed, laDDA->requestedSpeed);
 				// This is a deceleration-only move, and the previous one has a deceleration phase. We may have to adjust the previous move as well to get optimum behaviour.
+				// If the previous move already ends at the speed we would ask for, the junction is at its limit and there is no point in going further back.
 				if (   st == provisional
+					&& laDDA->prev->endSpeed < prevTargetSpeed
 					&& (   reprap.GetMove().GetJerkPolicy() != 0
 						|| (   laDDA->prev->flags.xyMoving == laDDA->flags.xyMoving
 							&& (   laDDA->prev->flags.isPrintingMove == laDDA->flags.isPrintingMove
@@ -970,8 +1040,7 @@ pre(state == provisional)
 				   )
 				{
 					laDDA->MatchSpeeds();
-					const float maxStartSpeed = fastSqrtf(fsquare(laDDA->beforePrepare.targetNextSpeed) + (2 * laDDA->deceleration * laDDA->totalDistance));
-					laDDA->prev->beforePrepare.targetNextSpeed = min<float>(maxStartSpeed, laDDA->requestedSpeed);
+					laDDA->prev->beforePrepare.targetNextSpeed = prevTargetSpeed;
 					// leave 'goingUp' true
 				}
 				else
@@ -981,6 +1050,10 @@ pre(state == provisional)
 					{
 						laDDA->flags.hadLookaheadUnderrun = true;
 					}
+					else if (st == provisional && laDDA->prev->endSpeed >= prevTargetSpeed)
+					{
+						ring.RecordLookaheadEarlyStop();
+					}
 					const float maxReachableSpeed = fastSqrtf(fsquare(laDDA->startSpeed) + (2 * laDDA->deceleration * laDDA->totalDistance));
 					if (laDDA->beforePrepare.targetNextSpeed > maxReachableSpeed)
 					{
@@ -1021,6 +1094,10 @@ pre(state == provisional)
 			// Still going up
 			laDDA = laDDA->prev;
 			++laDepth;
+			if (laDepth > maxDepth)
+			{
+				maxDepth = laDepth;
+			}
 #if 0
 			if (reprap.Debug(moduleDda))
 			{
@@ -1052,9 +1129,11 @@ pre(state == provisional)
 			}
 LA_DEBUG;
 			laDDA->RecalculateMove(ring);
+			++numRecalcs;
 
 			if (laDepth == 0)
 			{
+				ring.RecordLookahead(maxDepth, numRecalcs);
 #if 0
 				if (reprap.Debug(moduleDda))
 				{
@@ -1135,6 +1214,7 @@ float DDA::AdvanceBabyStepping(DDARing& ring, size_t axis, float amount) noexcep
 // This may cause a move that we intended to be a deceleration-only move to have a tiny acceleration segment at the start
 void DDA::RecalculateMove(DDARing& ring) noexcept
 {
+	MoveTrace::Record(MoveTrace::Event::recalculate, reinterpret_cast<uint32_t>(this));
 	const float twoA = 2 * acceleration;
 	const float twoD = 2 * deceleration;
 	beforePrepare.accelDistance = (fsquare(requestedSpeed) - fsquare(startSpeed))/twoA;
@@ -1224,15 +1304,57 @@ void DDA::RecalculateMove(DDARing& ring) noexcept
 // Decide what speed we would really like this move to end at.
 // On entry, targetNextSpeed is the speed we would like the next move after this one to start at and this one to end at
 // On return, targetNextSpeed is the actual speed we can achieve without exceeding the jerk limits.
+// If a junction deviation has been configured, the speed change of the linear axes is limited by the angle between the two moves instead of by the axis jerk limits.
+// This lets finely segmented curves be printed at speed, while still slowing down for sharp corners.
 void DDA::MatchSpeeds() noexcept
 {
+	const Platform& p = reprap.GetPlatform();
+	const float junctionDeviation = reprap.GetMove().GetJunctionDeviation();
+	const AxesBitmap linearAxes = p.GetLinearAxes();
+	bool linearAxesJerkLimited = true;
+	if (junctionDeviation > 0.0)
+	{
+		float dotProduct = 0.0, thisSquared = 0.0, nextSquared = 0.0;
+		linearAxes.Iterate([this, &dotProduct, &thisSquared, &nextSquared](unsigned int axis, unsigned int) noexcept
+							{
+								dotProduct += directionVector[axis] * next->directionVector[axis];
+								thisSquared += fsquare(directionVector[axis]);
+								nextSquared += fsquare(next->directionVector[axis]);
+							}
+						  );
+		if (thisSquared > 0.0 && nextSquared > 0.0)
+		{
+			// Both moves have linear axis movement. Fit a circular arc of the specified deviation to the corner and limit the speed to that at which it can be followed.
+			// If sinHalfTheta is the sine of half the angle between the reversed direction of this move and the direction of the next one,
+			// the radius of the arc is junctionDeviation * sinHalfTheta/(1 - sinHalfTheta) and the limiting speed is sqrt(acceleration * radius).
+			// If the moves are collinear (cosTheta is -1) then the radius is infinite and there is no limit.
+			const float cosTheta = -dotProduct/fastSqrtf(thisSquared * nextSquared);
+			if (cosTheta > -0.999999)
+			{
+				const float sinHalfTheta = fastSqrtf(0.5 * (1.0 - cosTheta));
+				const float maxJunctionSpeed = (sinHalfTheta < 0.001)
+												? 0.0
+												: fastSqrtf(min<float>(deceleration, next->acceleration) * junctionDeviation * sinHalfTheta/(1.0 - sinHalfTheta));
+				if (beforePrepare.targetNextSpeed > maxJunctionSpeed)
+				{
+					beforePrepare.targetNextSpeed = maxJunctionSpeed;
+				}
+			}
+			linearAxesJerkLimited = false;
+		}
+	}
+
 	for (size_t drive = 0; drive < MaxAxesPlusExtruders; ++drive)
 	{
+		if (!linearAxesJerkLimited && drive < MaxAxes && linearAxes.IsBitSet(drive))
+		{
+			continue;
+		}
 		if (directionVector[drive] != 0.0 || next->directionVector[drive] != 0.0)
 		{
 			const float totalFraction = fabsf(directionVector[drive] - next->directionVector[drive]);
 			const float jerk = totalFraction * beforePrepare.targetNextSpeed;
-			const float allowedJerk = reprap.GetPlatform().GetInstantDv(drive);
+			const float allowedJerk = p.GetInstantDv(drive);
 			if (jerk > allowedJerk)
 			{
 				beforePrepare.targetNextSpeed = allowedJerk/totalFraction;
@@ -1312,6 +1434,7 @@ void DDA::EnsureUnshapedSegments(const PrepParams& params) noexcept
 // This must not be called with interrupts disabled, because it calls Platform::EnableDrive.
 void DDA::Prepare(SimulationMode simMode) noexcept
 {
+	MoveTrace::Record(MoveTrace::Event::prepare, reinterpret_cast<uint32_t>(this));
 	flags.wasAccelOnlyMove = IsAccelerationMove();			// save this for the next move to look at
 
 #if SUPPORT_LASER
@@ -1644,6 +1767,7 @@ void DDA::Prepare(SimulationMode simMode) noexcept
 
 #if SUPPORT_CAN_EXPANSION
 		const uint32_t canClocksNeeded = CanMotion::FinishMovement(*this, afterPrepare.moveStartTime, simMode != SimulationMode::off);
+		MoveTrace::Record(MoveTrace::Event::canSend, canClocksNeeded);
 		if (canClocksNeeded > clocksNeeded)
 		{
 			// Due to rounding error in the calculations, we quite often calculate the CAN move as being longer than our previously-calculated value, normally by just one clock.
@@ -1816,6 +1940,10 @@ void DDA::CheckEndstops(Platform& platform) noexcept
 	for (;;)
 	{
 		const EndstopHitDetails hitDetails = platform.GetEndstops().CheckEndstops();
+		if (hitDetails.GetAction() != EndstopHitAction::none)
+		{
+			MoveTrace::Record(MoveTrace::Event::endstopHit, hitDetails.axis | ((uint32_t)hitDetails.driver.localDriver << 8));
+		}
 		switch (hitDetails.GetAction())
 		{
 		case EndstopHitAction::stopAll:
@@ -1894,6 +2022,7 @@ pre(state == frozen)
 		afterPrepare.moveStartTime = tim;			// this move is late starting, so record the actual start time
 	}
 	state = executing;
+	MoveTrace::Record(MoveTrace::Event::start, reinterpret_cast<uint32_t>(this));
 
 #if DDA_LOG_PROBE_CHANGES
 	if ((endStopsToCheck & LogProbeChanges) != 0)
@@ -2028,7 +2157,15 @@ void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 
 	uint32_t driversStepping = 0;
 	DriveMovement* dm = activeDMs;
+#if SUPPORT_STEP_EDGE_BUFFER
+	// If we are queueing step edges then we calculate steps ahead of time, except when checking endstops because we might need to stop immediately.
+	// If the queue is too full to hold all the edges we might generate then we step the drivers directly instead, which flushes the queue first.
+	const bool bufferEdges = !flags.checkEndstops && StepEdgeBuffer::CanQueueStep();
+	const uint32_t elapsedTime = (now - afterPrepare.moveStartTime) + StepTimer::MinInterruptInterval + ((bufferEdges) ? StepEdgeBuffer::LeadTime : 0);
+	const uint32_t stepTime = (dm != nullptr) ? dm->nextStepTime + afterPrepare.moveStartTime : now;
+#else
 	const uint32_t elapsedTime = (now - afterPrepare.moveStartTime) + StepTimer::MinInterruptInterval;
+#endif
 #if 0	//DEBUG
 	if (dm != nullptr && elapsedTime >= dm->nextStepTime)
 	{
@@ -2077,6 +2214,19 @@ void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 		(void)dm2->CalcNextStepTime(*this);							// calculate next step times
 	}
 #else
+# if SUPPORT_STEP_EDGE_BUFFER
+	if (bufferEdges)
+	{
+		StepEdgeBuffer::AddSteps(stepTime, driversStepping);		// queue the step pulses for output when they are due
+		for (DriveMovement *dm2 = activeDMs; dm2 != dm; dm2 = dm2->nextDM)
+		{
+			(void)dm2->CalcNextStepTime(*this);						// calculate next step times
+		}
+	}
+	else
+	{
+		StepEdgeBuffer::Flush();									// we are about to write the step pins directly, so output any queued edges first to keep them in order
+# endif
 # if SUPPORT_SLOW_DRIVERS											// if supporting slow drivers
 	if ((driversStepping & p.GetSlowDriversBitmap()) != 0)			// if using some slow drivers
 	{
@@ -2113,21 +2263,35 @@ void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 
 		StepPins::StepDriversLow(driversStepping);					// step drivers low
 	}
+# if SUPPORT_STEP_EDGE_BUFFER
+	}
+# endif
 #endif
 
 	// Remove those drives from the list, update the direction pins where necessary, and re-insert them so as to keep the list in step-time order.
+	// We sort the drives that are still moving into a separate chain first, so that we only need to walk the rest of the active list once.
 	DriveMovement *dmToInsert = activeDMs;							// head of the chain we need to re-insert
 	activeDMs = dm;													// remove the chain from the list
+	DriveMovement *sortedHead = nullptr, *sortedTail = nullptr;
 	while (dmToInsert != dm)										// note that both of these may be nullptr
 	{
 		DriveMovement * const nextToInsert = dmToInsert->nextDM;
 		if (dmToInsert->state >= DMState::firstMotionState)
 		{
-			InsertDM(dmToInsert);
+			AddToSortedChain(sortedHead, sortedTail, dmToInsert);
 			if (dmToInsert->directionChanged)
 			{
 				dmToInsert->directionChanged = false;
-				p.SetDirection(dmToInsert->drive, dmToInsert->direction);
+#if SUPPORT_STEP_EDGE_BUFFER
+				if (bufferEdges)
+				{
+					StepEdgeBuffer::AddDirection(stepTime, dmToInsert->drive, dmToInsert->direction);		// this will be output straight after the step pulses
+				}
+				else
+#endif
+				{
+					p.SetDirection(dmToInsert->drive, dmToInsert->direction);
+				}
 			}
 		}
 		else
@@ -2137,6 +2301,7 @@ void DDA::StepDrivers(Platform& p, uint32_t now) noexcept
 		}
 		dmToInsert = nextToInsert;
 	}
+	MergeDMs(sortedHead);
 
 	// If there are no more steps to do and the time for the move has nearly expired, flag the move as complete
 	if (activeDMs == nullptr)
@@ -2183,12 +2348,13 @@ void DDA::SimulateSteppingDrivers(Platform& p) noexcept
 		// Remove those drives from the list, update the direction pins where necessary, and re-insert them so as to keep the list in step-time order.
 		DriveMovement *dmToInsert = activeDMs;							// head of the chain we need to re-insert
 		activeDMs = dm;													// remove the chain from the list
+		DriveMovement *sortedHead = nullptr, *sortedTail = nullptr;
 		while (dmToInsert != dm)										// note that both of these may be nullptr
 		{
 			DriveMovement * const nextToInsert = dmToInsert->nextDM;
 			if (dmToInsert->state >= DMState::firstMotionState)
 			{
-				InsertDM(dmToInsert);
+				AddToSortedChain(sortedHead, sortedTail, dmToInsert);
 				if (dmToInsert->directionChanged)
 				{
 					dmToInsert->directionChanged = false;
@@ -2201,6 +2367,7 @@ void DDA::SimulateSteppingDrivers(Platform& p) noexcept
 			}
 			dmToInsert = nextToInsert;
 		}
+		MergeDMs(sortedHead);
 	}
 
 	// If there are no more steps to do and the time for the move has nearly expired, flag the move as complete
@@ -2402,26 +2569,29 @@ uint32_t DDA::ManageLaserPower() const noexcept
 		return LaserPwmIntervalMillis;
 	}
 
-	const float accelSpeed = startSpeed + acceleration * clocksMoving;
-	if (accelSpeed < topSpeed)
+	// During acceleration and deceleration we set the power for the speed half way through the interval until we are next called,
+	// so that the average power over that interval matches the average speed instead of lagging it
+	constexpr uint32_t HalfLaserPwmIntervalClocks = (LaserPwmIntervalMillis * StepClockRate)/2000;
+	if (startSpeed + acceleration * clocksMoving < topSpeed)
 	{
 		// Acceleration phase
+		const float accelSpeed = min<float>(startSpeed + acceleration * (clocksMoving + HalfLaserPwmIntervalClocks), topSpeed);
 		const Pwm_t pwm = (Pwm_t)((accelSpeed/topSpeed) * laserPwmOrIoBits.laserPwm);
 		platform.SetLaserPwm(pwm);
 		return LaserPwmIntervalMillis;
 	}
 
 	const uint32_t clocksLeft = clocksNeeded - clocksMoving;
-	const float decelSpeed = endSpeed + deceleration * clocksLeft;
-	if (decelSpeed < topSpeed)
+	if (endSpeed + deceleration * clocksLeft < topSpeed)
 	{
 		// Deceleration phase
+		const float decelSpeed = (clocksLeft > HalfLaserPwmIntervalClocks) ? endSpeed + deceleration * (clocksLeft - HalfLaserPwmIntervalClocks) : endSpeed;
 		const Pwm_t pwm = (Pwm_t)((decelSpeed/topSpeed) * laserPwmOrIoBits.laserPwm);
 		platform.SetLaserPwm(pwm);
 		return LaserPwmIntervalMillis;
 	}
 
-	// We must be in the constant speed phase
+	// We must be in the constant speed phase. Ask to be called again when deceleration starts, not an interval later, so that we don't burn the corner.
 	platform.SetLaserPwm(laserPwmOrIoBits.laserPwm);
 	const uint32_t decelClocks = (topSpeed - endSpeed)/deceleration;
 	if (clocksLeft <= decelClocks)
@@ -2429,7 +2599,7 @@ uint32_t DDA::ManageLaserPower() const noexcept
 		return LaserPwmIntervalMillis;
 	}
 	const uint32_t clocksToDecel = clocksLeft - decelClocks;
-	return lrintf((float)clocksToDecel * StepClocksToMillis) + LaserPwmIntervalMillis;
+	return max<uint32_t>(lrintf((float)clocksToDecel * StepClocksToMillis), 1);		// must not return zero because that means wait for the next move
 }
 
 #endif
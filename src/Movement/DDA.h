@@ -13,9 +13,16 @@
 #include "StepTimer.h"
 #include "MoveSegment.h"
 #include "InputShaperPlan.h"
+#include "StepEdgeBuffer.h"
 #include <Platform/Tasks.h>
 #include <GCodes/GCodes.h>			// for class RawMove
 
+// Set STEP_BATCH_WINDOW_MICROSECONDS to a nonzero value to make the step ISR wait for the next step if it is due within that time, instead of returning and taking another interrupt.
+// This saves the interrupt entry/exit and timer scheduling overhead when step rates are very high, e.g. when using 256x microstepping.
+#ifndef STEP_BATCH_WINDOW_MICROSECONDS
+# define STEP_BATCH_WINDOW_MICROSECONDS	(0)
+#endif
+
 #ifdef DUET_NG
 # define DDA_LOG_PROBE_CHANGES	0
 #else
@@ -66,8 +73,15 @@ struct PrepParams
 	void SetFromDDA(const DDA& dda) noexcept;
 };
 
+// Alignment of DDA objects. On processors with a data cache we align them to a cache line, so that the fields used when scheduling step interrupts share one line.
+#if SAME70
+constexpr size_t DdaAlignment = 32;
+#else
+constexpr size_t DdaAlignment = alignof(uint32_t);
+#endif
+
 // This defines a single coordinated movement of one or several motors
-class DDA
+class alignas(DdaAlignment) DDA
 {
 	friend class DriveMovement;
 	friend class AxisShaper;
@@ -102,6 +116,9 @@ public:
 	void StepDrivers(Platform& p, uint32_t now) noexcept SPEED_CRITICAL;			// Take one step of the DDA, called by timer interrupt.
 	void SimulateSteppingDrivers(Platform& p) noexcept;								// For debugging use
 	bool ScheduleNextStepInterrupt(StepTimer& timer) const noexcept SPEED_CRITICAL;	// Schedule the next interrupt, returning true if we can't because it is already due
+#if STEP_BATCH_WINDOW_MICROSECONDS
+	bool WaitForNextStep(StepTimer& timer, uint32_t isrStartTime) const noexcept SPEED_CRITICAL;	// Wait for the next step if it is due very soon
+#endif
 
 	void SetNext(DDA *n) noexcept { next = n; }
 	void SetPrevious(DDA *p) noexcept { prev = p; }
@@ -149,6 +166,8 @@ public:
 	float GetVirtualExtruderPosition() const noexcept { return virtualExtruderPosition; }
 	float AdvanceBabyStepping(DDARing& ring, size_t axis, float amount) noexcept;	// Try to push babystepping earlier in the move queue
 	const Tool *GetTool() const noexcept { return tool; }
+	uint32_t GetMovesRepresented() const noexcept { return movesRepresented; }
+	void SetMovesRepresented(uint32_t n) noexcept { movesRepresented = n; }
 	float GetTotalDistance() const noexcept { return totalDistance; }
 	void LimitSpeedAndAcceleration(float maxSpeed, float maxAcceleration) noexcept;	// Limit the speed an acceleration of this move
 
@@ -216,11 +235,18 @@ public:
 	static constexpr uint32_t HiccupTime = (40 * StepClockRate)/1000000;					// how long we hiccup for in step timer clocks
 #endif
 	static constexpr uint32_t MaxStepInterruptTime = 10 * StepTimer::MinInterruptInterval;	// the maximum time we spend looping in the ISR , in step clocks
+#if STEP_BATCH_WINDOW_MICROSECONDS
+	static constexpr uint32_t StepBatchWindow = (STEP_BATCH_WINDOW_MICROSECONDS * StepClockRate)/1000000;	// if the next step is due within this time then we wait for it in the ISR
+	static_assert(StepBatchWindow < MaxStepInterruptTime);
+#endif
 	static constexpr uint32_t WakeupTime = (100 * StepClockRate)/1000000;					// stop resting 100us before the move is due to end
 	static constexpr uint32_t HiccupIncrement = HiccupTime/2;								// how much we increase the hiccup time by on each attempt
 
 	static constexpr uint32_t UsualMinimumPreparedTime = StepClockRate/10;					// 100ms
 	static constexpr uint32_t AbsoluteMinimumPreparedTime = StepClockRate/20;				// 50ms
+#if SUPPORT_CAN_EXPANSION
+	static constexpr uint32_t MinimumAdaptivePreparedTime = StepClockRate/15;				// 67ms, the least prepare-ahead time we use when it is adjusted to suit the CAN latency
+#endif
 
 #if DDA_LOG_PROBE_CHANGES
 	static const size_t MaxLoggedProbePositions = 40;
@@ -245,6 +271,8 @@ private:
 	void MatchSpeeds() noexcept SPEED_CRITICAL;
 	void StopDrive(size_t drive) noexcept;									// stop movement of a drive and recalculate the endpoint
 	void InsertDM(DriveMovement *dm) noexcept SPEED_CRITICAL;
+	void MergeDMs(DriveMovement *chain) noexcept SPEED_CRITICAL;
+	static void AddToSortedChain(DriveMovement *&head, DriveMovement *&tail, DriveMovement *dm) noexcept SPEED_CRITICAL;
 	void DeactivateDM(size_t drive) noexcept;
 	void ReleaseDMs() noexcept;
 	bool IsDecelerationMove() const noexcept;								// return true if this move is or have been might have been intended to be a deceleration-only move
@@ -267,6 +295,8 @@ private:
     static void Scale(float v[], float scale) noexcept;						// Multiply a vector by a scalar
     static float VectorBoxIntersection(const float v[], const float box[]) noexcept;	// Compute the length that a vector would have to have to just touch the surface of a hyperbox of MaxAxesPlusExtruders dimensions.
 
+	// The fields below are ordered so that those read by ScheduleNextStepInterrupt, DDARing::StartNextMove and the step ISR come first.
+	// On processors with a data cache they then share a single cache line when the DDA is aligned to DdaAlignment.
     DDA *next;										// The next one in the ring
 	DDA *prev;										// The previous one in the ring
 
@@ -298,31 +328,8 @@ private:
 		uint16_t all;								// so that we can print all the flags at once for debugging
 	} flags;
 
-#if SUPPORT_LASER || SUPPORT_IOBITS
-	LaserPwmOrIoBits laserPwmOrIoBits;				// laser PWM required or port state required during this move (here because it is currently 16 bits)
-#endif
-
-	const Tool *tool;								// which tool (if any) is active
-
-    FilePosition filePos;							// The position in the SD card file after this move was read, or zero if not read from SD card
-
-	int32_t endPoint[MaxAxesPlusExtruders];  		// Machine coordinates of the endpoint
-	float endCoordinates[MaxAxesPlusExtruders];		// The Cartesian coordinates at the end of the move plus extrusion amounts
-	float directionVector[MaxAxesPlusExtruders];	// The normalised direction vector - first 3 are XYZ Cartesian coordinates even on a delta
-    float totalDistance;							// How long is the move in hypercuboid space
-	float acceleration;								// The acceleration to use
-	float deceleration;								// The deceleration to use
-    float requestedSpeed;							// The speed that the user asked for
-    float virtualExtruderPosition;					// the virtual extruder position at the end of this move, used for pause/resume
-
-    // These vary depending on how we connect the move with its predecessor and successor, but remain constant while the move is being executed
-	float startSpeed;
-	float endSpeed;
-	float topSpeed;
-
-	float proportionDone;							// what proportion of the extrusion in the G1 or G0 move of which this is a part has been done after this segment is complete
-	float initialUserC0, initialUserC1;				// if this is a segment of an arc move, the user X and Y coordinates at the start
 	uint32_t clocksNeeded;
+	DriveMovement* activeDMs;						// list of associated DMs that need steps, in step time order
 
 	union
 	{
@@ -348,17 +355,42 @@ private:
 		} afterPrepare;
 	};
 
+	DriveMovement* completedDMs;					// list of associated DMs that don't need any more steps
+	MoveSegment* shapedSegments;					// linked list of move segments used by axis DMs
+	MoveSegment* unshapedSegments;					// linked list of move segments used by extruder DMs
+
+    // These vary depending on how we connect the move with its predecessor and successor, but remain constant while the move is being executed
+	float startSpeed;
+	float endSpeed;
+	float topSpeed;
+
+	// The remaining fields are used only when the move is being set up, and by pause/resume and status reporting
+#if SUPPORT_LASER || SUPPORT_IOBITS
+	LaserPwmOrIoBits laserPwmOrIoBits;				// laser PWM required or port state required during this move (here because it is currently 16 bits)
+#endif
+
+	const Tool *tool;								// which tool (if any) is active
+	uint32_t movesRepresented;						// how many moves scheduled by GCodes this DDA executes, more than 1 if queued moves were merged into it
+
+    FilePosition filePos;							// The position in the SD card file after this move was read, or zero if not read from SD card
+
+    float totalDistance;							// How long is the move in hypercuboid space
+	float acceleration;								// The acceleration to use
+	float deceleration;								// The deceleration to use
+    float requestedSpeed;							// The speed that the user asked for
+    float virtualExtruderPosition;					// the virtual extruder position at the end of this move, used for pause/resume
+	float proportionDone;							// what proportion of the extrusion in the G1 or G0 move of which this is a part has been done after this segment is complete
+	float initialUserC0, initialUserC1;				// if this is a segment of an arc move, the user X and Y coordinates at the start
+
+	int32_t endPoint[MaxAxesPlusExtruders];  		// Machine coordinates of the endpoint
+	float endCoordinates[MaxAxesPlusExtruders];		// The Cartesian coordinates at the end of the move plus extrusion amounts
+	float directionVector[MaxAxesPlusExtruders];	// The normalised direction vector - first 3 are XYZ Cartesian coordinates even on a delta
+
 #if DDA_LOG_PROBE_CHANGES
 	static bool probeTriggered;
 
 	void LogProbePosition() noexcept;
 #endif
-
-	// These three could possibly be moved into afterPrepare
-	DriveMovement* activeDMs;						// list of associated DMs that need steps, in step time order
-	DriveMovement* completedDMs;					// list of associated DMs that don't need any more steps
-	MoveSegment* shapedSegments;					// linked list of move segments used by axis DMs
-	MoveSegment* unshapedSegments;					// linked list of move segments used by extruder DMs
 };
 
 // Find the DriveMovement record for a given drive even if it is completed, or return nullptr if there isn't one
@@ -414,6 +446,12 @@ inline __attribute__((always_inline)) bool DDA::ScheduleNextStepInterrupt(StepTi
 		if (activeDMs != nullptr)
 		{
 			whenDue = activeDMs->nextStepTime + afterPrepare.moveStartTime;
+#if SUPPORT_STEP_EDGE_BUFFER
+			if (!flags.checkEndstops)
+			{
+				whenDue -= StepEdgeBuffer::LeadTime;								// StepDrivers will queue the edges ahead of time
+			}
+#endif
 		}
 		else if (clocksNeeded > DDA::WakeupTime)
 		{
@@ -429,6 +467,35 @@ inline __attribute__((always_inline)) bool DDA::ScheduleNextStepInterrupt(StepTi
 	return false;
 }
 
+#if STEP_BATCH_WINDOW_MICROSECONDS
+
+// This is called when ScheduleNextStepInterrupt has scheduled an interrupt for the next step.
+// If that step is due within StepBatchWindow and we have time left in this ISR invocation, cancel the interrupt, wait until the step is due and return true.
+// Base priority must be >= NvicPriorityStep when calling this
+inline bool DDA::WaitForNextStep(StepTimer& timer, uint32_t isrStartTime) const noexcept
+{
+	if (state == executing && activeDMs != nullptr)
+	{
+		uint32_t whenDue = activeDMs->nextStepTime + afterPrepare.moveStartTime - StepTimer::MinInterruptInterval;	// StepDrivers generates steps due within MinInterruptInterval
+#if SUPPORT_STEP_EDGE_BUFFER
+		if (!flags.checkEndstops)
+		{
+			whenDue -= StepEdgeBuffer::LeadTime;									// StepDrivers will queue the edges ahead of time
+		}
+#endif
+		const uint32_t now = StepTimer::GetTimerTicks();
+		if ((int32_t)(whenDue - now) < (int32_t)StepBatchWindow && (whenDue - isrStartTime) < MaxStepInterruptTime)
+		{
+			timer.CancelCallbackFromIsr();
+			while ((int32_t)(StepTimer::GetTimerTicks() - whenDue) < 0) { }
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif
+
 // Return true if there is no reason to delay preparing this move
 inline bool DDA::IsGoodToPrepare() const noexcept
 {
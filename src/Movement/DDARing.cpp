@@ -8,6 +8,7 @@
 #include "DDARing.h"
 #include <Platform/RepRap.h>
 #include "Move.h"
+#include "MoveTrace.h"
 #include <Platform/Tasks.h>
 #include <GCodes/GCodeBuffer/GCodeBuffer.h>
 #include <Tools/Tool.h>
@@ -39,6 +40,9 @@ constexpr uint8_t DDARing::objectModelTableDescriptor[] = { 1, 2 };
 DEFINE_GET_OBJECT_MODEL_TABLE(DDARing)
 
 DDARing::DDARing() noexcept : gracePeriod(DefaultGracePeriod), scheduledMoves(0), completedMoves(0), numHiccups(0)
+#if STEP_BATCH_WINDOW_MICROSECONDS
+	, numBatchedSteps(0)
+#endif
 {
 }
 
@@ -70,6 +74,8 @@ void DDARing::Init2() noexcept
 {
 	stepErrors = 0;
 	numLookaheadUnderruns = numPrepareUnderruns = numNoMoveUnderruns = numLookaheadErrors = 0;
+	numLookaheadCalls = numLookaheadRecalcs = maxLookaheadDepth = numLookaheadEarlyStops = 0;
+	numMovesPrepared = prepareClocksTotal = prepareClocksMax = numLookaheadsTimed = lookaheadClocksTotal = lookaheadClocksMax = 0;
 	waitingForRingToEmpty = false;
 
 	// Put the origin on the lookahead ring with default velocity in the previous position to the first one that will be used.
@@ -164,7 +170,9 @@ GCodeResult DDARing::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& re
 	}
 	else
 	{
-		reply.printf("DDAs %u, DMs %u, GracePeriod %" PRIu32, numDdasInRing, DriveMovement::NumCreated(), gracePeriod);
+		reply.printf("DDAs %u (%u bytes), DMs %u (%u bytes), GracePeriod %" PRIu32 ", never used RAM %d",
+						numDdasInRing, numDdasInRing * sizeof(DDA), DriveMovement::NumCreated(), DriveMovement::NumCreated() * sizeof(DriveMovement),
+						gracePeriod, Tasks::GetNeverUsedRam());
 	}
 	return GCodeResult::ok;
 }
@@ -222,12 +230,14 @@ bool DDARing::CanAddMove() const noexcept
 }
 
 // Add a new move, returning true if it represents real movement
-bool DDARing::AddStandardMove(const RawMove &nextMove, bool doMotorMapping) noexcept
+// If moves from the raw move queue were merged into nextMove then numMoves is the total number of moves it represents, so that the move counts used by the code queue stay in step.
+bool DDARing::AddStandardMove(const RawMove &nextMove, bool doMotorMapping, uint32_t numMoves) noexcept
 {
 	if (addPointer->InitStandardMove(*this, nextMove, doMotorMapping))
 	{
+		addPointer->SetMovesRepresented(numMoves);
 		addPointer = addPointer->GetNext();
-		scheduledMoves++;
+		scheduledMoves += numMoves;
 		return true;
 	}
 	return false;
@@ -238,6 +248,7 @@ bool DDARing::AddSpecialMove(float feedRate, const float coords[MaxDriversPerAxi
 {
 	if (addPointer->InitLeadscrewMove(*this, feedRate, coords))
 	{
+		addPointer->SetMovesRepresented(1);
 		addPointer = addPointer->GetNext();
 		scheduledMoves++;
 		return true;
@@ -252,6 +263,7 @@ bool DDARing::AddAsyncMove(const AsyncMove& nextMove) noexcept
 {
 	if (addPointer->InitAsyncMove(*this, nextMove))
 	{
+		addPointer->SetMovesRepresented(1);
 		addPointer = addPointer->GetNext();
 		scheduledMoves++;
 		return true;
@@ -352,8 +364,8 @@ uint32_t DDARing::Spin(SimulationMode simulationMode, bool waitingForSpace, bool
 		if (dda->GetState() == DDA::completed)
 		{
 			// We prepared the move but found there was nothing to do because endstops are already triggered
+			completedMoves += dda->GetMovesRepresented();
 			getPointer = dda = dda->GetNext();
-			completedMoves++;
 		}
 		else if (dda->GetState() == DDA::frozen)
 		{
@@ -406,10 +418,16 @@ uint32_t DDARing::Spin(SimulationMode simulationMode, bool waitingForSpace, bool
 // Return the maximum time in milliseconds that should elapse before we prepare further unprepared moves that are already in the ring, or TaskBase::TimeoutUnlimited if there are no unprepared moves left.
 uint32_t DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, unsigned int alreadyPrepared, SimulationMode simulationMode) noexcept
 {
+#if SUPPORT_CAN_EXPANSION
+	const int32_t preparedTimeTarget = (int32_t)CanMotion::GetPreparedTimeTarget();		// this adapts to the CAN motion message latency
+#else
+	constexpr int32_t preparedTimeTarget = (int32_t)DDA::UsualMinimumPreparedTime;
+#endif
+
 	// If the number of prepared moves will execute in less than the minimum time, prepare another move.
 	// Try to avoid preparing deceleration-only moves too early
 	while (	  firstUnpreparedMove->GetState() == DDA::provisional
-		   && moveTimeLeft < (int32_t)DDA::UsualMinimumPreparedTime		// prepare moves one tenth of a second ahead of when they will be needed
+		   && moveTimeLeft < preparedTimeTarget							// prepare moves up to one tenth of a second ahead of when they will be needed
 		   && alreadyPrepared * 2 < numDdasInRing						// but don't prepare more than half the ring, to handle accelerate/decelerate moves in small segments
 		   && (firstUnpreparedMove->IsGoodToPrepare() || moveTimeLeft < (int32_t)DDA::AbsoluteMinimumPreparedTime)
 #if SUPPORT_CAN_EXPANSION
@@ -417,7 +435,15 @@ uint32_t DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, u
 #endif
 		  )
 	{
+		const uint32_t prepareStartTime = StepTimer::GetTimerTicks();
 		firstUnpreparedMove->Prepare(simulationMode);
+		const uint32_t prepareClocks = StepTimer::GetTimerTicks() - prepareStartTime;
+		++numMovesPrepared;
+		prepareClocksTotal += prepareClocks;
+		if (prepareClocks > prepareClocksMax)
+		{
+			prepareClocksMax = prepareClocks;
+		}
 		moveTimeLeft += firstUnpreparedMove->GetTimeLeft();
 		++alreadyPrepared;
 		firstUnpreparedMove = firstUnpreparedMove->GetNext();
@@ -432,7 +458,7 @@ uint32_t DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, u
 			return 1;
 		}
 
-		const int32_t clocksTillWakeup = moveTimeLeft - (int32_t)DDA::UsualMinimumPreparedTime;						// calculate how long before we run out of prepared moves, less the usual advance prepare time
+		const int32_t clocksTillWakeup = moveTimeLeft - preparedTimeTarget;											// calculate how long before we run out of prepared moves, less the advance prepare time
 		return (clocksTillWakeup <= 0) ? 2 : min<uint32_t>((uint32_t)clocksTillWakeup/(StepClockRate/1000), 2);		// wake up at that time, but delay for at least 2 ticks
 	}
 
@@ -484,7 +510,16 @@ void DDARing::Interrupt(Platform& p) noexcept
 			// Schedule a callback at the time when the next step is due, and quit unless it is due immediately
 			if (!cdda->ScheduleNextStepInterrupt(timer))
 			{
+#if STEP_BATCH_WINDOW_MICROSECONDS
+				// If the next step is due very soon then it is cheaper to wait for it here than to take another interrupt
+				if (!cdda->WaitForNextStep(timer, isrStartTime))
+				{
+					break;
+				}
+				++numBatchedSteps;
+#else
 				break;
+#endif
 			}
 
 			// The next step is due immediately. Check whether we have been in this ISR for too long already and need to take a break
@@ -507,6 +542,7 @@ void DDARing::Interrupt(Platform& p) noexcept
 					// Reschedule the next step interrupt. This time it should succeed if the hiccup time was long enough.
 					if (!cdda->ScheduleNextStepInterrupt(timer))
 					{
+						MoveTrace::Record(MoveTrace::Event::hiccup, hiccupTime);
 #if SUPPORT_CAN_EXPANSION
 						CanMotion::InsertHiccup(cumulativeHiccupTime);
 #endif
@@ -531,6 +567,7 @@ void DDARing::OnMoveCompleted(DDA *cdda, Platform& p) noexcept
 {
 	// The following finish time is wrong if we aborted the move because of endstop or Z probe checks.
 	// However, following a move that checks endstops or the Z probe, we always wait for the move to complete before we schedule another, so this doesn't matter.
+	MoveTrace::Record(MoveTrace::Event::complete, reinterpret_cast<uint32_t>(cdda));
 	const uint32_t finishTime = cdda->GetMoveFinishTime();	// calculate when this move should finish
 	CurrentMoveCompleted();							// tell the DDA ring that the current move is complete
 
@@ -599,7 +636,7 @@ void DDARing::CurrentMoveCompleted() noexcept
 	}
 
 	getPointer = getPointer->GetNext();
-	completedMoves++;
+	completedMoves += cdda->GetMovesRepresented();
 }
 
 // Tell the DDA ring that the caller is waiting for it to empty. Returns true if it is already empty.
@@ -832,14 +869,7 @@ bool DDARing::PauseMoves(RestorePoint& rp) noexcept
 	IrqEnable();
 
 	// We may be going to skip some moves. Get the end coordinate of the previous move.
-	DDA * const prevDda = addPointer->GetPrevious();
-	const size_t numVisibleAxes = reprap.GetGCodes().GetVisibleAxes();
-	for (size_t axis = 0; axis < numVisibleAxes; ++axis)
-	{
-		rp.moveCoords[axis] = prevDda->GetEndCoordinate(axis, false);
-	}
-
-	reprap.GetMove().InverseAxisAndBedTransform(rp.moveCoords, prevDda->GetTool());
+	GetLastMoveEndCoordinates(rp);
 
 #if SUPPORT_LASER || SUPPORT_IOBITS
 	rp.laserPwmOrIoBits = dda->GetLaserPwmOrIoBits();
@@ -864,15 +894,28 @@ bool DDARing::PauseMoves(RestorePoint& rp) noexcept
 	// Free the DDAs for the moves we are going to skip
 	do
 	{
+		scheduledMoves -= dda->GetMovesRepresented();
 		(void)dda->Free();
 		dda = dda->GetNext();
-		scheduledMoves--;
 	}
 	while (dda != savedDdaRingAddPointer);
 
 	return true;
 }
 
+// Set the restore point coordinates to the end coordinates of the move before addPointer, converted to user coordinates
+void DDARing::GetLastMoveEndCoordinates(RestorePoint& rp) noexcept
+{
+	DDA * const prevDda = addPointer->GetPrevious();
+	const size_t numVisibleAxes = reprap.GetGCodes().GetVisibleAxes();
+	for (size_t axis = 0; axis < numVisibleAxes; ++axis)
+	{
+		rp.moveCoords[axis] = prevDda->GetEndCoordinate(axis, false);
+	}
+
+	reprap.GetMove().InverseAxisAndBedTransform(rp.moveCoords, prevDda->GetTool());
+}
+
 #if HAS_VOLTAGE_MONITOR || HAS_STALL_DETECT
 
 // Pause the print immediately, returning true if we were able to
@@ -897,8 +940,8 @@ bool DDARing::LowPowerOrStallPause(RestorePoint& rp) noexcept
 #endif
 		dda->MoveAborted();
 		CurrentMoveCompleted();							// updates live endpoints, extrusion, ddaRingGetPointer, currentDda etc.
-		--completedMoves;								// this move wasn't really completed
-		--scheduledMoves;								// ...but it is no longer scheduled either
+		completedMoves -= dda->GetMovesRepresented();	// this move wasn't really completed
+		scheduledMoves -= dda->GetMovesRepresented();	// ...but it is no longer scheduled either
 		abortedMove = true;
 	}
 	else
@@ -953,8 +996,8 @@ bool DDARing::LowPowerOrStallPause(RestorePoint& rp) noexcept
 	// Free the DDAs for the moves we are going to skip
 	for (dda = addPointer; dda != savedDdaRingAddPointer; dda = dda->GetNext())
 	{
+		scheduledMoves -= dda->GetMovesRepresented();
 		(void)dda->Free();
-		scheduledMoves--;
 	}
 
 	return true;
@@ -970,6 +1013,24 @@ void DDARing::Diagnostics(MessageType mtype, const char *prefix) noexcept
 									prefix, scheduledMoves, completedMoves, numHiccups, stepErrors, numLookaheadErrors, numLookaheadUnderruns, numPrepareUnderruns, numNoMoveUnderruns,
 									(cdda == nullptr) ? -1 : (int)cdda->GetState());
 	numHiccups = stepErrors = numLookaheadUnderruns = numPrepareUnderruns = numNoMoveUnderruns = numLookaheadErrors = 0;
+	reprap.GetPlatform().MessageF(mtype, "Lookahead calls %u, recalcs %u, max depth %u, early stops %u\n",
+									numLookaheadCalls, numLookaheadRecalcs, maxLookaheadDepth, numLookaheadEarlyStops);
+	numLookaheadCalls = numLookaheadRecalcs = maxLookaheadDepth = numLookaheadEarlyStops = 0;
+	if (numMovesPrepared != 0)
+	{
+		// Report the average and worst case planning times. These are useful when running a file in simulation mode (M37) to compare planner performance.
+		reprap.GetPlatform().MessageF(mtype, "Planner: moves prepared %" PRIu32 ", prepare time avg %.1fus max %.1fus, lookaheads %" PRIu32 ", lookahead time avg %.1fus max %.1fus\n",
+										numMovesPrepared,
+										(double)((float)prepareClocksTotal * StepClocksToMillis * 1000.0/(float)numMovesPrepared), (double)((float)prepareClocksMax * StepClocksToMillis * 1000.0),
+										numLookaheadsTimed,
+										(numLookaheadsTimed == 0) ? 0.0 : (double)((float)lookaheadClocksTotal * StepClocksToMillis * 1000.0/(float)numLookaheadsTimed),
+										(double)((float)lookaheadClocksMax * StepClocksToMillis * 1000.0));
+	}
+	numMovesPrepared = prepareClocksTotal = prepareClocksMax = numLookaheadsTimed = lookaheadClocksTotal = lookaheadClocksMax = 0;
+#if STEP_BATCH_WINDOW_MICROSECONDS
+	reprap.GetPlatform().MessageF(mtype, "Steps batched in ISR %" PRIu32 "\n", numBatchedSteps);
+	numBatchedSteps = 0;
+#endif
 }
 
 #if SUPPORT_LASER
@@ -1005,6 +1066,7 @@ void DDARing::AddShapedMoveFromRemote(const CanMessageMovementLinearShaped& msg)
 	{
 		if (addPointer->InitShapedFromRemote(msg))
 		{
+			addPointer->SetMovesRepresented(1);
 			addPointer = addPointer->GetNext();
 			scheduledMoves++;
 		}
@@ -1020,6 +1082,7 @@ void DDARing::AddMoveFromRemote(const CanMessageMovementLinear& msg) noexcept
 	{
 		if (addPointer->InitFromRemote(msg))
 		{
+			addPointer->SetMovesRepresented(1);
 			addPointer = addPointer->GetNext();
 			scheduledMoves++;
 		}
@@ -23,7 +23,7 @@ public:
 
 	void RecycleDDAs() noexcept;
 	bool CanAddMove() const noexcept;
-	bool AddStandardMove(const RawMove &nextMove, bool doMotorMapping) noexcept SPEED_CRITICAL;	// Set up a new move, returning true if it represents real movement
+	bool AddStandardMove(const RawMove &nextMove, bool doMotorMapping, uint32_t numMoves = 1) noexcept SPEED_CRITICAL;	// Set up a new move, returning true if it represents real movement
 	bool AddSpecialMove(float feedRate, const float coords[MaxDriversPerAxis]) noexcept;
 #if SUPPORT_ASYNC_MOVES
 	bool AddAsyncMove(const AsyncMove& nextMove) noexcept;
@@ -71,6 +71,7 @@ public:
 	void ResetExtruderPositions() noexcept;												// Resets the extrusion amounts of the live coordinates
 
 	bool PauseMoves(RestorePoint& rp) noexcept;											// Pause the print as soon as we can, returning true if we were able to skip any
+	void GetLastMoveEndCoordinates(RestorePoint& rp) noexcept;					// Set the restore point coordinates to the user end coordinates of the last move in the ring
 #if HAS_VOLTAGE_MONITOR || HAS_STALL_DETECT
 	bool LowPowerOrStallPause(RestorePoint& rp) noexcept;								// Pause the print immediately, returning true if we were able to
 #endif
@@ -80,6 +81,9 @@ public:
 #endif
 
 	void RecordLookaheadError() noexcept { ++numLookaheadErrors; }						// Record a lookahead error
+	void RecordLookahead(unsigned int depth, unsigned int recalcs) noexcept;			// Record the work done by a call to DoLookahead
+	void RecordLookaheadEarlyStop() noexcept { ++numLookaheadEarlyStops; }				// Record that lookahead stopped early
+	void RecordLookaheadTime(uint32_t clocks) noexcept;									// Record how long a call to DoLookahead took
 	void Diagnostics(MessageType mtype, const char *prefix) noexcept;
 
 	bool SetWaitingToEmpty() noexcept;
@@ -124,11 +128,24 @@ private:
 	uint32_t scheduledMoves;													// Move counters for the code queue
 	volatile uint32_t completedMoves;											// This one is modified by an ISR, hence volatile
 	volatile int32_t numHiccups;												// Modified in the ISR
+#if STEP_BATCH_WINDOW_MICROSECONDS
+	volatile uint32_t numBatchedSteps;											// How many times the ISR waited for the next step instead of returning, modified in the ISR
+#endif
 
 	unsigned int numLookaheadUnderruns;											// How many times we have run out of moves to adjust during lookahead
 	unsigned int numPrepareUnderruns;											// How many times we wanted a new move but there were only un-prepared moves in the queue
 	unsigned int numNoMoveUnderruns;											// How many times we wanted a new move but there were none
 	unsigned int numLookaheadErrors;											// How many times our lookahead algorithm failed
+	unsigned int numLookaheadCalls;												// How many times we did lookahead, for diagnostics
+	unsigned int numLookaheadRecalcs;											// How many moves we recalculated during lookahead, for diagnostics
+	unsigned int maxLookaheadDepth;												// The furthest back we had to go during lookahead, for diagnostics
+	unsigned int numLookaheadEarlyStops;										// How many times lookahead stopped early because a junction was already at its limit
+	uint32_t numMovesPrepared;													// How many moves we prepared, for planner timing diagnostics
+	uint32_t prepareClocksTotal;												// Total step clocks spent in DDA::Prepare
+	uint32_t prepareClocksMax;													// Longest time spent in DDA::Prepare
+	uint32_t numLookaheadsTimed;												// How many calls to DDA::DoLookahead we timed
+	uint32_t lookaheadClocksTotal;												// Total step clocks spent in DDA::DoLookahead
+	uint32_t lookaheadClocksMax;												// Longest time spent in a call to DDA::DoLookahead
 	unsigned int stepErrors;													// count of step errors, for diagnostics
 
 	float simulationTime;														// Print time since we started simulating
@@ -144,6 +161,28 @@ private:
 	volatile bool waitingForRingToEmpty;										// True if Move has signalled that we are waiting for this ring to empty
 };
 
+// Record the work done by a call to DoLookahead
+inline void DDARing::RecordLookahead(unsigned int depth, unsigned int recalcs) noexcept
+{
+	++numLookaheadCalls;
+	numLookaheadRecalcs += recalcs;
+	if (depth > maxLookaheadDepth)
+	{
+		maxLookaheadDepth = depth;
+	}
+}
+
+// Record how long a call to DoLookahead took
+inline void DDARing::RecordLookaheadTime(uint32_t clocks) noexcept
+{
+	++numLookaheadsTimed;
+	lookaheadClocksTotal += clocks;
+	if (clocks > lookaheadClocksMax)
+	{
+		lookaheadClocksMax = clocks;
+	}
+}
+
 // Start the next move. Return true if laser or IO bits need to be active
 // Must be called with base priority greater than or equal to the step interrupt, to avoid a race with the step ISR.
 inline bool DDARing::StartNextMove(Platform& p, uint32_t startTime) noexcept
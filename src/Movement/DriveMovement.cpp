@@ -18,6 +18,19 @@
 DriveMovement *DriveMovement::freeList = nullptr;
 unsigned int DriveMovement::numCreated = 0;
 
+#if CHECK_FIXED_POINT_STEP_TIMES
+uint32_t DriveMovement::numFixedPointChecks = 0;
+uint32_t DriveMovement::numFixedPointMismatches = 0;
+uint32_t DriveMovement::maxFixedPointError = 0;
+
+void DriveMovement::FixedPointDiagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "Fixed point step times checked %" PRIu32 ", mismatches %" PRIu32 ", max error %" PRIu32 "\n",
+									numFixedPointChecks, numFixedPointMismatches, maxFixedPointError);
+	numFixedPointChecks = numFixedPointMismatches = maxFixedPointError = 0;
+}
+#endif
+
 void DriveMovement::InitialAllocate(unsigned int num) noexcept
 {
 	while (num > numCreated)
@@ -104,6 +117,9 @@ bool DriveMovement::NewCartesianSegment() noexcept
 			// Set up pA, pB, pC such that for forward motion, time = pB + sqrt(pA + pC * stepNumber)
 			pA = currentSegment->CalcNonlinearA(distanceSoFar);
 			pB = currentSegment->CalcNonlinearB(timeSoFar);
+#if USE_FIXED_POINT_STEP_TIMES
+			SetFixedPointCoefficients();
+#endif
 			state = (currentSegment->IsAccelerating()) ? DMState::cartAccel : DMState::cartDecelNoReverse;
 		}
 
@@ -241,6 +257,9 @@ bool DriveMovement::NewExtruderSegment() noexcept
 			// Set up pA, pB, pC such that for forward motion, time = pB + sqrt(pA + pC * stepNumber)
 			pA = currentSegment->CalcNonlinearA(startDistance, mp.cart.pressureAdvanceK);
 			pB = currentSegment->CalcNonlinearB(startTime, mp.cart.pressureAdvanceK);
+#if USE_FIXED_POINT_STEP_TIMES
+			SetFixedPointCoefficients();
+#endif
 			if (currentSegment->IsAccelerating())
 			{
 				// Extruders have a single acceleration segment. We need to add the extra extrusion distance due to pressure advance to the extrusion distance.
@@ -645,6 +664,57 @@ static inline float fastLimSqrtf(float f) noexcept
 	return (f > 0.0) ? fastSqrtf(f) : 0.0;
 }
 
+#if USE_FIXED_POINT_STEP_TIMES
+
+// Set up the integer versions of pA, pB and pC. Called when starting an accelerating or decelerating Cartesian or extruder segment.
+// We round rather than truncate pB because NonlinearStepTime truncates the root separately, so this keeps the result within one step clock of the floating point one.
+void DriveMovement::SetFixedPointCoefficients() noexcept
+{
+	iA = llrintf(pA);
+	iB = lrintf(pB);
+	iC = llrintf(pC * (float)(1u << SFfixedC));
+}
+
+// Return sqrt(A + C * stepNumber) using integer arithmetic, allowing for the argument being slightly negative due to rounding error.
+// We split the multiplication so that the product can't overflow 64 bits.
+inline uint32_t DriveMovement::FixedPointRoot(int32_t stepNumber) const noexcept
+{
+	const int64_t arg = iA + (iC >> SFfixedC) * stepNumber + (((iC & ((1u << SFfixedC) - 1)) * stepNumber) >> SFfixedC);
+	return (arg > 0) ? isqrt64((uint64_t)arg) : 0;
+}
+
+#endif
+
+// Return the step time pB +/- sqrt(pA + pC * stepNumber) for an accelerating or decelerating Cartesian or extruder segment as a whole number of step clocks.
+// The floating point version truncates the result. The fixed point version may differ from it by one step clock, see SetFixedPointCoefficients.
+// stepNumber is signed because the net step number may be negative after reversal.
+inline uint32_t DriveMovement::NonlinearStepTime(int32_t stepNumber, bool subtractRoot) noexcept
+{
+#if USE_FIXED_POINT_STEP_TIMES
+	const int32_t root = (int32_t)FixedPointRoot(stepNumber);
+	const int32_t t = (subtractRoot) ? iB - root : iB + root;
+	const uint32_t ret = (t > 0) ? (uint32_t)t : 0;				// negative results are returned as zero, like a float to unsigned conversion does
+# if CHECK_FIXED_POINT_STEP_TIMES
+	const float fRoot = fastLimSqrtf(pA + pC * (float)stepNumber);
+	const uint32_t fpRet = (uint32_t)((subtractRoot) ? pB - fRoot : pB + fRoot);
+	const uint32_t err = (fpRet > ret) ? fpRet - ret : ret - fpRet;
+	++numFixedPointChecks;
+	if (err != 0)
+	{
+		++numFixedPointMismatches;
+		if (err > maxFixedPointError)
+		{
+			maxFixedPointError = err;
+		}
+	}
+# endif
+	return ret;
+#else
+	const float root = fastLimSqrtf(pA + pC * (float)stepNumber);
+	return (uint32_t)((subtractRoot) ? pB - root : pB + root);
+#endif
+}
+
 // Calculate and store the time since the start of the move when the next step for the specified DriveMovement is due.
 // We have already incremented nextStep and checked that it does not exceed totalSteps, so at least one more step is due
 // Return true if all OK, false to abort this move because the calculation has gone wrong
@@ -711,23 +781,23 @@ pre(nextStep <= totalSteps; stepsTillRecalc == 0)
 
 	stepsTillRecalc = (1u << shiftFactor) - 1u;					// store number of additional steps to generate
 
-	float nextCalcStepTime;
+	uint32_t iNextCalcStepTime;
 
 	// Work out the time of the step
 	switch (state)
 	{
 	case DMState::cartLinear:									// linear steady speed
-		nextCalcStepTime = pB + (float)(nextStep + stepsTillRecalc) * pC;
+		iNextCalcStepTime = (uint32_t)(pB + (float)(nextStep + stepsTillRecalc) * pC);
 		break;
 
 	case DMState::cartAccel:									// Cartesian accelerating
-		nextCalcStepTime = pB + fastLimSqrtf(pA + pC * (float)(nextStep + stepsTillRecalc));
+		iNextCalcStepTime = NonlinearStepTime((int32_t)(nextStep + stepsTillRecalc), false);
 		break;
 
 	case DMState::cartDecelForwardsReversing:
 		if (nextStep + stepsTillRecalc < reverseStartStep)
 		{
-			nextCalcStepTime = pB - fastLimSqrtf(pA + pC * (float)(nextStep + stepsTillRecalc));
+			iNextCalcStepTime = NonlinearStepTime((int32_t)(nextStep + stepsTillRecalc), true);
 			break;
 		}
 
@@ -736,11 +806,11 @@ pre(nextStep <= totalSteps; stepsTillRecalc == 0)
 		state = DMState::cartDecelReverse;
 		// no break
 	case DMState::cartDecelReverse:								// Cartesian decelerating, reverse motion. Convert the steps to int32_t because the net steps may be negative.
-		nextCalcStepTime = pB + fastLimSqrtf(pA + pC * (float)((2 * (int32_t)(reverseStartStep - 1)) - (int32_t)(nextStep + stepsTillRecalc)));
+		iNextCalcStepTime = NonlinearStepTime((2 * (int32_t)(reverseStartStep - 1)) - (int32_t)(nextStep + stepsTillRecalc), false);
 		break;
 
 	case DMState::cartDecelNoReverse:							// Cartesian accelerating with no reversal
-		nextCalcStepTime = pB - fastLimSqrtf(pA + pC * (float)(nextStep + stepsTillRecalc));
+		iNextCalcStepTime = NonlinearStepTime((int32_t)(nextStep + stepsTillRecalc), true);
 		break;
 
 	case DMState::deltaForwardsReversing:						// moving forwards
@@ -780,9 +850,9 @@ pre(nextStep <= totalSteps; stepsTillRecalc == 0)
 			}
 
 			const float pCds = pC * ds;
-			nextCalcStepTime = (currentSegment->IsLinear()) ? pB + pCds
-								: (currentSegment->IsAccelerating()) ? pB + fastLimSqrtf(pA + pCds)
-									 : pB - fastLimSqrtf(pA + pCds);
+			iNextCalcStepTime = (uint32_t)((currentSegment->IsLinear()) ? pB + pCds
+											: (currentSegment->IsAccelerating()) ? pB + fastLimSqrtf(pA + pCds)
+												 : pB - fastLimSqrtf(pA + pCds));
 			//if (currentSegment->IsLinear()) { pA = ds; }	//DEBUG
 		}
 		break;
@@ -792,17 +862,15 @@ pre(nextStep <= totalSteps; stepsTillRecalc == 0)
 	}
 
 #if 0	//DEBUG
-	if (std::isnan(nextCalcStepTime) || nextCalcStepTime < 0.0)
+	if ((int32_t)iNextCalcStepTime < 0)
 	{
 		state = DMState::stepError;
 		nextStep += 140000000 + stepsTillRecalc;			// so we can tell what happened in the debug print
-		distanceSoFar = nextCalcStepTime;					//DEBUG
+		distanceSoFar = (float)iNextCalcStepTime;			//DEBUG
 		return false;
 	}
 #endif
 
-	uint32_t iNextCalcStepTime = (uint32_t)nextCalcStepTime;
-
 	if (iNextCalcStepTime > dda.clocksNeeded)
 	{
 		// The calculation makes this step late.
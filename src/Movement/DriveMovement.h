@@ -18,6 +18,26 @@ class ExtruderShaper;
 
 #define EVEN_STEPS			(1)						// 1 to generate steps at even intervals when doing double/quad/octal stepping
 
+// Set USE_FIXED_POINT_STEP_TIMES to 1 to calculate the step times of Cartesian and extruder accelerating and decelerating segments using 64-bit integer maths instead of floating point.
+// This is faster on processors that have no FPU. The step times are not always identical to the floating point ones: B is rounded to the nearest step clock
+// and the root is truncated, whereas the floating point code truncates the sum, so a step may occur one step clock earlier or later.
+#ifndef USE_FIXED_POINT_STEP_TIMES
+# if SAM4S
+#  define USE_FIXED_POINT_STEP_TIMES	(1)
+# else
+#  define USE_FIXED_POINT_STEP_TIMES	(0)
+# endif
+#endif
+
+// Set CHECK_FIXED_POINT_STEP_TIMES to 1 to calculate the step times using floating point as well and count the discrepancies. Only for testing, because it slows down step generation.
+#ifndef CHECK_FIXED_POINT_STEP_TIMES
+# define CHECK_FIXED_POINT_STEP_TIMES	(0)
+#endif
+
+#if CHECK_FIXED_POINT_STEP_TIMES && !USE_FIXED_POINT_STEP_TIMES
+# error "CHECK_FIXED_POINT_STEP_TIMES requires USE_FIXED_POINT_STEP_TIMES"
+#endif
+
 enum class DMState : uint8_t
 {
 	idle = 0,
@@ -68,6 +88,10 @@ public:
 	static DriveMovement *Allocate(size_t p_drive, DMState st) noexcept;
 	static void Release(DriveMovement *item) noexcept;
 
+#if CHECK_FIXED_POINT_STEP_TIMES
+	static void FixedPointDiagnostics(MessageType mtype) noexcept;
+#endif
+
 private:
 	bool CalcNextStepTimeFull(const DDA &dda) noexcept SPEED_CRITICAL;
 	bool NewCartesianSegment() noexcept SPEED_CRITICAL;
@@ -76,9 +100,24 @@ private:
 	bool NewDeltaSegment(const DDA& dda) noexcept SPEED_CRITICAL;
 #endif
 
+	uint32_t NonlinearStepTime(int32_t stepNumber, bool subtractRoot) noexcept SPEED_CRITICAL;
+
+#if USE_FIXED_POINT_STEP_TIMES
+	void SetFixedPointCoefficients() noexcept SPEED_CRITICAL;
+	uint32_t FixedPointRoot(int32_t stepNumber) const noexcept SPEED_CRITICAL;
+
+	static constexpr unsigned int SFfixedC = 8;			// the number of fraction bits in iC
+#endif
+
 	static DriveMovement *freeList;
 	static unsigned int numCreated;
 
+#if CHECK_FIXED_POINT_STEP_TIMES
+	static uint32_t numFixedPointChecks;				// how many step times we calculated both ways
+	static uint32_t numFixedPointMismatches;			// how many times the two results differed
+	static uint32_t maxFixedPointError;					// the largest difference between the two results, in step clocks
+#endif
+
 	// Parameters common to Cartesian, delta and extruder moves
 
 	DriveMovement *nextDM;								// link to next DM that needs a step
@@ -107,6 +146,13 @@ private:
 	float timeSoFar;
 	float pA, pB, pC;
 
+#if USE_FIXED_POINT_STEP_TIMES
+	// Integer versions of pA, pB and pC, only valid for accelerating and decelerating Cartesian and extruder segments
+	int64_t iA;											// pA in step clocks squared
+	int64_t iC;											// pC in step clocks squared per step, multiplied by 2^SFfixedC
+	int32_t iB;											// pB in step clocks
+#endif
+
 	// Parameters unique to a style of move (Cartesian, delta or extruder). Currently, extruders and Cartesian moves use the same parameters.
 	union
 	{
@@ -111,6 +111,7 @@ void HangprinterKinematics::Recalc() noexcept
 	lineLengthsOrigin[B_AXIS] = fastSqrtf(fsquare(anchors[B_AXIS][0]) + fsquare(anchors[B_AXIS][1]) + fsquare(anchors[B_AXIS][2]));
 	lineLengthsOrigin[C_AXIS] = fastSqrtf(fsquare(anchors[C_AXIS][0]) + fsquare(anchors[C_AXIS][1]) + fsquare(anchors[C_AXIS][2]));
 	lineLengthsOrigin[D_AXIS] = fastSqrtf(fsquare(anchors[D_AXIS][0]) + fsquare(anchors[D_AXIS][1]) + fsquare(anchors[D_AXIS][2]));
+	RecalcForwardTransform();
 
 
 	// Line buildup compensation
@@ -528,6 +529,30 @@ bool HangprinterKinematics::WriteResumeSettings(FileStore *f) const noexcept
  * Warning: truncation errors will typically be in the order of a few tens of microns.
  */
 void HangprinterKinematics::ForwardTransform(float const a, float const b, float const c, float const d, float machinePos[3]) const noexcept
+{
+	// The anchor positions rotated such that Ax=0, Dx=0, Dy=0 and the rotation back to the original coordinate system were calculated by Recalc
+	const float Asq = fsquare(lineLengthsOrigin[A_AXIS]);
+	const float Bsq = fsquare(lineLengthsOrigin[B_AXIS]);
+	const float Csq = fsquare(lineLengthsOrigin[C_AXIS]);
+	const float Dsq = fsquare(lineLengthsOrigin[D_AXIS]);
+	const float aa = fsquare(a);
+	const float dd = fsquare(d);
+	const float k0b = (-fsquare(b) + Bsq - Dsq + dd) / (2.0 * rotatedAnchors[B_AXIS][X_AXIS]) + (rotatedAnchors[B_AXIS][Y_AXIS] / (2.0 * rotatedAnchors[A_AXIS][Y_AXIS] * rotatedAnchors[B_AXIS][X_AXIS])) * (Dsq - Asq + aa - dd);
+	const float k0c = (-fsquare(c) + Csq - Dsq + dd) / (2.0 * rotatedAnchors[C_AXIS][X_AXIS]) + (rotatedAnchors[C_AXIS][Y_AXIS] / (2.0 * rotatedAnchors[A_AXIS][Y_AXIS] * rotatedAnchors[C_AXIS][X_AXIS])) * (Dsq - Asq + aa - dd);
+
+	float machinePos_tmp0[3];
+	machinePos_tmp0[Z_AXIS] = (k0b - k0c) / (k1c - k1b);
+	machinePos_tmp0[X_AXIS] = k0c + k1c * machinePos_tmp0[Z_AXIS];
+	machinePos_tmp0[Y_AXIS] = (Asq - Dsq - aa + dd) / (2.0 * rotatedAnchors[A_AXIS][Y_AXIS]) + ((rotatedAnchors[D_AXIS][Z_AXIS] - rotatedAnchors[A_AXIS][Z_AXIS]) / rotatedAnchors[A_AXIS][Y_AXIS]) * machinePos_tmp0[Z_AXIS];
+
+	//// Rotate machinePos_tmp back to original coordinate system
+	for (size_t row{0}; row < 3; ++row) {
+		machinePos[row] = inverseRotation[row][0]*machinePos_tmp0[0] + inverseRotation[row][1]*machinePos_tmp0[1] + inverseRotation[row][2]*machinePos_tmp0[2];
+	}
+}
+
+// Calculate the parts of the forward transform that depend only on the anchor positions
+void HangprinterKinematics::RecalcForwardTransform() noexcept
 {
 	// Force the anchor location norms Ax=0, Dx=0, Dy=0
 	// through a series of rotations.
@@ -551,36 +576,24 @@ void HangprinterKinematics::ForwardTransform(float const a, float const b, float
 	float const rzt[3][3] = {{cosf(z_angle), sinf(z_angle), 0}, {-sinf(z_angle), cosf(z_angle), 0}, {0, 0, 1}};
 	for (size_t row{0}; row < 4; ++row) {
 		for (size_t col{0}; col < 3; ++col) {
-			anchors_tmp0[row][col] = rzt[0][col]*anchors_tmp1[row][0] + rzt[1][col]*anchors_tmp1[row][1] + rzt[2][col]*anchors_tmp1[row][2];
+			rotatedAnchors[row][col] = rzt[0][col]*anchors_tmp1[row][0] + rzt[1][col]*anchors_tmp1[row][1] + rzt[2][col]*anchors_tmp1[row][2];
 		}
 	}
 
-	const float Asq = fsquare(lineLengthsOrigin[A_AXIS]);
-	const float Bsq = fsquare(lineLengthsOrigin[B_AXIS]);
-	const float Csq = fsquare(lineLengthsOrigin[C_AXIS]);
-	const float Dsq = fsquare(lineLengthsOrigin[D_AXIS]);
-	const float aa = fsquare(a);
-	const float dd = fsquare(d);
-	const float k0b = (-fsquare(b) + Bsq - Dsq + dd) / (2.0 * anchors_tmp0[B_AXIS][X_AXIS]) + (anchors_tmp0[B_AXIS][Y_AXIS] / (2.0 * anchors_tmp0[A_AXIS][Y_AXIS] * anchors_tmp0[B_AXIS][X_AXIS])) * (Dsq - Asq + aa - dd);
-	const float k0c = (-fsquare(c) + Csq - Dsq + dd) / (2.0 * anchors_tmp0[C_AXIS][X_AXIS]) + (anchors_tmp0[C_AXIS][Y_AXIS] / (2.0 * anchors_tmp0[A_AXIS][Y_AXIS] * anchors_tmp0[C_AXIS][X_AXIS])) * (Dsq - Asq + aa - dd);
-	const float k1b = (anchors_tmp0[B_AXIS][Y_AXIS] * (anchors_tmp0[A_AXIS][Z_AXIS] - anchors_tmp0[D_AXIS][Z_AXIS])) / (anchors_tmp0[A_AXIS][Y_AXIS] * anchors_tmp0[B_AXIS][X_AXIS]) + (anchors_tmp0[D_AXIS][Z_AXIS] - anchors_tmp0[B_AXIS][Z_AXIS]) / anchors_tmp0[B_AXIS][X_AXIS];
-	const float k1c = (anchors_tmp0[C_AXIS][Y_AXIS] * (anchors_tmp0[A_AXIS][Z_AXIS] - anchors_tmp0[D_AXIS][Z_AXIS])) / (anchors_tmp0[A_AXIS][Y_AXIS] * anchors_tmp0[C_AXIS][X_AXIS]) + (anchors_tmp0[D_AXIS][Z_AXIS] - anchors_tmp0[C_AXIS][Z_AXIS]) / anchors_tmp0[C_AXIS][X_AXIS];
+	k1b = (rotatedAnchors[B_AXIS][Y_AXIS] * (rotatedAnchors[A_AXIS][Z_AXIS] - rotatedAnchors[D_AXIS][Z_AXIS])) / (rotatedAnchors[A_AXIS][Y_AXIS] * rotatedAnchors[B_AXIS][X_AXIS]) + (rotatedAnchors[D_AXIS][Z_AXIS] - rotatedAnchors[B_AXIS][Z_AXIS]) / rotatedAnchors[B_AXIS][X_AXIS];
+	k1c = (rotatedAnchors[C_AXIS][Y_AXIS] * (rotatedAnchors[A_AXIS][Z_AXIS] - rotatedAnchors[D_AXIS][Z_AXIS])) / (rotatedAnchors[A_AXIS][Y_AXIS] * rotatedAnchors[C_AXIS][X_AXIS]) + (rotatedAnchors[D_AXIS][Z_AXIS] - rotatedAnchors[C_AXIS][Z_AXIS]) / rotatedAnchors[C_AXIS][X_AXIS];
 
-	float machinePos_tmp0[3];
-	machinePos_tmp0[Z_AXIS] = (k0b - k0c) / (k1c - k1b);
-	machinePos_tmp0[X_AXIS] = k0c + k1c * machinePos_tmp0[Z_AXIS];
-	machinePos_tmp0[Y_AXIS] = (Asq - Dsq - aa + dd) / (2.0 * anchors_tmp0[A_AXIS][Y_AXIS]) + ((anchors_tmp0[D_AXIS][Z_AXIS] - anchors_tmp0[A_AXIS][Z_AXIS]) / anchors_tmp0[A_AXIS][Y_AXIS]) * machinePos_tmp0[Z_AXIS];
-
-	//// Rotate machinePos_tmp back to original coordinate system
-	float machinePos_tmp1[3];
-	for (size_t row{0}; row < 3; ++row) {
-		machinePos_tmp1[row] = rzt[row][0]*machinePos_tmp0[0] + rzt[row][1]*machinePos_tmp0[1] + rzt[row][2]*machinePos_tmp0[2];
-	}
+	// The rotation back to the original coordinate system is rxt * ryt * rzt
+	float ryzt[3][3];
 	for (size_t row{0}; row < 3; ++row) {
-		machinePos_tmp0[row] = ryt[row][0]*machinePos_tmp1[0] + ryt[row][1]*machinePos_tmp1[1] + ryt[row][2]*machinePos_tmp1[2];
+		for (size_t col{0}; col < 3; ++col) {
+			ryzt[row][col] = ryt[row][0]*rzt[0][col] + ryt[row][1]*rzt[1][col] + ryt[row][2]*rzt[2][col];
+		}
 	}
 	for (size_t row{0}; row < 3; ++row) {
-		machinePos[row] = rxt[row][0]*machinePos_tmp0[0] + rxt[row][1]*machinePos_tmp0[1] + rxt[row][2]*machinePos_tmp0[2];
+		for (size_t col{0}; col < 3; ++col) {
+			inverseRotation[row][col] = rxt[row][0]*ryzt[0][col] + rxt[row][1]*ryzt[1][col] + rxt[row][2]*ryzt[2][col];
+		}
 	}
 }
 
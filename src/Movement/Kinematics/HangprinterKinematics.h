@@ -62,6 +62,7 @@ private:
 	void Recalc() noexcept;
 	float LineLengthSquared(const float machinePos[3], const float anchor[3]) const noexcept;		// Calculate the square of the line length from a spool from a Cartesian coordinate
 	void ForwardTransform(float a, float b, float c, float d, float machinePos[3]) const noexcept;
+	void RecalcForwardTransform() noexcept;
 	float MotorPosToLinePos(const int32_t motorPos, size_t axis) const noexcept;
 
 	void PrintParameters(const StringRef& reply) const noexcept;									// Print all the parameters for debugging
@@ -77,6 +78,9 @@ private:
 	// Derived parameters
 	float k0[HANGPRINTER_AXES], spoolRadiiSq[HANGPRINTER_AXES], k2[HANGPRINTER_AXES], lineLengthsOrigin[HANGPRINTER_AXES];
 	float printRadiusSquared;
+	float rotatedAnchors[HANGPRINTER_AXES][3];		// anchor positions rotated such that Ax=0, Dx=0, Dy=0, used by the forward transform
+	float inverseRotation[3][3];					// rotation from the rotated coordinate system back to the original one
+	float k1b, k1c;									// forward transform constants that depend only on the anchor positions
 
 #if DUAL_CAN
 	// Some CAN helpers
@@ -52,7 +52,7 @@ DEFINE_GET_OBJECT_MODEL_TABLE(Kinematics)
 // Constructor. Pass segsPerSecond <= 0.0 to get non-segmented kinematics.
 Kinematics::Kinematics(KinematicsType t, SegmentationType segType) noexcept
 	: segmentsPerSecond(DefaultSegmentsPerSecond), minSegmentLength(DefaultMinSegmentLength), reciprocalMinSegmentLength(1.0/DefaultMinSegmentLength),
-	  segmentationType(segType), type(t)
+	  maxSegmentationError(0.0), segmentationType(segType), type(t)
 {
 }
 
@@ -68,6 +68,10 @@ bool Kinematics::Configure(unsigned int mCode, GCodeBuffer& gb, const StringRef&
 			if (segmentationType.useSegmentation)
 			{
 				reply.catf("%d segments/sec, min. segment length %.2fmm", (int)segmentsPerSecond, (double)minSegmentLength);
+				if (maxSegmentationError > 0.0)
+				{
+					reply.catf(", max. path error %.3fmm", (double)maxSegmentationError);
+				}
 			}
 			else
 			{
@@ -89,6 +93,7 @@ bool Kinematics::TryConfigureSegmentation(GCodeBuffer& gb) THROWS(GCodeException
 	bool seen = false;
 	gb.TryGetFValue('S', segmentsPerSecond, seen);
 	gb.TryGetFValue('T', minSegmentLength, seen);
+	gb.TryGetFValue('E', maxSegmentationError, seen);
 	if (seen)
 	{
 		segmentationType.useSegmentation = minSegmentLength > 0.0 && segmentsPerSecond > 0.0;
@@ -100,6 +105,23 @@ bool Kinematics::TryConfigureSegmentation(GCodeBuffer& gb) THROWS(GCodeException
 	return seen;
 }
 
+// Return the number of segments needed to keep the path error within the limit set by M669 E, but no more than maxSegments.
+// Return 0 if no limit has been set or the kinematics can't estimate the path error.
+unsigned int Kinematics::GetSegmentsForMaxError(const float startCoords[], const float endCoords[], unsigned int maxSegments) const noexcept
+{
+	if (maxSegmentationError > 0.0)
+	{
+		const float error = GetUnsegmentedPathError(startCoords, endCoords);
+		if (error >= 0.0)
+		{
+			// The error of each segment is roughly proportional to the square of its length
+			const float segmentsNeeded = ceilf(sqrtf(error/maxSegmentationError));
+			return (segmentsNeeded < (float)maxSegments) ? max<unsigned int>((unsigned int)segmentsNeeded, 1) : maxSegments;
+		}
+	}
+	return 0;
+}
+
 // Return true if the specified XY position is reachable by the print head reference point.
 // This default implementation assumes a rectangular reachable area, so it just uses the bed dimensions give in the M208 command.
 bool Kinematics::IsReachable(float axesCoords[MaxAxes], AxesBitmap axes) const noexcept
@@ -203,6 +203,10 @@ public:
 	// This is called to determine whether we can babystep the specified axis independently of regular motion.
 	virtual AxesBitmap GetLinearAxes() const noexcept = 0;
 
+	// Return the largest distance in mm by which the head would deviate from the straight line between the two machine positions if the move were done as a single
+	// segment with the motors moving linearly, or a negative value if this can't be estimated. Override this in segmented kinematics that support M669 E.
+	virtual float GetUnsegmentedPathError(const float startCoords[], const float endCoords[]) const noexcept { return -1.0; }
+
 	// Override this virtual destructor if your constructor allocates any dynamic memory
 	virtual ~Kinematics() { }
 
@@ -217,6 +221,7 @@ public:
 	float GetSegmentsPerSecond() const noexcept pre(UseSegmentation()) { return segmentsPerSecond; }
 	float GetMinSegmentLength() const noexcept pre(UseSegmentation()) { return minSegmentLength; }
 	float GetReciprocalMinSegmentLength() const noexcept pre(UseSegmentation()) { return reciprocalMinSegmentLength; }
+	unsigned int GetSegmentsForMaxError(const float startCoords[], const float endCoords[], unsigned int maxSegments) const noexcept pre(UseSegmentation());
 
 protected:
 	DECLARE_OBJECT_MODEL
@@ -246,6 +251,7 @@ private:
 	float segmentsPerSecond;				// if we are using segmentation, the target number of segments/second
 	float minSegmentLength;					// if we are using segmentation, the minimum segment size
 	float reciprocalMinSegmentLength;		// if we are using segmentation, the reciprocal of minimum segment size
+	float maxSegmentationError;				// if nonzero, the maximum path error in mm that we aim for when choosing the number of segments
 
 	SegmentationType segmentationType;		// the type of segmentation we are using
 	KinematicsType type;
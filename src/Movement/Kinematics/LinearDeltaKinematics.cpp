@@ -116,6 +116,7 @@ void LinearDeltaKinematics::Recalc() noexcept
 	for (size_t axis = 0; axis < numTowers; ++axis)
 	{
 		D2[axis] = fsquare(diagonals[axis]);
+		towerK[axis] = D2[axis] - fsquare(towerX[axis]) - fsquare(towerY[axis]);
 		homedCarriageHeights[axis] = homedHeight
 									+ fastSqrtf(D2[axis] - ((axis < UsualNumTowers) ? fsquare(radius) : fsquare(towerX[axis]) + fsquare(towerY[axis])))
 									+ endstopAdjustments[axis];
@@ -163,10 +164,10 @@ float LinearDeltaKinematics::Transform(const float machinePos[], size_t axis) co
 {
 	if (axis < numTowers)
 	{
-		return fastSqrtf(D2[axis] - fsquare(machinePos[X_AXIS] - towerX[axis]) - fsquare(machinePos[Y_AXIS] - towerY[axis]))
-			 + machinePos[Z_AXIS]
-			 + (machinePos[X_AXIS] * xTilt)
-			 + (machinePos[Y_AXIS] * yTilt);
+		// D2 - (x - towerX)^2 - (y - towerY)^2 = towerK + 2 * (x * towerX + y * towerY) - (x^2 + y^2). CartesianToMotorSteps evaluates this in the same order.
+		const float x = machinePos[X_AXIS], y = machinePos[Y_AXIS];
+		return fastSqrtf(towerK[axis] + ((2 * x) * towerX[axis] + (2 * y) * towerY[axis]) - (fsquare(x) + fsquare(y)))
+			 + (machinePos[Z_AXIS] + (x * xTilt) + (y * yTilt));
 	}
 	else
 	{
@@ -208,10 +209,16 @@ void LinearDeltaKinematics::ForwardTransform(float Ha, float Hb, float Hc, float
 bool LinearDeltaKinematics::CartesianToMotorSteps(const float machinePos[], const float stepsPerMm[],
 													size_t numVisibleAxes, size_t numTotalAxes, int32_t motorPos[], bool isCoordinated) const noexcept
 {
+	// Evaluate all the towers together so that the terms that depend only on the head position are calculated just once. This gives the same results as calling Transform for each tower.
+	const float x = machinePos[X_AXIS], y = machinePos[Y_AXIS];
+	const float twoX = 2 * x, twoY = 2 * y;
+	const float rSquared = fsquare(x) + fsquare(y);
+	const float zPlusTilt = machinePos[Z_AXIS] + (x * xTilt) + (y * yTilt);
+
 	bool ok = true;
 	for (size_t axis = 0; axis < numTowers; ++axis)
 	{
-		const float pos = Transform(machinePos, axis);
+		const float pos = fastSqrtf(towerK[axis] + (twoX * towerX[axis] + twoY * towerY[axis]) - rSquared) + zPlusTilt;
 		if (std::isnan(pos) || std::isinf(pos))
 		{
 			ok = false;
@@ -462,53 +469,71 @@ bool LinearDeltaKinematics::DoAutoCalibration(size_t numFactors, const RandomPro
 		initialDeviation.Set(initialSumOfSquares, initialSum, numPoints);
 	}
 
+	// Function to calculate the derivatives of the height at a probe point with respect to the factors we are adjusting, returning false if any of them is NaN
+	auto getDerivatives = [this, numFactors, &probeMotorPositions](size_t point, floatc_t derivatives[]) noexcept -> bool
+	{
+		for (size_t j = 0; j < numFactors; ++j)
+		{
+			const size_t adjustedJ = (numFactors == 8 && j >= 6) ? j + 1 : j;		// skip diagonal rod length if doing 8-factor calibration
+			const floatc_t d =
+				ComputeDerivative(adjustedJ, probeMotorPositions(point, DELTA_A_AXIS), probeMotorPositions(point, DELTA_B_AXIS), probeMotorPositions(point, DELTA_C_AXIS));
+			if (std::isnan(d))			// a couple of users have reported getting Nans in the derivative, probably due to points being unreachable
+			{
+				return false;
+			}
+			derivatives[j] = d;
+		}
+		return true;
+	};
+
 	// Do 1 or more Newton-Raphson iterations
 	Deviation finalDeviation;
 	unsigned int iteration = 0;
 	for (;;)
 	{
-		// Build a Nx9 matrix of derivatives with respect to xa, xb, yc, za, zb, zc, diagonal.
-		FixedMatrix<floatc_t, MaxCalibrationPoints, NumDeltaFactors> derivativeMatrix;
-		for (size_t i = 0; i < numPoints; ++i)
+		// Build the normal equations for least squares fitting. We accumulate them one probe point at a time from the derivatives with respect to
+		// xa, xb, yc, za, zb, zc and diagonal at that point, so that we don't need to store the Nx9 matrix of derivatives on the stack.
+		FixedMatrix<floatc_t, NumDeltaFactors, NumDeltaFactors + 1> normalMatrix;
+		for (size_t i = 0; i < numFactors; ++i)
 		{
-			for (size_t j = 0; j < numFactors; ++j)
+			for (size_t j = 0; j <= numFactors; ++j)
 			{
-				const size_t adjustedJ = (numFactors == 8 && j >= 6) ? j + 1 : j;		// skip diagonal rod length if doing 8-factor calibration
-				const floatc_t d =
-					ComputeDerivative(adjustedJ, probeMotorPositions(i, DELTA_A_AXIS), probeMotorPositions(i, DELTA_B_AXIS), probeMotorPositions(i, DELTA_C_AXIS));
-				if (std::isnan(d))			// a couple of users have reported getting Nans in the derivative, probably due to points being unreachable
-				{
-					reply.printf("Auto calibration failed because probe point P%u was unreachable using the current delta parameters. Try a smaller probing radius.", i);
-					return true;
-				}
-				derivativeMatrix(i, j) = d;
+				normalMatrix(i, j) = 0.0;
 			}
 		}
 
-		if (reprap.Debug(moduleMove))
+		for (size_t k = 0; k < numPoints; ++k)
 		{
-			PrintMatrix("Derivative matrix", derivativeMatrix, numPoints, numFactors);
-		}
+			floatc_t derivatives[NumDeltaFactors];
+			if (!getDerivatives(k, derivatives))
+			{
+				reply.printf("Auto calibration failed because probe point P%u was unreachable using the current delta parameters. Try a smaller probing radius.", k);
+				return true;
+			}
 
-		// Now build the normal equations for least squares fitting
-		FixedMatrix<floatc_t, NumDeltaFactors, NumDeltaFactors + 1> normalMatrix;
-		for (size_t i = 0; i < numFactors; ++i)
-		{
-			for (size_t j = 0; j < numFactors; ++j)
+			if (reprap.Debug(moduleMove))
 			{
-				floatc_t temp = derivativeMatrix(0, i) * derivativeMatrix(0, j);
-				for (size_t k = 1; k < numPoints; ++k)
+				PrintVector("Derivatives", derivatives, numFactors);
+			}
+
+			const floatc_t heightError = -((floatc_t)probePoints.GetZHeight(k) + corrections[k]);
+			for (size_t i = 0; i < numFactors; ++i)
+			{
+				for (size_t j = 0; j <= i; ++j)
 				{
-					temp += derivativeMatrix(k, i) * derivativeMatrix(k, j);
+					normalMatrix(i, j) += derivatives[i] * derivatives[j];
 				}
-				normalMatrix(i, j) = temp;
+				normalMatrix(i, numFactors) += derivatives[i] * heightError;
 			}
-			floatc_t temp = derivativeMatrix(0, i) * -((floatc_t)probePoints.GetZHeight(0) + corrections[0]);
-			for (size_t k = 1; k < numPoints; ++k)
+		}
+
+		// The normal matrix is symmetric, so fill in the upper triangle
+		for (size_t i = 0; i < numFactors; ++i)
+		{
+			for (size_t j = i + 1; j < numFactors; ++j)
 			{
-				temp += derivativeMatrix(k, i) * -((floatc_t)probePoints.GetZHeight(k) + corrections[k]);
+				normalMatrix(i, j) = normalMatrix(j, i);
 			}
-			normalMatrix(i, numFactors) = temp;
 		}
 
 		if (reprap.Debug(moduleMove))
@@ -538,10 +563,12 @@ bool LinearDeltaKinematics::DoAutoCalibration(size_t numFactors, const RandomPro
 			debugPrintf("Residuals:");
 			for (size_t i = 0; i < numPoints; ++i)
 			{
+				floatc_t derivatives[NumDeltaFactors];
+				(void)getDerivatives(i, derivatives);
 				floatc_t residual = probePoints.GetZHeight(i);
 				for (size_t j = 0; j < numFactors; ++j)
 				{
-					residual += solution[j] * derivativeMatrix(i, j);
+					residual += solution[j] * derivatives[j];
 				}
 				debugPrintf(" %7.4f", (double)residual);
 			}
@@ -104,6 +104,7 @@ private:
 	float coreKa, coreKb, coreKc;
 	float Q, Q2;
 	float D2[MaxTowers];
+	float towerK[MaxTowers];							// D2 minus the square of the horizontal distance of each tower from the origin, used by the inverse transform
 	float alwaysReachableHeight;
 
 	bool doneAutoCalibration;							// True if we have done auto calibration
@@ -242,6 +242,32 @@ bool ScaraKinematics::Configure(unsigned int mCode, GCodeBuffer& gb, const Strin
 	}
 }
 
+// Return the largest XY deviation from the straight line if the move were done with the arm angles changing linearly.
+// We sample the path at the quarter, half and three-quarter points. The crosstalk factors don't matter because the angles vary linearly if the motor positions do.
+float ScaraKinematics::GetUnsegmentedPathError(const float startCoords[], const float endCoords[]) const noexcept
+{
+	float startTheta, startPsi, endTheta, endPsi;
+	bool armMode = currentArmMode;
+	if (!CalculateThetaAndPsi(startCoords, true, startTheta, startPsi, armMode) || !CalculateThetaAndPsi(endCoords, true, endTheta, endPsi, armMode))
+	{
+		return -1.0;
+	}
+
+	float maxErrorSquared = 0.0;
+	for (unsigned int quarter = 1; quarter <= 3; ++quarter)
+	{
+		const float t = (float)quarter * 0.25;
+		const float theta = startTheta + (endTheta - startTheta) * t;
+		const float psi = startPsi + (endPsi - startPsi) * t;
+		const float x = (cosf(theta * DegreesToRadians) * proximalArmLength + cosf((psi + theta) * DegreesToRadians) * distalArmLength) - xOffset;
+		const float y = (sinf(theta * DegreesToRadians) * proximalArmLength + sinf((psi + theta) * DegreesToRadians) * distalArmLength) - yOffset;
+		const float errorSquared = fsquare(x - (startCoords[X_AXIS] + (endCoords[X_AXIS] - startCoords[X_AXIS]) * t))
+									+ fsquare(y - (startCoords[Y_AXIS] + (endCoords[Y_AXIS] - startCoords[Y_AXIS]) * t));
+		maxErrorSquared = max<float>(maxErrorSquared, errorSquared);
+	}
+	return fastSqrtf(maxErrorSquared);
+}
+
 // Return true if the specified XY position is reachable by the print head reference point
 bool ScaraKinematics::IsReachable(float axesCoords[MaxAxes], AxesBitmap axes) const noexcept
 {
@@ -43,6 +43,7 @@ public:
 	void OnHomingSwitchTriggered(size_t axis, bool highEnd, const float stepsPerMm[], DDA& dda) const noexcept override;
 	bool IsContinuousRotationAxis(size_t axis) const noexcept override;
 	AxesBitmap GetLinearAxes() const noexcept override;
+	float GetUnsegmentedPathError(const float startCoords[], const float endCoords[]) const noexcept override;
 
 protected:
 	DECLARE_OBJECT_MODEL
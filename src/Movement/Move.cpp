@@ -81,6 +81,24 @@ constexpr ObjectModelArrayDescriptor Move::queueArrayDescriptor =
 	[] (const ObjectModel *self, ObjectExplorationContext& context) noexcept -> ExpressionValue { return ExpressionValue(&((const Move*)self)->rings[context.GetLastIndex()]); }
 };
 
+#if STEP_TIMING_HISTOGRAM
+
+static constexpr ObjectModelArrayDescriptor stepLatenessArrayDescriptor =
+{
+	nullptr,					// no lock needed
+	[] (const ObjectModel *self, const ObjectExplorationContext&) noexcept -> size_t { return StepTimer::NumTimingBuckets; },
+	[] (const ObjectModel *self, ObjectExplorationContext& context) noexcept -> ExpressionValue { return ExpressionValue((int32_t)StepTimer::GetLatenessCount(context.GetLastIndex())); }
+};
+
+static constexpr ObjectModelArrayDescriptor stepDurationArrayDescriptor =
+{
+	nullptr,					// no lock needed
+	[] (const ObjectModel *self, const ObjectExplorationContext&) noexcept -> size_t { return StepTimer::NumTimingBuckets; },
+	[] (const ObjectModel *self, ObjectExplorationContext& context) noexcept -> ExpressionValue { return ExpressionValue((int32_t)StepTimer::GetDurationCount(context.GetLastIndex())); }
+};
+
+#endif
+
 #if SUPPORT_COORDINATE_ROTATION
 
 constexpr ObjectModelArrayDescriptor Move::rotationCentreArrayDescriptor =
@@ -102,6 +120,7 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 	{ "currentMove",			OBJECT_MODEL_FUNC(self, 2),																		ObjectModelEntryFlags::live },
 	{ "extruders",				OBJECT_MODEL_FUNC_NOSELF(&extrudersArrayDescriptor),											ObjectModelEntryFlags::live },
 	{ "idle",					OBJECT_MODEL_FUNC(self, 1),																		ObjectModelEntryFlags::none },
+	{ "inputQueue",				OBJECT_MODEL_FUNC(self, 9 + SUPPORT_COORDINATE_ROTATION),										ObjectModelEntryFlags::live },
 	{ "kinematics",				OBJECT_MODEL_FUNC(self->kinematics),															ObjectModelEntryFlags::none },
 	{ "limitAxes",				OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().LimitAxes()),										ObjectModelEntryFlags::none },
 	{ "noMovesBeforeHoming",	OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().NoMovesBeforeHoming()),								ObjectModelEntryFlags::none },
@@ -112,6 +131,9 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 #endif
 	{ "shaping",				OBJECT_MODEL_FUNC(&self->axisShaper, 0),														ObjectModelEntryFlags::none },
 	{ "speedFactor",			OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().GetSpeedFactor(), 2),								ObjectModelEntryFlags::none },
+#if STEP_TIMING_HISTOGRAM
+	{ "stepTiming",				OBJECT_MODEL_FUNC(self, 10 + SUPPORT_COORDINATE_ROTATION),										ObjectModelEntryFlags::live },
+#endif
 	{ "travelAcceleration",		OBJECT_MODEL_FUNC(InverseConvertAcceleration(self->maxTravelAcceleration), 1),					ObjectModelEntryFlags::none },
 	{ "virtualEPos",			OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().GetVirtualExtruderPosition(), 5),					ObjectModelEntryFlags::live },
 	{ "workplaceNumber",		OBJECT_MODEL_FUNC_NOSELF((int32_t)reprap.GetGCodes().GetWorkplaceCoordinateSystemNumber() - 1),	ObjectModelEntryFlags::none },
@@ -170,12 +192,26 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 	{ "angle",					OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().GetRotationAngle()),								ObjectModelEntryFlags::none },
 	{ "centre",					OBJECT_MODEL_FUNC_NOSELF(&rotationCentreArrayDescriptor),										ObjectModelEntryFlags::none },
 #endif
+
+	// 9 or 10. move.inputQueue members
+	{ "length",					OBJECT_MODEL_FUNC((int32_t)self->rawMoveQueue.Capacity()),										ObjectModelEntryFlags::none },
+	{ "maxUsed",				OBJECT_MODEL_FUNC((int32_t)self->rawMoveQueue.GetMaxOccupancy()),								ObjectModelEntryFlags::live },
+	{ "stalls",					OBJECT_MODEL_FUNC((int32_t)self->rawMoveQueue.GetNumStalls()),									ObjectModelEntryFlags::live },
+	{ "used",					OBJECT_MODEL_FUNC((int32_t)self->rawMoveQueue.Count()),											ObjectModelEntryFlags::live },
+
+#if STEP_TIMING_HISTOGRAM
+	// 10 or 11. move.stepTiming members
+	{ "isrDuration",			OBJECT_MODEL_FUNC_NOSELF(&stepDurationArrayDescriptor),											ObjectModelEntryFlags::live },
+	{ "lateness",				OBJECT_MODEL_FUNC_NOSELF(&stepLatenessArrayDescriptor),											ObjectModelEntryFlags::live },
+	{ "maxIsrDuration",			OBJECT_MODEL_FUNC_NOSELF((int32_t)StepTimer::GetMaxDuration()),									ObjectModelEntryFlags::live },
+	{ "maxLateness",			OBJECT_MODEL_FUNC_NOSELF((int32_t)StepTimer::GetMaxLateness()),									ObjectModelEntryFlags::live },
+#endif
 };
 
 constexpr uint8_t Move::objectModelTableDescriptor[] =
 {
-	9 + SUPPORT_COORDINATE_ROTATION,
-	17 + SUPPORT_WORKPLACE_COORDINATES,
+	10 + SUPPORT_COORDINATE_ROTATION + STEP_TIMING_HISTOGRAM,
+	18 + SUPPORT_WORKPLACE_COORDINATES + STEP_TIMING_HISTOGRAM,
 	2,
 	4 + SUPPORT_LASER,
 	3,
@@ -185,7 +221,11 @@ constexpr uint8_t Move::objectModelTableDescriptor[] =
 	2,
 	4,
 #if SUPPORT_COORDINATE_ROTATION
-	2
+	2,
+#endif
+	4,
+#if STEP_TIMING_HISTOGRAM
+	4,
 #endif
 };
 
@@ -203,7 +243,7 @@ Move::Move() noexcept
 	  heightController(nullptr),
 #endif
 	  maxPrintingAcceleration(ConvertAcceleration(DefaultPrintingAcceleration)), maxTravelAcceleration(ConvertAcceleration(DefaultTravelAcceleration)),
-	  jerkPolicy(0),
+	  jerkPolicy(0), junctionDeviation(0.0),
 	  numCalibratedFactors(0)
 {
 	// Kinematics must be set up here because GCodes::Init asks the kinematics for the assumed initial position
@@ -217,6 +257,9 @@ Move::Move() noexcept
 
 void Move::Init() noexcept
 {
+#if SUPPORT_STEP_EDGE_BUFFER
+	StepEdgeBuffer::Init();
+#endif
 	mainDDARing.Init2();
 
 #if SUPPORT_ASYNC_MOVES
@@ -229,6 +272,7 @@ void Move::Init() noexcept
 	SetIdentityTransform();
 	compensateXY = true;
 	tangents[0] = tangents[1] = tangents[2] = 0.0;
+	usingSkewCompensation = false;
 
 	usingMesh = useTaper = false;
 	zShift = 0.0;
@@ -240,6 +284,10 @@ void Move::Init() noexcept
 	simulationMode = SimulationMode::off;
 	longestGcodeWaitInterval = 0;
 	bedLevellingMoveAvailable = false;
+	moveMergeTolerance = 0.0;
+	moveMergeExtrusionTolerance = DefaultMoveMergeExtrusionTolerance;
+	numMovesMerged = 0;
+	rawMovesInTransit = 0;
 
 	moveTask.Create(MoveStart, "Move", this, TaskPriority::MovePriority);
 }
@@ -296,18 +344,33 @@ void Move::Exit() noexcept
 			else
 			{
 				// If there's a G Code move available, add it to the DDA ring for processing.
+				// Moves in the raw move queue were set up before any move that GCodes is still holding, so take those first.
 				RawMove nextMove;
-				if (reprap.GetGCodes().ReadMove(nextMove))				// if we have a new move
+				bool haveMove = rawMoveQueue.Get(nextMove);
+				if (haveMove)
+				{
+					rawMovesInTransit = 1;							// keep counting this move until it has been added to the ring
+				}
+				else
+				{
+					haveMove = reprap.GetGCodes().ReadMove(nextMove);
+				}
+				if (haveMove)										// if we have a new move
 				{
 					moveRead = true;
 					if (simulationMode < SimulationMode::partial)		// in simulation mode partial, we don't process incoming moves beyond this point
 					{
+						unsigned int numMerged = 0;
 						if (nextMove.moveType == 0)
 						{
 							AxisAndBedTransform(nextMove.coords, nextMove.tool, true);
+							if (moveMergeTolerance > 0.0 && !nextMove.checkEndstops)
+							{
+								numMerged = MergeQueuedMoves(nextMove);
+							}
 						}
 
-						if (mainDDARing.AddStandardMove(nextMove, !IsRawMotorMove(nextMove.moveType)))
+						if (mainDDARing.AddStandardMove(nextMove, !IsRawMotorMove(nextMove.moveType), numMerged + 1))
 						{
 							const uint32_t now = millis();
 							const uint32_t timeWaiting = now - whenLastMoveAdded;
@@ -319,6 +382,7 @@ void Move::Exit() noexcept
 							moveState = MoveState::collecting;
 						}
 					}
+					rawMovesInTransit = 0;
 				}
 			}
 		}
@@ -400,7 +464,8 @@ void Move::MoveAvailable() noexcept
 // Tell the lookahead ring we are waiting for it to empty and return true if it is
 bool Move::WaitingForAllMovesFinished() noexcept
 {
-	return mainDDARing.SetWaitingToEmpty();
+	const bool ringEmpty = mainDDARing.SetWaitingToEmpty();
+	return ringEmpty && rawMoveQueue.IsEmpty();
 }
 
 // Return the number of actually probed probe points
@@ -450,10 +515,46 @@ bool Move::IsAccessibleProbePoint(float axesCoords[MaxAxes], AxesBitmap axes) co
 	return kinematics->IsReachable(axesCoords, axes);
 }
 
+// Return the number of moves scheduled, including those in the raw move queue and any that the Move task has taken from the queue but not yet added to the ring.
+// The Move task has a higher priority than the tasks that call this and doesn't block while it moves a move from the queue to the ring, so locking it out gives us a consistent snapshot.
+uint32_t Move::GetScheduledMoves() const noexcept
+{
+	TaskCriticalSectionLocker lock;
+	return mainDDARing.GetScheduledMoves() + rawMoveQueue.Count() + rawMovesInTransit;
+}
+
 // Pause the print as soon as we can, returning true if we are able to skip any moves and updating 'rp' to the first move we skipped.
 bool Move::PausePrint(RestorePoint& rp) noexcept
 {
-	return mainDDARing.PauseMoves(rp);
+	TaskCriticalSectionLocker lock;						// prevent the Move task taking moves from the raw move queue while we look at it
+	return SkipQueuedRawMoves(rp, mainDDARing.PauseMoves(rp));
+}
+
+// Deal with the moves in the raw move queue when we pause, returning true if any moves have been skipped.
+// If the DDA ring skipped some moves then the queued moves follow those, so we just discard them.
+// Otherwise we can pause before the first queued move, because the queue only holds complete single-segment moves.
+bool Move::SkipQueuedRawMoves(RestorePoint& rp, bool ringSkippedMoves) noexcept
+{
+	if (!ringSkippedMoves && !rawMoveQueue.IsEmpty())
+	{
+		const RawMove& m = rawMoveQueue.Peek();
+		mainDDARing.GetLastMoveEndCoordinates(rp);
+		rp.proportionDone = 0.0;
+		rp.initialUserC0 = m.initialUserC0;
+		rp.initialUserC1 = m.initialUserC1;
+		if (m.usingStandardFeedrate)
+		{
+			rp.feedRate = m.feedRate;
+		}
+		rp.virtualExtruderPosition = m.virtualExtruderPosition;
+		rp.filePos = m.filePos;
+#if SUPPORT_LASER || SUPPORT_IOBITS
+		rp.laserPwmOrIoBits = m.laserPwmOrIoBits;
+#endif
+		ringSkippedMoves = true;
+	}
+	rawMoveQueue.Clear();
+	return ringSkippedMoves;
 }
 
 #if HAS_VOLTAGE_MONITOR || HAS_STALL_DETECT
@@ -461,7 +562,8 @@ bool Move::PausePrint(RestorePoint& rp) noexcept
 // Pause the print immediately, returning true if we were able to skip or abort any moves and setting up to the move we aborted
 bool Move::LowPowerOrStallPause(RestorePoint& rp) noexcept
 {
-	return mainDDARing.LowPowerOrStallPause(rp);
+	TaskCriticalSectionLocker lock;						// prevent the Move task taking moves from the raw move queue while we look at it
+	return SkipQueuedRawMoves(rp, mainDDARing.LowPowerOrStallPause(rp));
 }
 
 #endif
@@ -477,10 +579,32 @@ void Move::Diagnostics(MessageType mtype) noexcept
 	scratchString.copy(GetCompensationTypeString());
 
 	Platform& p = reprap.GetPlatform();
-	p.MessageF(mtype, "=== Move ===\nDMs created %u, segments created %u, maxWait %" PRIu32 "ms, bed compensation in use: %s, comp offset %.3f\n",
-						DriveMovement::NumCreated(), MoveSegment::NumCreated(), longestGcodeWaitInterval, scratchString.c_str(), (double)zShift);
+	p.MessageF(mtype, "=== Move ===\nDMs created %u (%u bytes), segments created %u (min free %u, created on demand %u), maxWait %" PRIu32 "ms, bed compensation in use: %s, comp offset %.3f\n",
+						DriveMovement::NumCreated(), DriveMovement::NumCreated() * sizeof(DriveMovement),
+						MoveSegment::NumCreated(), MoveSegment::GetAndClearMinFree(), MoveSegment::GetAndClearNumCreatedOnDemand(), longestGcodeWaitInterval, scratchString.c_str(), (double)zShift);
 	longestGcodeWaitInterval = 0;
 
+	p.MessageF(mtype, "Raw move queue length %u, max used %u, stalls %" PRIu32 ", moves merged %" PRIu32 "\n",
+						rawMoveQueue.Capacity(), rawMoveQueue.GetMaxOccupancy(), rawMoveQueue.GetNumStalls(), numMovesMerged);
+	rawMoveQueue.ResetStatistics();
+	numMovesMerged = 0;
+
+#if CHECK_FIXED_POINT_STEP_TIMES
+	DriveMovement::FixedPointDiagnostics(mtype);
+#endif
+
+#if SUPPORT_STEP_EDGE_BUFFER
+	StepEdgeBuffer::Diagnostics(mtype);
+#endif
+
+#if INPUT_SHAPING_CACHE_ENTRIES
+	axisShaper.Diagnostics(mtype);
+#endif
+
+#if STEP_TIMING_HISTOGRAM
+	StepTimer::TimingDiagnostics(mtype);
+#endif
+
 #if 0	// debug only
 	scratchString.copy("Steps requested/done:");
 	for (size_t driver = 0; driver < NumDirectDrivers; ++driver)
@@ -605,6 +729,11 @@ void Move::InverseAxisAndBedTransform(float xyzPoint[MaxAxes], const Tool *tool)
 // Do the Axis transform BEFORE the bed transform
 void Move::AxisTransform(float xyzPoint[MaxAxes], const Tool *tool) const noexcept
 {
+	if (!usingSkewCompensation)
+	{
+		return;						// nothing to do, so don't waste time looking up the tool axis mapping
+	}
+
 	// Identify the lowest Y axis
 	const size_t numVisibleAxes = reprap.GetGCodes().GetVisibleAxes();
 	const AxesBitmap yAxes = Tool::GetYAxes(tool);
@@ -631,6 +760,11 @@ void Move::AxisTransform(float xyzPoint[MaxAxes], const Tool *tool) const noexce
 // Invert the Axis transform AFTER the bed transform
 void Move::InverseAxisTransform(float xyzPoint[MaxAxes], const Tool *tool) const noexcept
 {
+	if (!usingSkewCompensation)
+	{
+		return;						// nothing to do, so don't waste time looking up the tool axis mapping
+	}
+
 	// Identify the lowest Y axis
 	const size_t numVisibleAxes = reprap.GetGCodes().GetVisibleAxes();
 	const AxesBitmap yAxes = Tool::GetYAxes(tool);
@@ -699,6 +833,18 @@ void Move::BedTransform(float xyzPoint[MaxAxes], const Tool *tool) const noexcep
 	}
 }
 
+// Return true if mesh compensation is tapered off completely for a straight move between these heights, so there is no need to segment it.
+// The heights are before applying the tool Z offset, as in BedTransform.
+bool Move::IsAboveTaperHeight(float startZ, float endZ, const Tool *tool) const noexcept
+{
+	if (!useTaper)
+	{
+		return false;
+	}
+	const float toolZOffset = Tool::GetOffset(tool, Z_AXIS);
+	return startZ + toolZOffset >= taperHeight && endZ + toolZOffset >= taperHeight;
+}
+
 // Invert the bed transform BEFORE the axis transform
 void Move::InverseBedTransform(float xyzPoint[MaxAxes], const Tool *tool) const noexcept
 {
@@ -805,6 +951,7 @@ void Move::SetAxisCompensation(unsigned int axis, float tangent) noexcept
 	if (axis < ARRAY_SIZE(tangents))
 	{
 		tangents[axis] = tangent;
+		usingSkewCompensation = (tangents[0] != 0.0 || tangents[1] != 0.0 || tangents[2] != 0.0);
 		reprap.MoveUpdated();
 	}
 }
@@ -1014,7 +1161,155 @@ GCodeResult Move::ConfigureAccelerations(GCodeBuffer&gb, const StringRef& reply)
 GCodeResult Move::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
 {
 	const size_t ringNumber = (gb.Seen('Q')) ? gb.GetLimitedUIValue('Q', ARRAY_SIZE(rings)) : 0;
-	return rings[ringNumber].ConfigureMovementQueue(gb, reply);
+	if (ringNumber == 0)
+	{
+		// Move merging only applies to the main ring
+		bool seen = false;
+		float tolerance = moveMergeTolerance, extrusionTolerance = moveMergeExtrusionTolerance;
+		gb.TryGetFValue('D', tolerance, seen);
+		gb.TryGetFValue('E', extrusionTolerance, seen);
+		if (seen)
+		{
+			if (tolerance < 0.0 || extrusionTolerance < 0.0)
+			{
+				reply.copy("merge tolerances must not be negative");
+				return GCodeResult::error;
+			}
+			moveMergeTolerance = tolerance;
+			moveMergeExtrusionTolerance = extrusionTolerance;
+		}
+	}
+
+	const GCodeResult rslt = rings[ringNumber].ConfigureMovementQueue(gb, reply);
+	if (ringNumber == 0 && rslt == GCodeResult::ok && !reply.IsEmpty())
+	{
+		if (moveMergeTolerance > 0.0)
+		{
+			reply.catf(", merge tolerance %.3fmm, extrusion tolerance %.3f", (double)moveMergeTolerance, (double)moveMergeExtrusionTolerance);
+		}
+		else
+		{
+			reply.cat(", move merging disabled");
+		}
+	}
+	return rslt;
+}
+
+// Return true if two moves from the raw move queue have the same properties apart from their coordinates, so that they can be executed as a single move
+static bool CanMergeMoves(const RawMove& first, const RawMove& second) noexcept
+{
+	return    second.moveType == 0
+		   && !second.checkEndstops
+		   && second.filePos != noFilePosition
+		   && second.tool == first.tool
+		   && second.feedRate == first.feedRate
+		   && second.applyM220M221 == first.applyM220M221
+		   && second.usePressureAdvance == first.usePressureAdvance
+		   && second.hasPositiveExtrusion == first.hasPositiveExtrusion
+		   && second.isCoordinated == first.isCoordinated
+		   && second.usingStandardFeedrate == first.usingStandardFeedrate
+		   && second.reduceAcceleration == first.reduceAcceleration
+		   && second.linearAxesMentioned == first.linearAxesMentioned
+		   && second.rotationalAxesMentioned == first.rotationalAxesMentioned
+#if SUPPORT_LASER || SUPPORT_IOBITS
+		   && memcmp(&second.laserPwmOrIoBits, &first.laserPwmOrIoBits, sizeof(LaserPwmOrIoBits)) == 0
+#endif
+		   ;
+}
+
+// Merge moves waiting in the raw move queue into nextMove if they continue in nearly the same direction with nearly the same extrusion per mm, so that they use only one DDA.
+// On entry, nextMove has already been transformed to machine coordinates. The moves in the queue have not.
+// Each merged move must end within moveMergeTolerance of the line along the direction of the original nextMove, so the merged move stays within about twice that of the original path.
+// We never merge a move that a queued code must be executed before, because that code is waiting for the preceding move to complete.
+// Return the number of queued moves merged.
+unsigned int Move::MergeQueuedMoves(RawMove& nextMove) noexcept
+{
+	unsigned int numMerged = 0;
+	const size_t numVisibleAxes = reprap.GetGCodes().GetVisibleAxes();
+	const size_t numTotalAxes = reprap.GetGCodes().GetTotalAxes();
+
+	float startCoords[MaxAxes];
+	mainDDARing.GetCurrentMachinePosition(startCoords, false);
+
+	// Get the direction of the original move
+	float direction[MaxAxes];
+	float mergedLengthSquared = 0.0;
+	for (size_t axis = 0; axis < numVisibleAxes; ++axis)
+	{
+		direction[axis] = nextMove.coords[axis] - startCoords[axis];
+		mergedLengthSquared += fsquare(direction[axis]);
+	}
+	if (mergedLengthSquared <= 0.0)
+	{
+		return 0;												// extruder-only move
+	}
+
+	float mergedLength = fastSqrtf(mergedLengthSquared);
+	const float recipLength = 1.0/mergedLength;
+	for (size_t axis = 0; axis < numVisibleAxes; ++axis)
+	{
+		direction[axis] *= recipLength;
+	}
+
+	const float toleranceSquared = fsquare(moveMergeTolerance);
+	float candidateCoords[MaxAxes];
+	while (!rawMoveQueue.IsEmpty())
+	{
+		const RawMove& candidate = rawMoveQueue.Peek();
+		if (candidate.mergeBarrier || !CanMergeMoves(nextMove, candidate))
+		{
+			break;
+		}
+
+		memcpyf(candidateCoords, candidate.coords, MaxAxes);
+		AxisAndBedTransform(candidateCoords, candidate.tool, true);
+
+		// Check that the end of the candidate lies close to the line of the original move, and further along it than the end of the move so far
+		float distanceAlongLine = 0.0, distanceSquared = 0.0, candidateLengthSquared = 0.0;
+		for (size_t axis = 0; axis < numVisibleAxes; ++axis)
+		{
+			const float d = candidateCoords[axis] - startCoords[axis];
+			distanceAlongLine += d * direction[axis];
+			distanceSquared += fsquare(d);
+			candidateLengthSquared += fsquare(candidateCoords[axis] - nextMove.coords[axis]);
+		}
+		if (distanceAlongLine <= mergedLength || distanceSquared - fsquare(distanceAlongLine) > toleranceSquared)
+		{
+			break;
+		}
+
+		// Check that the extrusion per mm is nearly the same
+		const float candidateLength = fastSqrtf(candidateLengthSquared);
+		bool extrusionMatches = true;
+		for (size_t drive = numTotalAxes; drive < MaxAxesPlusExtruders; ++drive)
+		{
+			const float mergedRate = nextMove.coords[drive]/mergedLength;
+			if (fabsf(candidate.coords[drive]/candidateLength - mergedRate) > moveMergeExtrusionTolerance * fabsf(mergedRate))
+			{
+				extrusionMatches = false;
+				break;
+			}
+		}
+		if (!extrusionMatches)
+		{
+			break;
+		}
+
+		// Merge the candidate into nextMove. We keep the file position and virtual extruder position of the original move, because if we pause before this move completes then we must resume from there.
+		memcpyf(nextMove.coords, candidateCoords, numVisibleAxes);
+		for (size_t drive = numTotalAxes; drive < MaxAxesPlusExtruders; ++drive)
+		{
+			nextMove.coords[drive] += candidate.coords[drive];
+		}
+		nextMove.proportionDone = candidate.proportionDone;
+		nextMove.canPauseAfter = candidate.canPauseAfter;
+		mergedLength = fastSqrtf(distanceSquared);
+		rawMoveQueue.Discard();
+		++rawMovesInTransit;									// it is still counted as scheduled until we add the merged move to the ring
+		++numMerged;
+		++numMovesMerged;
+	}
+	return numMerged;
 }
 
 // Process M572
@@ -13,6 +13,7 @@
 #include "ExtruderShaper.h"
 #include "DDARing.h"
 #include "DDA.h"								// needed because of our inline functions
+#include "RawMoveQueue.h"
 #include "BedProbing/RandomProbePointSet.h"
 #include "BedProbing/Grid.h"
 #include "Kinematics/Kinematics.h"
@@ -85,6 +86,7 @@ public:
 	void SetTaperHeight(float h) noexcept;
 	bool UseMesh(bool b) noexcept;											// Try to enable mesh bed compensation and report the final state
 	bool IsUsingMesh() const noexcept { return usingMesh; }					// Return true if we are using mesh compensation
+	bool IsAboveTaperHeight(float startZ, float endZ, const Tool *tool) const noexcept;	// Return true if a move between these heights gets no mesh compensation
 	unsigned int GetNumProbedProbePoints() const noexcept;					// Return the number of actually probed probe points
 	void SetLatestCalibrationDeviation(const Deviation& d, uint8_t numFactors) noexcept;
 	void SetInitialCalibrationDeviation(const Deviation& d) noexcept;
@@ -139,9 +141,11 @@ public:
 	bool LowPowerOrStallPause(RestorePoint& rp) noexcept;									// Pause the print immediately, returning true if we were able to
 #endif
 
-	bool NoLiveMovement() const noexcept { return mainDDARing.IsIdle(); }					// Is a move running, or are there any queued?
+	bool NoLiveMovement() const noexcept { return mainDDARing.IsIdle() && rawMoveQueue.IsEmpty(); }	// Is a move running, or are there any queued?
 
-	uint32_t GetScheduledMoves() const noexcept { return mainDDARing.GetScheduledMoves(); }	// How many moves have been scheduled?
+	RawMoveQueue& GetRawMoveQueue() noexcept { return rawMoveQueue; }						// Get the queue of moves waiting to be added to the main DDA ring
+
+	uint32_t GetScheduledMoves() const noexcept;											// How many moves have been scheduled, including queued raw moves?
 	uint32_t GetCompletedMoves() const noexcept { return mainDDARing.GetCompletedMoves(); }	// How many moves have been completed?
 	void ResetMoveCounters() noexcept { mainDDARing.ResetMoveCounters(); }
 
@@ -173,6 +177,8 @@ public:
 
 	unsigned int GetJerkPolicy() const noexcept { return jerkPolicy; }
 	void SetJerkPolicy(unsigned int jp) noexcept { jerkPolicy = jp; }
+	float GetJunctionDeviation() const noexcept { return junctionDeviation; }
+	void SetJunctionDeviation(float jd) noexcept { junctionDeviation = max<float>(jd, 0.0); }
 
 #if HAS_SMART_DRIVERS
 	uint32_t GetStepInterval(size_t axis, uint32_t microstepShift) const noexcept;			// Get the current step interval for this axis or extruder
@@ -247,11 +253,15 @@ private:
 	float ComputeHeightCorrection(float xyzPoint[MaxAxes], const Tool *tool) const noexcept;	// Compute the height correction needed at a point, ignoring taper
 
 	const char *GetCompensationTypeString() const noexcept;
+	bool SkipQueuedRawMoves(RestorePoint& rp, bool ringSkippedMoves) noexcept;
+	unsigned int MergeQueuedMoves(RawMove& nextMove) noexcept;
 
 	// Move task stack size
 	// 250 is not enough when Move and DDA debug are enabled
 	// deckingman's system (MB6HC with CAN expansion) needs at least 365 in 3.3beta3
 	static constexpr unsigned int MoveTaskStackWords = 450;
+
+	static constexpr float DefaultMoveMergeExtrusionTolerance = 0.01;
 	static Task<MoveTaskStackWords> moveTask;
 
 #if SUPPORT_ASYNC_MOVES
@@ -266,6 +276,8 @@ private:
 #endif
 
 	DDARing& mainDDARing = rings[0];					// The DDA ring used for regular moves
+	RawMoveQueue rawMoveQueue;							// Moves passed from GCodes that are waiting to be added to the main DDA ring
+	volatile unsigned int rawMovesInTransit;			// How many moves the Move task has taken from rawMoveQueue but not yet added to the main DDA ring
 
 	SimulationMode simulationMode;						// Are we simulating, or really printing?
 	MoveState moveState;								// whether the idle timer is active
@@ -274,6 +286,7 @@ private:
 	float maxTravelAcceleration;
 
 	unsigned int jerkPolicy;							// When we allow jerk
+	float junctionDeviation;							// If nonzero, the junction deviation in mm used to limit cornering speed instead of the axis jerk limits
 	unsigned int idleCount;								// The number of times Spin was called and had no new moves to process
 
 	uint32_t whenLastMoveAdded;							// The time when we last added a move to the main DDA ring
@@ -282,8 +295,13 @@ private:
 	uint32_t idleTimeout;								// How long we wait with no activity before we reduce motor currents to idle, in milliseconds
 	uint32_t longestGcodeWaitInterval;					// the longest we had to wait for a new GCode
 
+	float moveMergeTolerance;							// how far in mm the end of a merged move may be from the line of the first move merged, or 0 to disable merging
+	float moveMergeExtrusionTolerance;					// the maximum fractional difference in extrusion per mm between merged moves
+	uint32_t numMovesMerged;							// how many moves we merged into the previous one, for diagnostics
+
 	float tangents[3]; 									// Axis compensation - 90 degrees + angle gives angle between axes
 	bool compensateXY;									// If true then we compensate for XY skew by adjusting the Y coordinate; else we adjust the X coordinate
+	bool usingSkewCompensation;							// True if any of the tangents is nonzero, so that the axis transforms have something to do
 
 	float tanXY() const noexcept { return tangents[0]; }
 	float tanYZ() const noexcept { return tangents[1]; }
@@ -11,16 +11,37 @@
 
 MoveSegment *MoveSegment::freeList = nullptr;
 unsigned int MoveSegment::numCreated = 0;
+unsigned int MoveSegment::numFree = 0;
+unsigned int MoveSegment::minFree = 0;
+unsigned int MoveSegment::numCreatedOnDemand = 0;
 
+// Make sure that at least the specified number of segments have been created.
+// The new segments go into the free list, so they raise the low-water mark too.
 void MoveSegment::InitialAllocate(unsigned int num) noexcept
 {
 	while (num > numCreated)
 	{
 		freeList = new MoveSegment(freeList);
 		++numCreated;
+		++numFree;
+		++minFree;
 	}
 }
 
+unsigned int MoveSegment::GetAndClearMinFree() noexcept
+{
+	const unsigned int ret = minFree;
+	minFree = numFree;
+	return ret;
+}
+
+unsigned int MoveSegment::GetAndClearNumCreatedOnDemand() noexcept
+{
+	const unsigned int ret = numCreatedOnDemand;
+	numCreatedOnDemand = 0;
+	return ret;
+}
+
 // Allocate a MoveSegment, from the freelist if possible, else create a new one. Not thread-safe. Clears the flags.
 MoveSegment *MoveSegment::Allocate(MoveSegment *next) noexcept
 {
@@ -29,11 +50,17 @@ MoveSegment *MoveSegment::Allocate(MoveSegment *next) noexcept
 	{
 		freeList = ms->GetNext();
 		ms->nextAndFlags = reinterpret_cast<uint32_t>(next);
+		--numFree;
+		if (numFree < minFree)
+		{
+			minFree = numFree;
+		}
 	}
 	else
 	{
 		ms = new MoveSegment(next);
 		++numCreated;
+		++numCreatedOnDemand;
 	}
 	return ms;
 }
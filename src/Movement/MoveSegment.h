@@ -175,6 +175,11 @@ public:
 
 	static void InitialAllocate(unsigned int num) noexcept;
 	static unsigned int NumCreated() noexcept { return numCreated; }
+	static unsigned int NumFree() noexcept { return numFree; }
+	static unsigned int GetAndClearMinFree() noexcept;
+	static unsigned int GetAndClearNumCreatedOnDemand() noexcept;
+
+	static constexpr unsigned int NumShapedMovesToPreallocate = 6;				// how many moves we preallocate segments for when input shaping is configured
 
 	static constexpr unsigned int SFdistance = 10;
 	static constexpr unsigned int SFstepsPerMm = 16;
@@ -194,6 +199,9 @@ private:
 
 	static MoveSegment *freeList;
 	static unsigned int numCreated;
+	static unsigned int numFree;												// how many segments are in the free list
+	static unsigned int minFree;												// the lowest value of numFree since we last reported it
+	static unsigned int numCreatedOnDemand;										// how many segments we had to create because the free list was empty
 
 	static_assert(sizeof(MoveSegment*) == sizeof(uint32_t));
 
@@ -292,6 +300,7 @@ inline void MoveSegment::Release(MoveSegment *item) noexcept
 {
 	item->nextAndFlags = reinterpret_cast<uint32_t>(freeList);
 	freeList = item;
+	++numFree;
 }
 
 #endif /* SRC_MOVEMENT_MOVESEGMENT_H_ */
@@ -0,0 +1,58 @@
+/*
+ * MoveTrace.cpp
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ */
+
+#include "MoveTrace.h"
+
+#if SUPPORT_MOVE_TRACE
+
+#include "StepTimer.h"
+#include <Platform/RepRap.h>
+#include <Platform/Platform.h>
+
+MoveTrace::Entry MoveTrace::entries[NumEntries];
+size_t MoveTrace::nextEntry = 0;
+bool MoveTrace::wrapped = false;
+
+void MoveTrace::Record(Event ev, uint32_t data) noexcept
+{
+	const irqflags_t flags = IrqSave();
+	Entry& e = entries[nextEntry];
+	e.when = StepTimer::GetTimerTicks();
+	e.data = data;
+	e.event = ev;
+	nextEntry = (nextEntry + 1) & (NumEntries - 1);
+	if (nextEntry == 0)
+	{
+		wrapped = true;
+	}
+	IrqRestore(flags);
+}
+
+void MoveTrace::Print(MessageType mtype) noexcept
+{
+	static const char *_ecv_array const EventNames[] = { "prepare", "start", "complete", "recalc", "hiccup", "endstop", "canSend" };
+
+	// Take a copy of the indices, then print. Events recorded while we are printing may overwrite the oldest ones.
+	const irqflags_t flags = IrqSave();
+	size_t index = (wrapped) ? nextEntry : 0;
+	const size_t count = (wrapped) ? NumEntries : nextEntry;
+	IrqRestore(flags);
+
+	Platform& p = reprap.GetPlatform();
+	p.MessageF(mtype, "Move trace, %u events, now %" PRIu32 "\nclocks,event,data\n", count, StepTimer::GetTimerTicks());
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Entry& e = entries[index];
+		const size_t eventNumber = (size_t)e.event;
+		p.MessageF(mtype, "%" PRIu32 ",%s,%08" PRIx32 "\n", e.when, (eventNumber < ARRAY_SIZE(EventNames)) ? EventNames[eventNumber] : "?", e.data);
+		index = (index + 1) & (NumEntries - 1);
+	}
+}
+
+#endif
+
+// End
@@ -0,0 +1,62 @@
+/*
+ * MoveTrace.h
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ *
+ * This class records a short history of timestamped motion events in RAM, so that the causes of stutters can be found without the overhead of printing moves.
+ * The events are recorded with the step clock time and can be printed using M122 P110. When SUPPORT_MOVE_TRACE is zero, recording an event generates no code.
+ */
+
+#ifndef SRC_MOVEMENT_MOVETRACE_H_
+#define SRC_MOVEMENT_MOVETRACE_H_
+
+#include <RepRapFirmware.h>
+
+#ifndef SUPPORT_MOVE_TRACE
+# define SUPPORT_MOVE_TRACE		0
+#endif
+
+class MoveTrace
+{
+public:
+	enum class Event : uint8_t
+	{
+		prepare = 0,				// data is the DDA address
+		start,						// data is the DDA address
+		complete,					// data is the DDA address
+		recalculate,				// lookahead recalculated the move, data is the DDA address
+		hiccup,						// data is the hiccup length in step clocks
+		endstopHit,					// data is the axis in the low byte and the driver in the next byte
+		canSend,					// data is the number of step clocks that the CAN move will take
+	};
+
+#if SUPPORT_MOVE_TRACE
+	// Record an event. May be called from any task or ISR.
+	static void Record(Event ev, uint32_t data) noexcept SPEED_CRITICAL;
+
+	// Print the recorded events, oldest first
+	static void Print(MessageType mtype) noexcept;
+
+	static constexpr size_t NumEntries = 256;						// must be a power of 2
+
+private:
+	struct Entry
+	{
+		uint32_t when;												// the step clock when the event was recorded
+		uint32_t data;
+		Event event;
+	};
+
+	static_assert((NumEntries & (NumEntries - 1)) == 0);
+
+	static Entry entries[NumEntries];
+	static size_t nextEntry;
+	static bool wrapped;
+#else
+	static void Record(Event ev, uint32_t data) noexcept { }
+	static void Print(MessageType mtype) noexcept { }
+#endif
+};
+
+#endif /* SRC_MOVEMENT_MOVETRACE_H_ */
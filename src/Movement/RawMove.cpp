@@ -20,6 +20,7 @@ void RawMove::SetDefaults(size_t firstDriveToZero) noexcept
 	hasPositiveExtrusion = false;
 	linearAxesMentioned = false;
 	rotationalAxesMentioned = false;
+	mergeBarrier = false;
 	filePos = noFilePosition;
 	tool = nullptr;
 	cosXyAngle = 1.0;
@@ -31,7 +31,8 @@ struct RawMove
 			checkEndstops : 1,										// true if any endstops or the Z probe can terminate the move
 			reduceAcceleration : 1,									// true if Z probing so we should limit the Z acceleration
 			linearAxesMentioned : 1,								// true if any linear axes were mentioned in the movement command
-			rotationalAxesMentioned: 1;								// true if any rotational axes were mentioned in the movement command
+			rotationalAxesMentioned: 1,								// true if any rotational axes were mentioned in the movement command
+			mergeBarrier : 1;										// true if a code was queued to execute before this move, so it must not be merged into the previous one
 
 #if SUPPORT_LASER || SUPPORT_IOBITS
 	LaserPwmOrIoBits laserPwmOrIoBits;								// the laser PWM or port bit settings required
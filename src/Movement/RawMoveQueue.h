@@ -0,0 +1,105 @@
+/*
+ * RawMoveQueue.h
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ *
+ * A lock-free single-producer, single-consumer queue of complete single-segment moves, passed from GCodes to Move.
+ * The producer is GCodes running in the Main task and the consumer is the Move task.
+ * This lets GCodes carry on processing commands while the Move task is busy, and lets the Move task take several moves each time it wakes up.
+ */
+
+#ifndef SRC_MOVEMENT_RAWMOVEQUEUE_H_
+#define SRC_MOVEMENT_RAWMOVEQUEUE_H_
+
+#include <RepRapFirmware.h>
+#include "RawMove.h"
+
+#if SAME70
+constexpr size_t RawMoveQueueLength = 8;
+#else
+constexpr size_t RawMoveQueueLength = 4;
+#endif
+
+class RawMoveQueue
+{
+public:
+	RawMoveQueue() noexcept : getIndex(0), putIndex(0), numStalls(0), maxOccupancy(0) { }
+
+	// Producer functions
+	bool IsFull() const noexcept { return Next(putIndex) == getIndex; }
+	bool Put(const RawMove& m) noexcept;
+	void RecordStall() noexcept { ++numStalls; }
+
+	// Consumer functions
+	bool IsEmpty() const noexcept { return getIndex == putIndex; }
+	const RawMove& Peek() const noexcept pre(!IsEmpty()) { return moves[getIndex]; }
+	bool Get(RawMove& m) noexcept;
+	void Discard() noexcept pre(!IsEmpty());												// remove the move at the head of the queue without copying it
+
+	// Discard all queued moves. Only call this when both the producer and the consumer are locked out, e.g. when pausing.
+	void Clear() noexcept { getIndex = putIndex; }
+
+	// Statistics
+	size_t Count() const noexcept { return (putIndex + NumSlots - getIndex) % NumSlots; }
+	static constexpr size_t Capacity() noexcept { return NumSlots - 1; }
+	uint32_t GetNumStalls() const noexcept { return numStalls; }
+	size_t GetMaxOccupancy() const noexcept { return maxOccupancy; }
+	void ResetStatistics() noexcept { numStalls = 0; maxOccupancy = 0; }
+
+private:
+	static constexpr size_t NumSlots = RawMoveQueueLength + 1;								// one slot is always left empty so that we can distinguish full from empty
+
+	static size_t Next(size_t index) noexcept { return (index + 1 == NumSlots) ? 0 : index + 1; }
+
+	RawMove moves[NumSlots];
+	volatile size_t getIndex;																// only written by the consumer
+	volatile size_t putIndex;																// only written by the producer
+	uint32_t numStalls;																		// how many times the producer had a move ready but the queue was full
+	size_t maxOccupancy;																	// the maximum number of moves we have seen in the queue
+};
+
+// Add a move to the queue, returning true if successful
+inline bool RawMoveQueue::Put(const RawMove& m) noexcept
+{
+	const size_t locPutIndex = putIndex;
+	const size_t nextPutIndex = Next(locPutIndex);
+	if (nextPutIndex == getIndex)
+	{
+		return false;
+	}
+	moves[locPutIndex] = m;
+	__DMB();																				// make sure the move has been written before we publish it
+	putIndex = nextPutIndex;
+
+	const size_t count = Count();
+	if (count > maxOccupancy)
+	{
+		maxOccupancy = count;
+	}
+	return true;
+}
+
+// Remove the move at the head of the queue, typically after looking at it using Peek
+inline void RawMoveQueue::Discard() noexcept
+{
+	__DMB();																				// make sure we have finished reading the move before we release the slot
+	getIndex = Next(getIndex);
+}
+
+// Take a move from the queue, returning true if there was one
+inline bool RawMoveQueue::Get(RawMove& m) noexcept
+{
+	const size_t locGetIndex = getIndex;
+	if (locGetIndex == putIndex)
+	{
+		return false;
+	}
+	__DMB();																				// make sure we read the move after we read putIndex
+	m = moves[locGetIndex];
+	__DMB();																				// make sure we have finished reading the move before we release the slot
+	getIndex = Next(locGetIndex);
+	return true;
+}
+
+#endif /* SRC_MOVEMENT_RAWMOVEQUEUE_H_ */
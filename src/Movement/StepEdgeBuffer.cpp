@@ -0,0 +1,156 @@
+/*
+ * StepEdgeBuffer.cpp
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ */
+
+#include "StepEdgeBuffer.h"
+
+#if SUPPORT_STEP_EDGE_BUFFER
+
+#include <Platform/RepRap.h>
+#include <Platform/Platform.h>
+#include "DDA.h"
+
+StepEdgeBuffer::Edge StepEdgeBuffer::edges[NumEdges];
+volatile size_t StepEdgeBuffer::getIndex = 0;
+volatile size_t StepEdgeBuffer::putIndex = 0;
+StepTimer StepEdgeBuffer::timer;
+uint32_t StepEdgeBuffer::numFullFallbacks = 0;
+uint32_t StepEdgeBuffer::maxLateness = 0;
+
+void StepEdgeBuffer::Init() noexcept
+{
+	timer.SetCallback(StepEdgeBuffer::TimerCallback, CallbackParameter(nullptr));
+}
+
+bool StepEdgeBuffer::CanQueueStep() noexcept
+{
+	const size_t numQueued = (putIndex - getIndex) & (NumEdges - 1);
+	if (numQueued + MaxEdgesPerStep < NumEdges)
+	{
+		return true;
+	}
+	++numFullFallbacks;
+	return false;
+}
+
+void StepEdgeBuffer::AddSteps(uint32_t when, uint32_t driverMap) noexcept
+{
+	if (driverMap != 0)
+	{
+		const Edge e = { when, driverMap, 0, false };
+		PutEdge(e);
+	}
+}
+
+void StepEdgeBuffer::AddDirection(uint32_t when, size_t drive, bool direction) noexcept
+{
+	const Edge e = { when, 0, (uint8_t)drive, direction };
+	PutEdge(e);
+}
+
+// Add an edge to the queue and make sure that the playback timer is scheduled.
+// The caller must have called CanQueueStep first, so there is always room.
+void StepEdgeBuffer::PutEdge(const Edge& e) noexcept
+{
+	const size_t locPutIndex = putIndex;
+	const size_t nextPutIndex = (locPutIndex + 1) & (NumEdges - 1);
+	const bool wasEmpty = (locPutIndex == getIndex);
+	edges[locPutIndex] = e;
+	putIndex = nextPutIndex;
+	if (wasEmpty && timer.ScheduleCallbackFromIsr(e.when))
+	{
+		TimerCallback(CallbackParameter(nullptr));						// the edge is already due
+	}
+}
+
+// Output a single edge
+inline void StepEdgeBuffer::OutputEdge(const Edge& e) noexcept
+{
+	if (e.driverMap != 0)
+	{
+#if SUPPORT_SLOW_DRIVERS
+		Platform& p = reprap.GetPlatform();
+		if ((e.driverMap & p.GetSlowDriversBitmap()) != 0)
+		{
+			// Honour the step low time and direction setup time of the slow drivers, then hold the step pins high for the step high time
+			uint32_t now;
+			do
+			{
+				now = StepTimer::GetTimerTicks();
+			} while (now - DDA::lastStepLowTime < p.GetSlowDriverStepLowClocks() || now - DDA::lastDirChangeTime < p.GetSlowDriverDirSetupClocks());
+			StepPins::StepDriversHigh(e.driverMap);
+			const uint32_t stepHighTime = StepTimer::GetTimerTicks();
+			while (StepTimer::GetTimerTicks() - stepHighTime < p.GetSlowDriverStepHighClocks()) { }
+			StepPins::StepDriversLow(e.driverMap);
+			DDA::lastStepLowTime = StepTimer::GetTimerTicks();
+			return;
+		}
+#endif
+		StepPins::StepDriversHigh(e.driverMap);
+#if SAME70
+		__DSB();														// without this the step pulse can be far too short
+#endif
+		for (unsigned int i = 0; i < 20; ++i)							// the step ISR relies on the step calculation to provide the pulse width, but we don't do any calculation here
+		{
+			asm volatile("nop");
+		}
+		StepPins::StepDriversLow(e.driverMap);
+	}
+	else
+	{
+		reprap.GetPlatform().SetDirection(e.drive, e.direction);		// this waits for the direction hold time of any slow drivers
+	}
+}
+
+// Timer callback to play out the edges that are due, then schedule a callback for the next one
+void StepEdgeBuffer::TimerCallback(CallbackParameter p) noexcept
+{
+	size_t locGetIndex = getIndex;
+	while (locGetIndex != putIndex)
+	{
+		const Edge& e = edges[locGetIndex];
+		const int32_t lateness = (int32_t)(StepTimer::GetTimerTicks() - e.when);
+		if (lateness < 0 && !timer.ScheduleCallbackFromIsr(e.when))
+		{
+			break;														// we have scheduled a callback for when this one is due
+		}
+
+		if (lateness > (int32_t)maxLateness)
+		{
+			maxLateness = (uint32_t)lateness;
+		}
+		OutputEdge(e);
+		locGetIndex = (locGetIndex + 1) & (NumEdges - 1);
+		getIndex = locGetIndex;
+	}
+}
+
+void StepEdgeBuffer::Flush() noexcept
+{
+	size_t locGetIndex = getIndex;
+	if (locGetIndex != putIndex)
+	{
+		timer.CancelCallbackFromIsr();
+		do
+		{
+			const Edge& e = edges[locGetIndex];
+			while ((int32_t)(StepTimer::GetTimerTicks() - e.when) < 0) { }		// this won't take long because we only queue edges a short time in advance
+			OutputEdge(e);
+			locGetIndex = (locGetIndex + 1) & (NumEdges - 1);
+			getIndex = locGetIndex;
+		} while (locGetIndex != putIndex);
+	}
+}
+
+void StepEdgeBuffer::Diagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "Step edge buffer full %" PRIu32 ", max lateness %" PRIu32 "\n", numFullFallbacks, maxLateness);
+	numFullFallbacks = maxLateness = 0;
+}
+
+#endif
+
+// End
@@ -0,0 +1,78 @@
+/*
+ * StepEdgeBuffer.h
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ *
+ * This class holds a short queue of timestamped step and direction edges. When it is in use, the step ISR calculates step times a little ahead of when they are due
+ * and queues the edges here instead of writing the step pins directly. A separate timer callback plays the edges out at the times they are due.
+ * Because the playback callback does no calculation, the step pulse timing no longer depends on how long the step time calculations take.
+ */
+
+#ifndef SRC_MOVEMENT_STEPEDGEBUFFER_H_
+#define SRC_MOVEMENT_STEPEDGEBUFFER_H_
+
+#include <RepRapFirmware.h>
+
+#ifndef SUPPORT_STEP_EDGE_BUFFER
+# define SUPPORT_STEP_EDGE_BUFFER	0
+#endif
+
+#if SUPPORT_STEP_EDGE_BUFFER
+
+#ifdef DUET3_MB6XD
+# error "Step edge buffer is not supported on the MB6XD because it generates step pulses using a timer"
+#endif
+
+#include "StepTimer.h"
+
+class StepEdgeBuffer
+{
+public:
+	static void Init() noexcept;
+
+	// Queue a step pulse for the specified drivers. Base priority must be >= NvicPriorityStep when calling this.
+	static void AddSteps(uint32_t when, uint32_t driverMap) noexcept SPEED_CRITICAL;
+
+	// Queue a direction change for the specified axis or extruder. Base priority must be >= NvicPriorityStep when calling this.
+	static void AddDirection(uint32_t when, size_t drive, bool direction) noexcept SPEED_CRITICAL;
+
+	// Return true if there is room to queue the edges that a single step interrupt may generate. If not, count it because the caller will step the drivers directly.
+	static bool CanQueueStep() noexcept SPEED_CRITICAL;
+
+	// Output all queued edges, waiting until each one is due. Base priority must be >= NvicPriorityStep when calling this.
+	static void Flush() noexcept;
+
+	static bool IsEmpty() noexcept { return getIndex == putIndex; }
+	static void Diagnostics(MessageType mtype) noexcept;
+
+	static constexpr uint32_t LeadTime = (30 * StepClockRate)/1000000;				// how far ahead of the step time we calculate steps and queue them
+	static constexpr size_t MaxEdgesPerStep = MaxAxesPlusExtruders + 1;				// one step edge plus a direction change for each axis or extruder
+	static constexpr size_t NumEdges = (MaxEdgesPerStep < 16) ? 32 : 64;			// must be a power of 2
+
+private:
+	struct Edge
+	{
+		uint32_t when;																// the time at which this edge is due
+		uint32_t driverMap;															// the drivers to step, or zero if this is a direction change
+		uint8_t drive;																// the axis or extruder number if this is a direction change
+		bool direction;																// the new direction if this is a direction change
+	};
+
+	static void PutEdge(const Edge& e) noexcept SPEED_CRITICAL;
+	static void OutputEdge(const Edge& e) noexcept SPEED_CRITICAL;
+	static void TimerCallback(CallbackParameter p) noexcept SPEED_CRITICAL;
+
+	static_assert((NumEdges & (NumEdges - 1)) == 0);
+	static_assert(NumEdges > 2 * MaxEdgesPerStep);
+
+	static Edge edges[NumEdges];
+	static volatile size_t getIndex, putIndex;
+	static StepTimer timer;
+	static uint32_t numFullFallbacks;												// how many times we stepped the drivers directly because the queue was too full
+	static uint32_t maxLateness;													// the maximum time by which we were late outputting an edge
+};
+
+#endif
+
+#endif /* SRC_MOVEMENT_STEPEDGEBUFFER_H_ */
@@ -33,6 +33,13 @@ uint32_t StepTimer::maxInterval = 0;
 uint32_t StepTimer::lastTimerResult = 0;
 #endif
 
+#if STEP_TIMING_HISTOGRAM
+uint32_t StepTimer::latenessHistogram[NumTimingBuckets] = { 0 };
+uint32_t StepTimer::durationHistogram[NumTimingBuckets] = { 0 };
+uint32_t StepTimer::maxLateness = 0;
+uint32_t StepTimer::maxDuration = 0;
+#endif
+
 #if SUPPORT_REMOTE_COMMANDS
 
 volatile uint32_t StepTimer::localTimeOffset = 0;
@@ -364,7 +371,18 @@ void StepTimer::DisableTimerInterrupt() noexcept
 			pendingList = nextTimer;								// remove it from the pending list
 
 			tmr->active = false;
+#if STEP_TIMING_HISTOGRAM
+			const Ticks callbackStartTime = GetTimerTicks();
+			const int32_t lateness = (int32_t)(callbackStartTime - tmr->whenDue);
+			if (lateness >= 0)										// on systems with 16-bit timers the callback may be early, in which case it will reschedule itself
+			{
+				RecordTiming(latenessHistogram, maxLateness, (uint32_t)lateness);
+			}
 			tmr->callback(tmr->cbParam);							// execute its callback. This may schedule another callback and hence change the pending list.
+			RecordTiming(durationHistogram, maxDuration, GetTimerTicks() - callbackStartTime);
+#else
+			tmr->callback(tmr->cbParam);							// execute its callback. This may schedule another callback and hence change the pending list.
+#endif
 
 			tmr = pendingList;
 			if (tmr == nullptr || tmr != nextTimer)
@@ -380,6 +398,21 @@ void StepTimer::DisableTimerInterrupt() noexcept
 	}
 }
 
+#if STEP_TIMING_HISTOGRAM
+
+// Add an event to a timing histogram
+inline void StepTimer::RecordTiming(uint32_t histogram[], uint32_t& maxTicks, uint32_t ticks) noexcept
+{
+	const size_t bucket = (ticks == 0) ? 0 : min<size_t>(32 - __builtin_clz(ticks), NumTimingBuckets - 1);
+	++histogram[bucket];
+	if (ticks > maxTicks)
+	{
+		maxTicks = ticks;
+	}
+}
+
+#endif
+
 // Step pulse timer interrupt
 extern "C" void STEP_TC_HANDLER() noexcept SPEED_CRITICAL;
 
@@ -509,6 +542,41 @@ void StepTimer::CancelCallback() noexcept
 	RestoreBasePriority(baseprio);
 }
 
+#if STEP_TIMING_HISTOGRAM
+
+// Clear the timing histograms so that we can start a new measurement
+/*static*/ void StepTimer::ResetTimingHistograms() noexcept
+{
+	const uint32_t baseprio = ChangeBasePriority(NvicPriorityStep);
+	for (size_t i = 0; i < NumTimingBuckets; ++i)
+	{
+		latenessHistogram[i] = durationHistogram[i] = 0;
+	}
+	maxLateness = maxDuration = 0;
+	RestoreBasePriority(baseprio);
+}
+
+// Report the timing histograms and then clear them
+/*static*/ void StepTimer::TimingDiagnostics(MessageType mtype) noexcept
+{
+	String<StringLength256> buf;
+	buf.copy("Step timer lateness:");
+	for (uint32_t count : latenessHistogram)
+	{
+		buf.catf(" %" PRIu32, count);
+	}
+	buf.catf(", max %" PRIu32 "\nStep timer callback duration:", maxLateness);
+	for (uint32_t count : durationHistogram)
+	{
+		buf.catf(" %" PRIu32, count);
+	}
+	buf.catf(", max %" PRIu32 "\n", maxDuration);
+	reprap.GetPlatform().Message(mtype, buf.c_str());
+	ResetTimingHistograms();
+}
+
+#endif
+
 // Function called by FreeRTOS to read the timer
 extern "C" uint32_t StepTimerGetTimerTicks() noexcept
 {
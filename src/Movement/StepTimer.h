@@ -12,6 +12,11 @@
 
 #define STEP_TIMER_DEBUG	1			// currently this only works for the SAME5x
 
+// Set STEP_TIMING_HISTOGRAM to 1 to record histograms of how late timer callbacks are executed and how long they take, for M122 and the object model
+#ifndef STEP_TIMING_HISTOGRAM
+# define STEP_TIMING_HISTOGRAM	(0)
+#endif
+
 class CanMessageTimeSync;
 
 // Class to implement a software timer with a few microseconds resolution
@@ -83,6 +88,18 @@ public:
 	static uint32_t maxInterval;
 #endif
 
+#if STEP_TIMING_HISTOGRAM
+	// Bucket 0 counts events of less than 1 tick, bucket N counts events of 2^(N-1) to 2^N - 1 ticks, and the last bucket also counts anything longer
+	static constexpr size_t NumTimingBuckets = 10;
+
+	static uint32_t GetLatenessCount(size_t bucket) noexcept { return latenessHistogram[bucket]; }
+	static uint32_t GetDurationCount(size_t bucket) noexcept { return durationHistogram[bucket]; }
+	static uint32_t GetMaxLateness() noexcept { return maxLateness; }
+	static uint32_t GetMaxDuration() noexcept { return maxDuration; }
+	static void ResetTimingHistograms() noexcept;
+	static void TimingDiagnostics(MessageType mtype) noexcept;
+#endif
+
 private:
 	static bool ScheduleTimerInterrupt(uint32_t tim) noexcept;					// Schedule an interrupt at the specified clock count, or return true if it has passed already
 
@@ -98,6 +115,15 @@ private:
 	static uint32_t lastTimerResult;
 #endif
 
+#if STEP_TIMING_HISTOGRAM
+	static void RecordTiming(uint32_t histogram[], uint32_t& maxTicks, uint32_t ticks) noexcept;
+
+	static uint32_t latenessHistogram[NumTimingBuckets];						// how late callbacks were executed relative to when they were due
+	static uint32_t durationHistogram[NumTimingBuckets];						// how long callbacks took to execute
+	static uint32_t maxLateness;
+	static uint32_t maxDuration;
+#endif
+
 #if SUPPORT_REMOTE_COMMANDS
 	static volatile uint32_t localTimeOffset;									// local time minus master time
 	static volatile uint32_t whenLastSynced;									// the millis tick count when we last synced
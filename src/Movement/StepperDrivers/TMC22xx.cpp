@@ -556,6 +556,12 @@ private:
 #endif
 	static constexpr unsigned int ReadSpecial = NumReadRegisters;
 
+	// Registers that change rarely or are only used for diagnostics are read on one pass in every SlowReadCycles, so that the status registers are read more often
+	static constexpr uint32_t SlowReadRegisters = (1u << ReadIoIn) | (1u << ReadChopConf) | (1u << ReadPwmScale) | (1u << ReadPwmAuto);
+	static constexpr unsigned int SlowReadCycles = 4;
+
+	void SetNextRegisterToRead() noexcept;
+
 	volatile uint32_t writeRegisters[NumWriteRegisters + 1];	// the values we want the TMC22xx writable registers to have
 	volatile uint32_t readRegisters[NumReadRegisters + 1];		// the last values read from the TMC22xx readable registers
 	volatile uint32_t accumulatedReadRegisters[NumReadRegisters];
@@ -612,6 +618,7 @@ private:
 	uint8_t driverNumber;									// the number of this driver as addressed by the UART multiplexer
 	uint8_t standstillCurrentFraction;						// divide this by 256 to get the motor current standstill fraction
 	uint8_t registerToRead;									// the next register we need to read
+	uint8_t readCycleCount;									// how many times we have been through the list of registers to read
 	uint8_t regnumBeingUpdated;								// which register we are sending
 	uint8_t lastIfCount;									// the value of the IFCNT register last time we read it
 	uint8_t failedOp;
@@ -984,6 +991,7 @@ pre(!driversPowered)
 	regnumBeingUpdated = 0xFF;
 	failedOp = 0xFF;
 	registerToRead = 0;
+	readCycleCount = 0;
 	lastIfCount = 0;
 	readErrors = writeErrors = numReads = numWrites = numTimeouts = numDmaErrors = badChopConfErrors = 0;
 #if HAS_STALL_DETECT
@@ -1320,6 +1328,28 @@ void TmcDriverState::AppendDriverStatus(const StringRef& reply) noexcept
 	readErrors = writeErrors = numReads = numWrites = numTimeouts = numDmaErrors = badChopConfErrors = 0;
 }
 
+// Select the next register to read, skipping the slow registers except on every SlowReadCycles pass through the list
+inline void TmcDriverState::SetNextRegisterToRead() noexcept
+{
+	for (;;)
+	{
+		++registerToRead;
+		if (registerToRead >= NumReadRegisters)
+		{
+			if (registerToRead == ReadSpecial && specialReadRegisterNumber < 0x80)
+			{
+				return;													// a special register read is pending
+			}
+			registerToRead = 0;
+			++readCycleCount;
+		}
+		if ((SlowReadRegisters & (1u << registerToRead)) == 0 || readCycleCount % SlowReadCycles == 0)
+		{
+			return;
+		}
+	}
+}
+
 // This is called by the ISR when the SPI transfer has completed
 inline void TmcDriverState::TransferDone() noexcept
 {
@@ -1397,17 +1427,12 @@ inline void TmcDriverState::TransferDone() noexcept
 			if (registerToRead == ReadSpecial)
 			{
 				specialReadRegisterNumber = 0xFE;						// set it to 0xFE to indicate that we have read it and to prevent it being read again
-				registerToRead = 0;
 			}
 			else
 			{
 				accumulatedReadRegisters[registerToRead] |= regVal;
-				++registerToRead;
-				if (registerToRead == ReadSpecial && specialReadRegisterNumber >= 0x80)
-				{
-					registerToRead = 0;
-				}
 			}
+			SetNextRegisterToRead();
 			++numReads;
 		}
 		else
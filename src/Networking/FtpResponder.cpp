@@ -15,7 +15,7 @@
 #include <Platform/Platform.h>
 
 FtpResponder::FtpResponder(NetworkResponder *n) noexcept
-	: UploadingNetworkResponder(n), dataSocket(nullptr), passivePort(0), passivePortOpenTime(0), dataBuf(nullptr), haveFileToMove(false)
+	: UploadingNetworkResponder(n), dataSocket(nullptr), passivePort(0), passivePortOpenTime(0), dataBuf(nullptr), restartOffset(0), haveFileToMove(false)
 {
 }
 
@@ -28,6 +28,7 @@ bool FtpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 		if (outBuf != nullptr || OutputBuffer::Allocate(outBuf))
 		{
 			clientPointer = 0;
+			restartOffset = 0;
 			skt = s;
 			if (reprap.Debug(moduleWebserver))
 			{
@@ -157,6 +158,7 @@ void FtpResponder::Diagnostics(MessageType mt) const noexcept
 void FtpResponder::ConnectionLost() noexcept
 {
 	CloseDataPort();
+	restartOffset = 0;
 	NetworkResponder::ConnectionLost();
 }
 
@@ -501,6 +503,8 @@ void FtpResponder::ProcessLine() noexcept
 		{
 			outBuf->copy(	"211-Features:\r\n"
 							"PASV\r\n"			// support PASV mode
+							"REST STREAM\r\n"	// support resumed downloads
+							"SIZE\r\n"			// support file size queries
 							"211 End\r\n"
 						);
 			Commit(ResponderState::reading);
@@ -563,6 +567,16 @@ void FtpResponder::ProcessLine() noexcept
 					passivePort / 256, passivePort % 256);
 			Commit(ResponderState::waitingForPasvPort);
 		}
+		// set the start offset for the next download
+		else if (StringStartsWith(clientMessage, "REST"))
+		{
+			SetRestartOffset(ResponderState::reading);
+		}
+		// get file size
+		else if (StringStartsWith(clientMessage, "SIZE"))
+		{
+			SendFileSize(ResponderState::reading);
+		}
 		// PASV commands are not supported in this state
 		else if (StringStartsWith(clientMessage, "LIST") || StringStartsWith(clientMessage, "RETR") || StringStartsWith(clientMessage, "STOR"))
 		{
@@ -710,9 +724,28 @@ void FtpResponder::ProcessLine() noexcept
 			}
 			Commit(ResponderState::pasvPortOpened);
 		}
+		// set the start offset for the next download
+		else if (StringStartsWith(clientMessage, "REST"))
+		{
+			SetRestartOffset(ResponderState::pasvPortOpened);
+		}
+		// get file size
+		else if (StringStartsWith(clientMessage, "SIZE"))
+		{
+			SendFileSize(ResponderState::pasvPortOpened);
+		}
 		// upload a file
 		else if (StringStartsWith(clientMessage, "STOR"))
 		{
+			// Uploads are written to a temporary file that replaces the original when complete, so we can't resume them
+			if (restartOffset != 0)
+			{
+				restartOffset = 0;
+				outBuf->copy("554 Resumed uploads are not supported.\r\n");
+				Commit(ResponderState::pasvPortOpened);
+				return;
+			}
+
 			// Variable filenameBeingProcessed is used for both uploading and for renaming files, so clear it here and clear haveFileToMove
 			haveFileToMove = false;
 			filenameBeingProcessed.Clear();
@@ -733,10 +766,19 @@ void FtpResponder::ProcessLine() noexcept
 		else if (StringStartsWith(clientMessage, "RETR"))
 		{
 			const char * const filename = GetParameter("RETR");
+			const FilePosition startOffset = restartOffset;
+			restartOffset = 0;
 			fileBeingSent = GetPlatform().OpenFile(currentDirectory.c_str(), filename, OpenMode::read);
-			if (fileBeingSent != nullptr)
+			if (fileBeingSent != nullptr && startOffset != 0 && (startOffset > fileBeingSent->Length() || !fileBeingSent->Seek(startOffset)))
+			{
+				fileBeingSent->Close();
+				fileBeingSent = nullptr;
+				outBuf->copy("554 Invalid restart position.\r\n");
+				Commit(ResponderState::pasvPortOpened);
+			}
+			else if (fileBeingSent != nullptr)
 			{
-				outBuf->printf("150 Opening data connection for %s (%lu bytes).\r\n", filename, fileBeingSent->Length());
+				outBuf->printf("150 Opening data connection for %s (%lu bytes).\r\n", filename, fileBeingSent->Length() - startOffset);
 				Commit(ResponderState::sendingPasvData);
 			}
 			else
@@ -811,6 +853,42 @@ const char *FtpResponder::GetParameter(const char *after) const noexcept
 	return result;
 }
 
+// Process a REST command. The offset applies to the next RETR command only.
+void FtpResponder::SetRestartOffset(ResponderState nextState) noexcept
+{
+	const char * const param = GetParameter("REST");
+	const char *endptr;
+	const uint32_t offset = StrToU32(param, &endptr);
+	if (endptr != param && *endptr == 0)
+	{
+		restartOffset = offset;
+		outBuf->printf("350 Restarting at %lu.\r\n", offset);
+	}
+	else
+	{
+		restartOffset = 0;
+		outBuf->copy("501 Invalid restart position.\r\n");
+	}
+	Commit(nextState);
+}
+
+// Process a SIZE command
+void FtpResponder::SendFileSize(ResponderState nextState) noexcept
+{
+	const char * const filename = GetParameter("SIZE");
+	FileStore * const f = GetPlatform().OpenFile(currentDirectory.c_str(), filename, OpenMode::read);
+	if (f != nullptr)
+	{
+		outBuf->printf("213 %lu\r\n", f->Length());
+		f->Close();
+	}
+	else
+	{
+		outBuf->copy("550 Could not get file size.\r\n");
+	}
+	Commit(nextState);
+}
+
 void FtpResponder::ChangeDirectory(const char *newDirectory) noexcept
 {
 	String<MaxFilenameLength> combinedPath;
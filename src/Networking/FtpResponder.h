@@ -34,6 +34,8 @@ protected:
 	void ProcessLine() noexcept;
 	const char *GetParameter(const char *after) const noexcept;	// return the parameter followed by whitespaces after a command
 	void ChangeDirectory(const char *newDirectory) noexcept;
+	void SetRestartOffset(ResponderState nextState) noexcept;		// process a REST command
+	void SendFileSize(ResponderState nextState) noexcept;			// process a SIZE command
 	void CloseDataPort() noexcept;
 
 	static const size_t ftpMessageLength = 128;			// maximum line length for incoming FTP commands
@@ -43,6 +45,7 @@ protected:
 	TcpPort passivePort;
 	uint32_t passivePortOpenTime;
 	OutputBuffer *dataBuf;
+	FilePosition restartOffset;							// file offset requested by REST for the next RETR
 
 	bool sendError;
 	bool haveCompleteLine;
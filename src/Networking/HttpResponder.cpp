@@ -13,6 +13,7 @@
 #include "Socket.h"
 #include "GCodes/GCodes.h"
 #include "General/IP4String.h"
+#include <Libraries/sha1/sha1.h>
 
 #define KO_START "rr_"
 const size_t KoFirst = 3;
@@ -23,6 +24,7 @@ const char serviceUnavailableResponse[] = "HTTP/1.1 503 Service Unavailable\r\n\
 static_assert(ARRAY_SIZE(serviceUnavailableResponse) <= OUTPUT_BUFFER_SIZE, "OUTPUT_BUFFER_SIZE too small");
 
 const uint32_t HttpReceiveTimeout = 2000;
+const uint32_t HttpKeepAliveTimeout = 1000;					// how long we keep an idle persistent connection open waiting for the next request
 
 // Text for a human-readable 404 page
 const char* const ErrorPagePart1 =
@@ -36,7 +38,7 @@ const char* const ErrorPagePart2 =
 	"</p>\n"
 	"</body>\n";
 
-HttpResponder::HttpResponder(NetworkResponder *n) noexcept : UploadingNetworkResponder(n)
+HttpResponder::HttpResponder(NetworkResponder *n) noexcept : UploadingNetworkResponder(n), isWebSocket(false)
 {
 }
 
@@ -48,14 +50,8 @@ bool HttpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 		responderState = ResponderState::reading;
 		skt = s;
 		timer = millis();
-
-		// Reset the parse state variables
-		clientPointer = 0;
-		parseState = HttpParseState::doingCommandWord;
-		numCommandWords = 0;
-		numQualKeys = 0;
-		numHeaderKeys = 0;
-		commandWords[0] = clientMessage;
+		keptAlive = false;
+		ResetParser();
 
 		if (reprap.Debug(moduleWebserver))
 		{
@@ -66,6 +62,56 @@ bool HttpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 	return false;
 }
 
+// Reset the parse state variables ready to receive a new request
+void HttpResponder::ResetParser() noexcept
+{
+	clientPointer = 0;
+	parseState = HttpParseState::doingCommandWord;
+	numCommandWords = 0;
+	numQualKeys = 0;
+	numHeaderKeys = 0;
+	commandWords[0] = clientMessage;
+}
+
+// Return true if the request we are processing allows the connection to persist after we have sent the response.
+// We only do this for GET requests without a body, so that anything else the client has sent must be the start of the next request.
+bool HttpResponder::KeepAliveRequested() const noexcept
+{
+	if (numCommandWords < 3 || !StringEqualsIgnoreCase(commandWords[0], "GET"))
+	{
+		return false;
+	}
+
+	const char *_ecv_array const contentLength = GetHeaderValue("Content-Length");
+	if (contentLength != nullptr && StrToU32(contentLength) != 0)
+	{
+		return false;
+	}
+
+	// HTTP 1.1 connections persist by default, HTTP 1.0 connections only if the client asks
+	const char *_ecv_array const connection = GetHeaderValue("Connection");
+	return (connection != nullptr)
+			? StringEqualsIgnoreCase(connection, "keep-alive")
+				: StringEqualsIgnoreCase(commandWords[2], "HTTP/1.1");
+}
+
+// Append the Connection header and the blank line that ends the headers, then commit the response.
+// If we are keeping the connection open, get ready to receive the next request once the response has been sent.
+void HttpResponder::CommitResponse(bool keepOpen) noexcept
+{
+	outBuf->catf("Connection: %s\r\n\r\n", keepOpen ? "keep-alive" : "close");
+	if (keepOpen)
+	{
+		keptAlive = true;
+		ResetParser();
+		Commit(ResponderState::reading);
+	}
+	else
+	{
+		Commit();
+	}
+}
+
 // Do some work, returning true if we did anything significant
 bool HttpResponder::Spin() noexcept
 {
@@ -95,6 +141,16 @@ bool HttpResponder::Spin() noexcept
 				return true;
 			}
 
+			// If this is a persistent connection and the client hasn't started another request, close it gracefully when it has been idle for long enough
+			// so that the responder is available for other connections. Pipelined requests have already been received, so they don't wait for this.
+			if (keptAlive && clientPointer == 0 && (!skt->CanRead() || millis() - timer >= HttpKeepAliveTimeout))
+			{
+				skt->Close();
+				skt = nullptr;
+				responderState = ResponderState::free;
+				return true;
+			}
+
 			if (!skt->CanRead() || millis() - timer >= HttpReceiveTimeout)
 			{
 				ConnectionLost();
@@ -108,6 +164,11 @@ bool HttpResponder::Spin() noexcept
 		ProcessRequest();
 		return true;
 
+#if SUPPORT_OBJECT_MODEL
+	case ResponderState::webSocket:
+		return DoWebSocket();
+#endif
+
 	case ResponderState::gettingFileInfo:
 		(void)SendFileInfo(millis() - startedProcessingRequestAt >= MaxFileInfoGetTime);
 		return true;
@@ -453,7 +514,7 @@ bool HttpResponder::CharFromClient(char c) noexcept
 // This may also return true with response == nullptr if we tried to generate a response but ran out of buffers.
 bool HttpResponder::GetJsonResponse(const char *_ecv_array request, OutputBuffer *&response, bool& keepOpen) noexcept
 {
-	keepOpen = false;	// assume we don't want to persist the connection
+	keepOpen = true;	// assume we can persist the connection if the client wants to
 	const char *parameter;
 	if (StringEqualsIgnoreCase(request, "connect") && (parameter = GetKeyValue("password")) != nullptr)
 	{
@@ -500,6 +561,7 @@ bool HttpResponder::GetJsonResponse(const char *_ecv_array request, OutputBuffer
 	else if (StringEqualsIgnoreCase(request, "disconnect"))
 	{
 		response->printf("{\"err\":%d}", (RemoveAuthentication()) ? 0 : 1);
+		keepOpen = false;
 		reprap.GetPlatform().MessageF(LogWarn, "HTTP client %s disconnected\n", IP4String(GetRemoteIP()).c_str());
 	}
 	else if (StringEqualsIgnoreCase(request, "status"))
@@ -553,7 +615,7 @@ bool HttpResponder::GetJsonResponse(const char *_ecv_array request, OutputBuffer
 		OutputBuffer::ReleaseAll(response);
 		const char* const firstVal = GetKeyValue("first");
 		const unsigned int startAt = (firstVal == nullptr) ? 0 : StrToU32(firstVal);
-		response = reprap.GetFilelistResponse(parameter, startAt);		// this may return nullptr
+		response = reprap.GetFilelistResponse(parameter, startAt, MaxHttpFilelistResponseBytes);		// this may return nullptr
 	}
 	else if (StringEqualsIgnoreCase(request, "files"))
 	{
@@ -567,7 +629,7 @@ bool HttpResponder::GetJsonResponse(const char *_ecv_array request, OutputBuffer
 		const unsigned int startAt = (firstVal == nullptr) ? 0 : StrToU32(firstVal);
 		const char* const flagDirsVal = GetKeyValue("flagDirs");
 		const bool flagDirs = flagDirsVal != nullptr && StrToU32(flagDirsVal) == 1;
-		response = reprap.GetFilesResponse(dir, startAt, flagDirs);				// this may return nullptr
+		response = reprap.GetFilesResponse(dir, startAt, flagDirs, MaxHttpFilelistResponseBytes);	// this may return nullptr
 	}
 	else if (StringEqualsIgnoreCase(request, "move"))
 	{
@@ -670,6 +732,18 @@ const char* HttpResponder::GetKeyValue(const char *key) const noexcept
 	return nullptr;
 }
 
+const char* HttpResponder::GetHeaderValue(const char *key) const noexcept
+{
+	for (size_t i = 0; i < numHeaderKeys; ++i)
+	{
+		if (StringEqualsIgnoreCase(headers[i].key, key))
+		{
+			return headers[i].value;
+		}
+	}
+	return nullptr;
+}
+
 // Called to process a FileInfo request, which may take several calls
 // Return true if complete
 bool HttpResponder::SendFileInfo(bool quitEarly) noexcept
@@ -687,7 +761,8 @@ bool HttpResponder::SendFileInfo(bool quitEarly) noexcept
 					);
 		outBuf->catf("Content-Length: %u\r\n", (jsonResponse != nullptr) ? jsonResponse->Length() : 0);
 		AddCorsHeader();
-		outBuf->cat("Connection: close\r\n\r\n");
+		const bool keepOpen = KeepAliveRequested();
+		outBuf->catf("Connection: %s\r\n\r\n", keepOpen ? "keep-alive" : "close");
 		outBuf->Append(jsonResponse);
 		if (outBuf->HadOverflow())
 		{
@@ -698,7 +773,16 @@ bool HttpResponder::SendFileInfo(bool quitEarly) noexcept
 		else
 		{
 			filenameBeingProcessed.Clear();
-			Commit();
+			if (keepOpen)
+			{
+				keptAlive = true;
+				ResetParser();
+				Commit(ResponderState::reading);
+			}
+			else
+			{
+				Commit();
+			}
 		}
 	}
 	return gotFileInfo;
@@ -761,16 +845,71 @@ bool HttpResponder::RemoveAuthentication() noexcept
 
 /*static*/ void HttpResponder::RemoveSession(size_t sessionToRemove) noexcept
 {
+	// The order of sessions doesn't matter, so move the last one into the gap. Callers that remove sessions in a loop iterate downwards, so they won't miss it.
 	if (sessionToRemove < numSessions)
 	{
 		--numSessions;
-		for (size_t k = sessionToRemove; k < numSessions; ++k)
+		if (sessionToRemove != numSessions)
 		{
-			sessions[k] = sessions[k + 1];
+			sessions[sessionToRemove] = sessions[numSessions];
 		}
 	}
 }
 
+#if HAS_MASS_STORAGE
+
+// Return true if the filename looks like it was generated by a bundler and includes a content hash, e.g. "app.3f2a9c1b.js".
+// Such files never change, so the browser may cache them without revalidating.
+// The hash must be a separate segment of at least 8 hex digits after the base name and before the extension, and must include both decimal digits and letters,
+// so that names such as "deadbeef.js" or "log-20231014.txt" are not mistaken for hashed names.
+static bool IsHashedAssetName(const char *_ecv_array name) noexcept
+{
+	const char *_ecv_array p = strrchr(name, '/');
+	p = (p == nullptr) ? name : p + 1;
+
+	// Skip the base name
+	while (*p != '.' && *p != '-')
+	{
+		if (*p == 0)
+		{
+			return false;
+		}
+		++p;
+	}
+
+	while (*p != 0)
+	{
+		++p;											// skip the separator
+		const char *_ecv_array const segmentStart = p;
+		bool hasDigit = false, hasLetter = false, allHex = true;
+		while (*p != 0 && *p != '.' && *p != '-')
+		{
+			const char c = *p++;
+			if (isdigit(c))
+			{
+				hasDigit = true;
+			}
+			else if (isxdigit(c))
+			{
+				hasLetter = true;
+			}
+			else
+			{
+				allHex = false;
+			}
+		}
+
+		// The last segment is the extension, so it can't be the hash
+		if (*p != 0 && allHex && hasDigit && hasLetter && p - segmentStart >= 8)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif
+
 void HttpResponder::SendFile(const char *_ecv_array nameOfFileToSend, bool isWebFile) noexcept
 {
 #if HAS_MASS_STORAGE
@@ -857,8 +996,94 @@ void HttpResponder::SendFile(const char *_ecv_array nameOfFileToSend, bool isWeb
 		}
 	}
 
+	// Web files may be cached by the browser, so give it an entity tag made from the file size and modification time, and the modification time itself.
+	// If the browser already has the current version then we tell it so and close the file without sending it.
+	String<StringLength20> eTag;
+	String<StringLength50> lastModified;
+	if (isWebFile)
+	{
+		String<MaxFilenameLength> filePath;
+		time_t modTime = 0;
+		if (MassStorage::CombineName(filePath.GetRef(), Platform::GetWebDir(), nameOfFileToSend) && (!zip || !filePath.cat(".gz")))
+		{
+			modTime = MassStorage::GetLastModifiedTime(filePath.c_str());
+		}
+
+		// If we don't know when the file was modified then we can't tell whether the browser's copy is current, so we send neither header and always send the file
+		if (modTime != 0)
+		{
+			eTag.printf("\"%" PRIx32 "-%" PRIx32 "\"", (uint32_t)fileToSend->Length(), (uint32_t)modTime);
+			static const char * const dayNames[7] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+			static const char * const monthNames[12] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+			tm timeInfo;
+			gmtime_r(&modTime, &timeInfo);
+			lastModified.printf("%s, %02u %s %04u %02u:%02u:%02u GMT",
+								dayNames[timeInfo.tm_wday], timeInfo.tm_mday, monthNames[timeInfo.tm_mon], timeInfo.tm_year + 1900, timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec);
+		}
+
+		// If-None-Match takes precedence over If-Modified-Since. Browsers send back the Last-Modified string we gave them, so an exact match is sufficient.
+		const char *_ecv_array const ifNoneMatch = GetHeaderValue("If-None-Match");
+		const char *_ecv_array const ifModifiedSince = GetHeaderValue("If-Modified-Since");
+		if (   !eTag.IsEmpty()
+			&& ((ifNoneMatch != nullptr) ? strstr(ifNoneMatch, eTag.c_str()) != nullptr
+				: (ifModifiedSince != nullptr && StringEqualsIgnoreCase(ifModifiedSince, lastModified.c_str())))
+		   )
+		{
+			fileToSend->Close();
+			outBuf->copy("HTTP/1.1 304 Not Modified\r\n");
+			outBuf->catf("ETag: %s\r\n", eTag.c_str());
+			CommitResponse(KeepAliveRequested());
+			return;
+		}
+	}
+
+	// Files served by rr_download may be fetched from an offset so that interrupted downloads can be resumed.
+	// We only handle a single range that runs to the end of the file. RFC 7233 allows us to ignore other range requests and send the whole file.
+	const FilePosition fileLength = fileToSend->Length();
+	FilePosition rangeStart = 0;
+	if (!isWebFile)
+	{
+		const char *_ecv_array const rangeHeader = GetHeaderValue("Range");
+		if (rangeHeader != nullptr && StringStartsWith(rangeHeader, "bytes="))
+		{
+			const char *_ecv_array const startText = rangeHeader + strlen("bytes=");
+			const char *_ecv_array endText;
+			const uint32_t start = StrToU32(startText, &endText);
+			if (endText != startText && *endText == '-')
+			{
+				++endText;
+				bool toEndOfFile = (*endText == 0);
+				if (!toEndOfFile)
+				{
+					const char *_ecv_array afterEnd;
+					const uint32_t end = StrToU32(endText, &afterEnd);
+					toEndOfFile = afterEnd != endText && *afterEnd == 0 && end + 1 >= fileLength;
+				}
+				if (toEndOfFile && start != 0 && start < fileLength)
+				{
+					if (fileToSend->Seek(start))
+					{
+						rangeStart = start;
+					}
+					else
+					{
+						(void)fileToSend->Seek(0);
+					}
+				}
+			}
+		}
+	}
+
 	fileBeingSent = fileToSend;
-	outBuf->copy("HTTP/1.1 200 OK\r\n");
+	if (rangeStart != 0)
+	{
+		outBuf->copy("HTTP/1.1 206 Partial Content\r\n");
+		outBuf->catf("Content-Range: bytes %" PRIu32 "-%" PRIu32 "/%" PRIu32 "\r\n", rangeStart, fileLength - 1, fileLength);
+	}
+	else
+	{
+		outBuf->copy("HTTP/1.1 200 OK\r\n");
+	}
 
 	// Don't cache files served by rr_download
 	if (!isWebFile)
@@ -866,9 +1091,22 @@ void HttpResponder::SendFile(const char *_ecv_array nameOfFileToSend, bool isWeb
 		outBuf->cat(	"Cache-Control: no-cache, no-store, must-revalidate\r\n"
 						"Pragma: no-cache\r\n"
 						"Expires: 0\r\n"
+						"Accept-Ranges: bytes\r\n"
 					);
 		AddCorsHeader();
 	}
+	else
+	{
+		if (IsHashedAssetName(nameOfFileToSend))
+		{
+			outBuf->catf("Cache-Control: public, max-age=%" PRIu32 ", immutable\r\n", HttpImmutableAssetMaxAge);
+		}
+		if (!eTag.IsEmpty())
+		{
+			outBuf->catf("ETag: %s\r\n", eTag.c_str());
+			outBuf->catf("Last-Modified: %s\r\n", lastModified.c_str());
+		}
+	}
 
 	const char* contentType;
 	if (StringEndsWithIgnoreCase(nameOfFileToSend, ".png"))
@@ -911,9 +1149,8 @@ void HttpResponder::SendFile(const char *_ecv_array nameOfFileToSend, bool isWeb
 		outBuf->cat("Content-Encoding: gzip\r\n");
 	}
 
-	outBuf->catf("Content-Length: %lu\r\n", fileToSend->Length());
-	outBuf->cat("Connection: close\r\n\r\n");
-	Commit();
+	outBuf->catf("Content-Length: %" PRIu32 "\r\n", fileLength - rangeStart);
+	CommitResponse(KeepAliveRequested());
 #else
 	RejectMessage("file not found", 404);
 #endif
@@ -956,7 +1193,7 @@ void HttpResponder::SendGCodeReply() noexcept
 					);
 		outBuf->catf("Content-Length: %u\r\n", gcodeReply.DataLength());
 		AddCorsHeader();
-		outBuf->cat("Connection: close\r\n\r\n");
+		CommitResponse(KeepAliveRequested());
 		outStack.Append(gcodeReply);
 
 		// Possibly clean up the G-code reply once again
@@ -965,8 +1202,6 @@ void HttpResponder::SendGCodeReply() noexcept
 			gcodeReply.Clear();
 		}
 	}
-
-	Commit();
 }
 
 // Send a JSON response to the current command. outBuf is non-null on entry.
@@ -1031,21 +1266,8 @@ void HttpResponder::SendJsonResponse(const char *_ecv_array command) noexcept
 		return;
 	}
 
-	// Send the JSON response
-	bool keepOpen = false;
-	if (mayKeepOpen)
-	{
-		// Check that the browser wants to persist the connection too
-		for (size_t i = 0; i < numHeaderKeys; ++i)
-		{
-			if (StringEqualsIgnoreCase(headers[i].key, "Connection"))
-			{
-				// Comment out the following line to disable persistent connections
-				keepOpen = StringEqualsIgnoreCase(headers[i].value, "keep-alive");
-				break;
-			}
-		}
-	}
+	// Send the JSON response. Check that the browser wants to persist the connection too.
+	const bool keepOpen = mayKeepOpen && KeepAliveRequested();
 
 	// Note that when using RTOS the following response should preferably be small enough to fit in a single buffer.
 	// This is because the current task may get suspended e.g. when reading from SD card to build a file list,
@@ -1077,6 +1299,11 @@ void HttpResponder::SendJsonResponse(const char *_ecv_array command) noexcept
 	}
 
 	// Here if everything is OK
+	if (keepOpen)
+	{
+		keptAlive = true;
+		ResetParser();
+	}
 	Commit(keepOpen ? ResponderState::reading : ResponderState::free, false);
 	if (reprap.Debug(moduleWebserver))
 	{
@@ -1122,6 +1349,14 @@ void HttpResponder::ProcessRequest() noexcept
 	{
 		if (StringEqualsIgnoreCase(commandWords[0], "GET"))
 		{
+#if SUPPORT_OBJECT_MODEL
+			const char *_ecv_array const upgrade = GetHeaderValue("Upgrade");
+			if (upgrade != nullptr && StringEqualsIgnoreCase(upgrade, "websocket"))
+			{
+				StartWebSocket();
+				return;
+			}
+#endif
 			if (StringStartsWith(commandWords[1], KO_START))
 			{
 				SendJsonResponse(commandWords[1] + KoFirst);
@@ -1374,6 +1609,319 @@ void HttpResponder::CancelUpload() noexcept
 	UploadingNetworkResponder::CancelUpload();
 }
 
+// This overrides the version in class UploadingNetworkResponder
+void HttpResponder::ConnectionLost() noexcept
+{
+	EndWebSocket();
+	UploadingNetworkResponder::ConnectionLost();
+}
+
+// Release our claim on one of the WebSocket slots, if we have one
+void HttpResponder::EndWebSocket() noexcept
+{
+	if (isWebSocket)
+	{
+		isWebSocket = false;
+		--numWebSockets;
+	}
+}
+
+#if SUPPORT_OBJECT_MODEL
+
+// WebSocket support.
+// A client may upgrade a GET request for rr_model to a WebSocket connection. The optional "flags" qualifier is used as for rr_model and defaults to "d99fn",
+// i.e. the live values and seqs. We push that response in a text frame whenever a value in seqs has changed, subject to WebSocketMinPushInterval,
+// and every WebSocketLivePushInterval otherwise. The client can then fetch whatever seqs says has changed using rr_model over HTTP as usual.
+// We reply to pings and closes from the client and ignore any other frames it sends.
+static const char * const WebSocketGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+static void Base64Encode(const uint8_t *_ecv_array data, size_t len, const StringRef& result) noexcept
+{
+	static const char Base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	result.Clear();
+	for (size_t i = 0; i < len; i += 3)
+	{
+		const uint32_t val = ((uint32_t)data[i] << 16) | ((i + 1 < len) ? (uint32_t)data[i + 1] << 8 : 0) | ((i + 2 < len) ? (uint32_t)data[i + 2] : 0);
+		result.cat(Base64Chars[(val >> 18) & 0x3F]);
+		result.cat(Base64Chars[(val >> 12) & 0x3F]);
+		result.cat((i + 1 < len) ? Base64Chars[(val >> 6) & 0x3F] : '=');
+		result.cat((i + 2 < len) ? Base64Chars[val & 0x3F] : '=');
+	}
+}
+
+// Handle a request to upgrade the connection to a WebSocket
+void HttpResponder::StartWebSocket() noexcept
+{
+	const char *_ecv_array const path = (commandWords[1][0] == '/') ? commandWords[1] + 1 : commandWords[1];
+	if (!StringEqualsIgnoreCase(path, KO_START "model"))
+	{
+		RejectMessage("WebSocket endpoint not found", 404);
+		return;
+	}
+
+	if (!CheckAuthenticated() && reprap.NoPasswordSet())
+	{
+		Authenticate();
+	}
+	if (!CheckAuthenticated())
+	{
+		RejectMessage("Not authorized", 401);
+		return;
+	}
+
+	const char *_ecv_array const key = GetHeaderValue("Sec-WebSocket-Key");
+	const char *_ecv_array const version = GetHeaderValue("Sec-WebSocket-Version");
+	if (key == nullptr || version == nullptr || StrToU32(version) != 13)
+	{
+		RejectMessage("bad WebSocket handshake", 400);
+		return;
+	}
+
+	if (numWebSockets >= MaxWebSockets)
+	{
+		outBuf->copy(serviceUnavailableResponse);
+		Commit();
+		return;
+	}
+
+	// The accept value is the base64-encoded SHA1 hash of the key (without any trailing whitespace) followed by the GUID
+	size_t keyLength = strlen(key);
+	while (keyLength != 0 && (key[keyLength - 1] == ' ' || key[keyLength - 1] == '\t'))
+	{
+		--keyLength;
+	}
+	SHA1Context sha;
+	SHA1Reset(&sha);
+	SHA1Input(&sha, reinterpret_cast<const uint8_t *>(key), keyLength);
+	SHA1Input(&sha, reinterpret_cast<const uint8_t *>(WebSocketGuid), strlen(WebSocketGuid));
+	SHA1Result(&sha);
+	uint8_t digest[20];
+	for (size_t i = 0; i < sizeof(digest); ++i)
+	{
+		digest[i] = (uint8_t)(sha.Message_Digest[i/4] >> (24 - 8 * (i % 4)));
+	}
+	String<StringLength50> accept;
+	Base64Encode(digest, sizeof(digest), accept.GetRef());
+
+	const char *_ecv_array const flagsVal = GetKeyValue("flags");
+	wsFlags.copy((flagsVal != nullptr) ? flagsVal : "d99fn");
+
+	outBuf->copy(	"HTTP/1.1 101 Switching Protocols\r\n"
+					"Upgrade: websocket\r\n"
+					"Connection: Upgrade\r\n"
+				);
+	outBuf->catf("Sec-WebSocket-Accept: %s\r\n\r\n", accept.c_str());
+
+	isWebSocket = true;
+	++numWebSockets;
+	wsRxHeaderLength = 0;
+	wsRxInPayload = false;
+	wsLastPushTime = millis() - WebSocketLivePushInterval;		// push the first response as soon as the handshake has been sent
+	wsLastSeqsTotal = reprap.GetSeqsTotal();
+	Commit(ResponderState::webSocket);
+}
+
+// Do some work on a WebSocket connection, returning true if we did anything significant
+bool HttpResponder::DoWebSocket() noexcept
+{
+	// Process any frames from the client
+	bool readSomething = false;
+	char c;
+	while (skt->ReadChar(c))
+	{
+		readSomething = true;
+		if (WebSocketCharFromClient((uint8_t)c))
+		{
+			return true;							// we committed a reply
+		}
+	}
+
+	if (!skt->CanRead())
+	{
+		ConnectionLost();							// the client has gone away
+		return true;
+	}
+
+	const uint32_t now = millis();
+	if (now - wsLastPushTime < WebSocketMinPushInterval)
+	{
+		return readSomething;
+	}
+
+	const uint32_t seqsTotal = reprap.GetSeqsTotal();
+	if (seqsTotal == wsLastSeqsTotal && now - wsLastPushTime < WebSocketLivePushInterval)
+	{
+		return readSomething;
+	}
+
+	// Pushing counts as a query for the purpose of keeping the client's session alive. If the session has gone, e.g. because of rr_disconnect, so do we.
+	if (!CheckAuthenticated())
+	{
+		CloseWebSocket();
+		return true;
+	}
+
+	OutputBuffer *response = reprap.GetModelResponse(nullptr, nullptr, wsFlags.c_str());
+	if (response == nullptr || !OutputBuffer::Allocate(outBuf))
+	{
+		// We ran out of buffers, so try again later
+		OutputBuffer::ReleaseAll(response);
+		wsLastPushTime = now;
+		return readSomething;
+	}
+
+	// Send the response as a single unmasked text frame
+	const size_t length = response->Length();
+	outBuf->cat((char)0x81);
+	if (length <= 125)
+	{
+		outBuf->cat((char)length);
+	}
+	else if (length <= 0xFFFF)
+	{
+		outBuf->cat((char)126);
+		outBuf->cat((char)(length >> 8));
+		outBuf->cat((char)length);
+	}
+	else
+	{
+		outBuf->cat((char)127);
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			outBuf->cat((char)0);
+		}
+		for (int shift = 24; shift >= 0; shift -= 8)
+		{
+			outBuf->cat((char)(length >> shift));
+		}
+	}
+	outBuf->Append(response);
+
+	if (outBuf->HadOverflow())
+	{
+		OutputBuffer::ReleaseAll(outBuf);
+		ReportOutputBufferExhaustion(__FILE__, __LINE__);
+		wsLastPushTime = now;
+		return true;
+	}
+
+	wsLastPushTime = now;
+	wsLastSeqsTotal = seqsTotal;
+	Commit(ResponderState::webSocket, false);
+	return true;
+}
+
+// Process a byte of a frame received from the client. Control frame payloads are stored in clientMessage, other payloads are discarded.
+// Return true if we committed a reply, in which case we must stop reading until it has been sent.
+bool HttpResponder::WebSocketCharFromClient(uint8_t c) noexcept
+{
+	if (!wsRxInPayload)
+	{
+		wsRxHeader[wsRxHeaderLength++] = c;
+		if (wsRxHeaderLength < 2)
+		{
+			return false;
+		}
+
+		const uint8_t len7 = wsRxHeader[1] & 0x7F;
+		const size_t headerLength = 2 + ((len7 == 126) ? 2 : (len7 == 127) ? 8 : 0) + (((wsRxHeader[1] & 0x80) != 0) ? 4 : 0);
+		if (wsRxHeaderLength < headerLength)
+		{
+			return false;
+		}
+
+		if (len7 == 126)
+		{
+			wsRxPayloadLength = ((uint32_t)wsRxHeader[2] << 8) | wsRxHeader[3];
+		}
+		else if (len7 == 127)
+		{
+			if ((wsRxHeader[2] | wsRxHeader[3] | wsRxHeader[4] | wsRxHeader[5]) != 0)
+			{
+				CloseWebSocket();				// we don't accept frames of 4GB or more
+				return true;
+			}
+			wsRxPayloadLength = ((uint32_t)wsRxHeader[6] << 24) | ((uint32_t)wsRxHeader[7] << 16) | ((uint32_t)wsRxHeader[8] << 8) | wsRxHeader[9];
+		}
+		else
+		{
+			wsRxPayloadLength = len7;
+		}
+
+		if ((wsRxHeader[0] & 0x08) != 0 && wsRxPayloadLength > 125)
+		{
+			CloseWebSocket();					// control frames may not have payloads longer than 125 bytes
+			return true;
+		}
+
+		wsRxPayloadIndex = 0;
+		wsRxInPayload = true;
+	}
+	else
+	{
+		// Unmask the payload byte. The mask key is the last 4 bytes of the header.
+		if ((wsRxHeader[1] & 0x80) != 0)
+		{
+			c ^= wsRxHeader[wsRxHeaderLength - 4 + (wsRxPayloadIndex & 3)];
+		}
+		if ((wsRxHeader[0] & 0x08) != 0)
+		{
+			clientMessage[wsRxPayloadIndex] = (char)c;
+		}
+		++wsRxPayloadIndex;
+	}
+
+	if (wsRxPayloadIndex < wsRxPayloadLength)
+	{
+		return false;
+	}
+
+	// We have received the whole frame
+	wsRxInPayload = false;
+	wsRxHeaderLength = 0;
+	switch (wsRxHeader[0] & 0x0F)
+	{
+	case 0x08:		// close
+		CloseWebSocket();
+		return true;
+
+	case 0x09:		// ping, so reply with a pong carrying the same payload
+		if (OutputBuffer::Allocate(outBuf))
+		{
+			outBuf->cat((char)0x8A);
+			outBuf->cat((char)wsRxPayloadLength);
+			for (size_t i = 0; i < wsRxPayloadLength; ++i)
+			{
+				outBuf->cat(clientMessage[i]);
+			}
+			Commit(ResponderState::webSocket, false);
+			return true;
+		}
+		return false;
+
+	default:		// we ignore data frames and pongs from the client
+		return false;
+	}
+}
+
+// Send a close frame and close the connection when it has been sent
+void HttpResponder::CloseWebSocket() noexcept
+{
+	EndWebSocket();
+	if (outBuf != nullptr || OutputBuffer::Allocate(outBuf))
+	{
+		outBuf->cat((char)0x88);
+		outBuf->cat((char)0);
+		Commit(ResponderState::free, false);
+	}
+	else
+	{
+		ConnectionLost();
+	}
+}
+
+#endif
+
 // This overrides the version in class NetworkResponder
 void HttpResponder::SendData() noexcept
 {
@@ -1525,6 +2073,7 @@ void HttpResponder::AddCorsHeader() noexcept
 
 HttpResponder::HttpSession HttpResponder::sessions[MaxHttpSessions];
 unsigned int HttpResponder::numSessions = 0;
+unsigned int HttpResponder::numWebSockets = 0;
 unsigned int HttpResponder::clientsServed = 0;
 
 volatile uint16_t HttpResponder::seq = 0;
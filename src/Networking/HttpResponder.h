@@ -10,6 +10,14 @@
 
 #include "UploadingNetworkResponder.h"
 
+#ifndef MAX_HTTP_SESSIONS
+# ifdef __LPC17xx__
+#  define MAX_HTTP_SESSIONS	2						// maximum number of simultaneous HTTP sessions
+# else
+#  define MAX_HTTP_SESSIONS	8						// maximum number of simultaneous HTTP sessions
+# endif
+#endif
+
 class HttpResponder : public UploadingNetworkResponder
 {
 public:
@@ -30,13 +38,10 @@ public:
 protected:
 	void CancelUpload() noexcept override;
 	void SendData() noexcept override;
+	void ConnectionLost() noexcept override;
 
 private:
-#ifdef __LPC17xx__
-	static const size_t MaxHttpSessions = 2;            // maximum number of simultaneous HTTP sessions
-#else
-	static const size_t MaxHttpSessions = 8;			// maximum number of simultaneous HTTP sessions
-#endif
+	static const size_t MaxHttpSessions = MAX_HTTP_SESSIONS;
 	static const uint16_t WebMessageLength = 1460;		// maximum length of the web message we accept after decoding
 	static const size_t MaxCommandWords = 4;			// max number of space-separated words in the command
 	static const size_t MaxQualKeys = 5;				// max number of key/value pairs in the qualifier
@@ -44,6 +49,9 @@ private:
 	static const uint32_t HttpSessionTimeout = 8000;	// HTTP session timeout in milliseconds
 	static const uint32_t MaxFileInfoGetTime = 2000;	// maximum length of time we spend getting file info, to avoid the client timing out (actual time will be a little longer than this)
 	static const uint32_t MaxBufferWaitTime = 1000;		// maximum length of time we spend waiting for a buffer before we discard gcodeReply buffers
+	static const unsigned int MaxWebSockets = 2;		// maximum number of responders that may be tied up serving WebSocket connections
+	static const uint32_t WebSocketMinPushInterval = 100;	// minimum interval in milliseconds between object model pushes to each WebSocket client
+	static const uint32_t WebSocketLivePushInterval = 1000;	// how often we push the live values when nothing in seqs has changed
 
 	enum class HttpParseState
 	{
@@ -90,12 +98,24 @@ private:
 	void RejectMessage(const char *_ecv_array s, unsigned int code = 500) noexcept;
 	bool SendFileInfo(bool quitEarly) noexcept;
 	void AddCorsHeader() noexcept;
+	void ResetParser() noexcept;
+	bool KeepAliveRequested() const noexcept;
+	void CommitResponse(bool keepOpen) noexcept;
+
+#if SUPPORT_OBJECT_MODEL
+	void StartWebSocket() noexcept;
+	bool DoWebSocket() noexcept;
+	bool WebSocketCharFromClient(uint8_t c) noexcept;
+	void CloseWebSocket() noexcept;
+#endif
+	void EndWebSocket() noexcept;
 
 #if HAS_MASS_STORAGE
 	void DoUpload() noexcept;
 #endif
 
 	const char* GetKeyValue(const char *_ecv_array key) const noexcept;	// return the value of the specified key, or nullptr if not present
+	const char* GetHeaderValue(const char *_ecv_array key) const noexcept;	// return the value of the specified header, or nullptr if not present
 
 	static void RemoveSession(size_t sessionToRemove) noexcept;
 
@@ -113,6 +133,18 @@ private:
 	size_t numCommandWords;
 	size_t numQualKeys;								// number of qualifier keys we have found, <= maxQualKeys
 	size_t numHeaderKeys;							// number of keys we have found, <= maxHeaders
+	bool keptAlive;									// true if we have already sent at least one response on this connection and kept it open
+
+	// WebSocket connections
+	String<StringLength20> wsFlags;					// the flags we pass to GetModelResponse when pushing
+	uint32_t wsLastPushTime;
+	uint32_t wsLastSeqsTotal;
+	uint32_t wsRxPayloadLength;						// length of the payload of the frame we are receiving
+	uint32_t wsRxPayloadIndex;						// how many payload bytes of that frame we have received
+	uint8_t wsRxHeader[14];							// the header of the frame we are receiving
+	uint8_t wsRxHeaderLength;
+	bool wsRxInPayload;
+	bool isWebSocket;
 
 	// rr_fileinfo requests
 	uint32_t startedProcessingRequestAt;			// when we started processing the current HTTP request
@@ -127,6 +159,7 @@ private:
 	static HttpSession sessions[MaxHttpSessions];
 	static unsigned int numSessions;
 	static unsigned int clientsServed;
+	static unsigned int numWebSockets;
 
 	// Responses from GCodes class
 	static volatile uint16_t seq;					// Sequence number for G-Code replies
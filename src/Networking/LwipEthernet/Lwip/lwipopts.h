@@ -93,6 +93,14 @@
 #define CHECKSUM_CHECK_UDP			0		// use hardware checking of incoming UDP checksums
 #define CHECKSUM_CHECK_TCP			0		// use hardware checking of incoming TCP checksums
 
+#if defined(__SAME54P20A__) || defined(__SAME51N19A__)
+// The SAME5x GMAC is configured with the full-size transmit packet buffer, so it can also insert the IP, UDP and TCP checksums of outgoing frames.
+// It doesn't generate ICMP checksums, so lwip still does those.
+# define CHECKSUM_GEN_IP			0
+# define CHECKSUM_GEN_UDP			0
+# define CHECKSUM_GEN_TCP			0
+#endif
+
 #define LWIP_DONT_PROVIDE_BYTEORDER_FUNCTIONS	1
 #define lwip_htons(_x)			__builtin_bswap16(_x)
 #define lwip_htonl(_x)			__builtin_bswap32(_x)
@@ -115,7 +123,9 @@
  * MEM_SIZE: the size of the heap memory. If the application will send
  * a lot of data that needs to be copied, this should be set high.
  */
-#define MEM_SIZE                		12288		// 8192 works too but then lwip reports mem errors. sadly "max" isn't working
+#ifndef MEM_SIZE
+# define MEM_SIZE                		12288		// 8192 works too but then lwip reports mem errors. sadly "max" isn't working
+#endif
 
 /**
  * MEMP_NUM_UDP_PCB: the number of UDP protocol control blocks. One
@@ -191,11 +201,13 @@
 /**
  * PBUF_POOL_SIZE: the number of buffers in the pbuf pool. Needs to be enough for IP packet reassembly.
  */
-#if defined(__SAME70Q20B__) || defined(__SAME70Q21B__) || defined(__SAMV71Q20B__) || defined(__SAMV71Q21B__)
+#ifndef PBUF_POOL_SIZE
+# if defined(__SAME70Q20B__) || defined(__SAME70Q21B__) || defined(__SAMV71Q20B__) || defined(__SAMV71Q21B__)
 // We may as well use the remainder of the non-cached RAM block for additional pbufs
-# define PBUF_POOL_SIZE                  (GMAC_RX_BUFFERS + GMAC_TX_BUFFERS + 15)
-#else
-# define PBUF_POOL_SIZE                  (GMAC_RX_BUFFERS + GMAC_TX_BUFFERS + 12)
+#  define PBUF_POOL_SIZE                 (GMAC_RX_BUFFERS + GMAC_TX_BUFFERS + 15)
+# else
+#  define PBUF_POOL_SIZE                 (GMAC_RX_BUFFERS + GMAC_TX_BUFFERS + 12)
+# endif
 #endif
 
 /**
@@ -262,7 +274,9 @@ extern uint32_t random32(void) noexcept;
  * TCP_WND: The size of a TCP window.  This must be at least
  * (2 * TCP_MSS) for things to work well
  */
-#define TCP_WND                 (4 * TCP_MSS)
+#ifndef TCP_WND
+# define TCP_WND                (4 * TCP_MSS)
+#endif
 
 /**
  * TCP_SND_BUF: TCP sender buffer space (bytes).
@@ -515,6 +515,21 @@ void LwipEthernetInterface::Diagnostics(MessageType mtype) noexcept
 	}
 	platform.Message(mtype, "\n");
 
+#if MEM_STATS && MEMP_STATS
+	// Report the high water marks and allocation failures of the memory pools that limit the number of connections and the throughput, then reset them
+	stats_mem& heapStats = lwip_stats.mem;
+	stats_mem& pbufStats = *lwip_stats.memp[MEMP_PBUF_POOL];
+	stats_mem& segStats = *lwip_stats.memp[MEMP_TCP_SEG];
+	platform.MessageF(mtype, "LwIP heap max %u/%u errs %u, pbufs max %u/%u errs %u, TCP segs max %u/%u errs %u\n",
+						(unsigned int)heapStats.max, (unsigned int)heapStats.avail, (unsigned int)heapStats.err,
+						(unsigned int)pbufStats.max, (unsigned int)pbufStats.avail, (unsigned int)pbufStats.err,
+						(unsigned int)segStats.max, (unsigned int)segStats.avail, (unsigned int)segStats.err);
+	heapStats.max = heapStats.used;
+	pbufStats.max = pbufStats.used;
+	segStats.max = segStats.used;
+	heapStats.err = pbufStats.err = segStats.err = 0;
+#endif
+
 #if LWIP_STATS
 	if (reprap.Debug(moduleNetwork))
 	{
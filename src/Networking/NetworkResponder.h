@@ -44,6 +44,7 @@ protected:
 		// HTTP responder additional states
 		processingRequest,
 		gettingFileInfo,								// getting file info
+		webSocket,										// connection has been upgraded to a WebSocket that we push object model updates on
 
 		// FTP responder additional states
 		waitingForPasvPort,
@@ -189,24 +189,38 @@ bool TelnetResponder::Spin() noexcept
 			return true;
 		}
 		{
-			// See if we can read anything
-			bool readSomething = false;
+			// See if we can read anything. Pass as many complete lines to the GCodes input as it has room for, so that streamed commands don't wait for one Spin each.
+			bool readSomething = false, processedLine = false;
 			char c;
-			while (!haveCompleteLine && skt->ReadChar(c))
+			for (;;)
 			{
-				CharFromClient(c);
-				readSomething = true;
-			}
+				while (!haveCompleteLine && skt->ReadChar(c))
+				{
+					CharFromClient(c);
+					readSomething = true;
+				}
 
-			if (!readSomething && !skt->CanRead())
-			{
-				ConnectionLost();
-				return true;
+				if (!readSomething && !skt->CanRead())
+				{
+					ConnectionLost();
+					return true;
+				}
+
+				if (!haveCompleteLine)
+				{
+					break;
+				}
+
+				ProcessLine();
+				processedLine = true;
+				if (haveCompleteLine || responderState != ResponderState::reading)
+				{
+					return true;					// the GCodes input is full, or the client logged out
+				}
 			}
 
-			if (haveCompleteLine)
+			if (processedLine)
 			{
-				ProcessLine();
 				return true;
 			}
 
@@ -79,6 +79,27 @@ void WIZCHIP_WRITE(uint32_t AddrSel, uint8_t wb) noexcept
 	WizSpi::ReleaseSS();
 }
 
+// Read a 16-bit register in a single SPI frame. The W5500 increments the address after each byte in variable data length mode.
+uint16_t WIZCHIP_READ16(uint32_t AddrSel) noexcept
+{
+	WizSpi::AssertSS();
+	WizSpi::SendAddress(AddrSel | (_W5500_SPI_READ_ | _W5500_SPI_VDM_OP_));
+	const uint8_t msb = WizSpi::ReadByte();
+	const uint8_t lsb = WizSpi::ReadByte();
+	WizSpi::ReleaseSS();
+	return ((uint16_t)msb << 8) | lsb;
+}
+
+// Write a 16-bit register in a single SPI frame
+void WIZCHIP_WRITE16(uint32_t AddrSel, uint16_t wb) noexcept
+{
+	WizSpi::AssertSS();
+	WizSpi::SendAddress(AddrSel | (_W5500_SPI_WRITE_ | _W5500_SPI_VDM_OP_));
+	WizSpi::WriteByte((uint8_t)(wb >> 8));
+	WizSpi::WriteByte((uint8_t)wb);
+	WizSpi::ReleaseSS();
+}
+
 void WIZCHIP_READ_BUF (uint32_t AddrSel, uint8_t* pBuf, uint16_t len) noexcept
 {
 	WizSpi::AssertSS();
@@ -116,12 +137,10 @@ uint16_t getSn_TX_FSR(uint8_t sn) noexcept
 	uint16_t val = 0, val1 = 0;
 	do
 	{
-		val1 = WIZCHIP_READ(Sn_TX_FSR(sn));
-		val1 = (val1 << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_FSR(sn),1));
+		val1 = WIZCHIP_READ16(Sn_TX_FSR(sn));
 		if (val1 != 0)
 		{
-			val = WIZCHIP_READ(Sn_TX_FSR(sn));
-			val = (val << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_FSR(sn),1));
+			val = WIZCHIP_READ16(Sn_TX_FSR(sn));
 		}
 	} while (val != val1);
 	return val;
@@ -132,12 +151,10 @@ uint16_t getSn_RX_RSR(uint8_t sn) noexcept
 	uint16_t val = 0, val1 = 0;
 	do
 	{
-		val1 = WIZCHIP_READ(Sn_RX_RSR(sn));
-		val1 = (val1 << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_RSR(sn),1));
+		val1 = WIZCHIP_READ16(Sn_RX_RSR(sn));
 		if (val1 != 0)
 		{
-			val = WIZCHIP_READ(Sn_RX_RSR(sn));
-			val = (val << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_RSR(sn),1));
+			val = WIZCHIP_READ16(Sn_RX_RSR(sn));
 		}
 	} while (val != val1);
 	return val;
@@ -1302,6 +1302,22 @@ void     WIZCHIP_READ_BUF (uint32_t AddrSel, uint8_t* pBuf, uint16_t len) noexce
  */
 void     WIZCHIP_WRITE_BUF(uint32_t AddrSel, const uint8_t* pBuf, uint16_t len) noexcept;
 
+/**
+ * @ingroup Basic_IO_function
+ * @brief It reads a 16-bit big-endian register in a single SPI frame.
+ * @param AddrSel Register address
+ * @return The value of the register
+ */
+uint16_t WIZCHIP_READ16(uint32_t AddrSel) noexcept;
+
+/**
+ * @ingroup Basic_IO_function
+ * @brief It writes a 16-bit big-endian register in a single SPI frame.
+ * @param AddrSel Register address
+ * @param wb Write data
+ */
+void     WIZCHIP_WRITE16(uint32_t AddrSel, uint16_t wb) noexcept;
+
 // Read into an IPAddress
 void WIZCHIP_READ_IP(uint32_t AddrSel, IPAddress& ip) noexcept;
 
@@ -2103,8 +2119,7 @@ uint16_t getSn_TX_FSR(uint8_t sn) noexcept;
  */
 static inline uint16_t getSn_TX_RD(uint8_t sn) noexcept
 {
-	const uint8_t msb = WIZCHIP_READ(Sn_TX_RD(sn));
-	return ((uint16_t)msb << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_RD(sn),1));
+	return WIZCHIP_READ16(Sn_TX_RD(sn));
 }
 
 /**
@@ -2116,8 +2131,7 @@ static inline uint16_t getSn_TX_RD(uint8_t sn) noexcept
  */
 static inline void setSn_TX_WR(uint8_t sn, uint16_t txwr) noexcept
 {
-	WIZCHIP_WRITE(Sn_TX_WR(sn), (uint8_t)(txwr >> 8));
-	WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_TX_WR(sn), 1), (uint8_t) txwr);
+	WIZCHIP_WRITE16(Sn_TX_WR(sn), txwr);
 }
 
 /**
@@ -2129,8 +2143,7 @@ static inline void setSn_TX_WR(uint8_t sn, uint16_t txwr) noexcept
  */
 static inline uint16_t getSn_TX_WR(uint8_t sn) noexcept
 {
-	const uint8_t msb = WIZCHIP_READ(Sn_TX_WR(sn));
-	return ((uint16_t)msb << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_TX_WR(sn),1));
+	return WIZCHIP_READ16(Sn_TX_WR(sn));
 }
 
 
@@ -2152,8 +2165,7 @@ uint16_t getSn_RX_RSR(uint8_t sn) noexcept;
  */
 static inline void setSn_RX_RD(uint8_t sn, uint16_t rxrd) noexcept
 {
-	WIZCHIP_WRITE(Sn_RX_RD(sn), (uint8_t)(rxrd >> 8));
-	WIZCHIP_WRITE(WIZCHIP_OFFSET_INC(Sn_RX_RD(sn),1), (uint8_t) rxrd);
+	WIZCHIP_WRITE16(Sn_RX_RD(sn), rxrd);
 }
 
 /**
@@ -2165,8 +2177,7 @@ static inline void setSn_RX_RD(uint8_t sn, uint16_t rxrd) noexcept
  */
 static inline uint16_t getSn_RX_RD(uint8_t sn) noexcept
 {
-	const uint8_t msb = WIZCHIP_READ(Sn_RX_RD(sn));
-	return ((uint16_t)msb << 8) + WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_RD(sn), 1));
+	return WIZCHIP_READ16(Sn_RX_RD(sn));
 }
 
 /**
@@ -2177,8 +2188,7 @@ static inline uint16_t getSn_RX_RD(uint8_t sn) noexcept
  */
 static inline uint16_t getSn_RX_WR(uint8_t sn) noexcept
 {
-	const uint8_t msb = WIZCHIP_READ(Sn_RX_WR(sn));
-	return ((uint16_t)msb << 8) | WIZCHIP_READ(WIZCHIP_OFFSET_INC(Sn_RX_WR(sn), 1));
+	return WIZCHIP_READ16(Sn_RX_WR(sn));
 }
 
 /**
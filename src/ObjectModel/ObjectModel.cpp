@@ -846,7 +846,7 @@ void ObjectModel::ReportArrayAsJson(OutputBuffer *buf, ObjectExplorationContext&
 		// Support retrieving just part of the array in case it is too large to write all of it to the buffer
 		if (i != startElement)
 		{
-			if (isRootArray && buf->Length() >= (OUTPUT_BUFFER_SIZE * (OUTPUT_BUFFER_COUNT - RESERVED_OUTPUT_BUFFERS))/2)
+			if (isRootArray && buf->Length() >= (OUTPUT_BUFFER_SIZE * (OUTPUT_BUFFER_COUNT - RESERVED_OUTPUT_BUFFERS) + LARGE_OUTPUT_BUFFER_SIZE * LARGE_OUTPUT_BUFFER_COUNT)/2)
 			{
 				// We've used half the buffer space already, so stop reporting
 				context.SetNextElement(i);
@@ -866,6 +866,26 @@ void ObjectModel::ReportArrayAsJson(OutputBuffer *buf, ObjectExplorationContext&
 	buf->cat(']');
 }
 
+#if OBJECT_MODEL_LOOKUP_CACHE_SIZE
+
+// Cache of recently found table entries, so that evaluating the same object model paths repeatedly doesn't need a binary search at each level.
+// Only the entry pointer is stored. A cached entry is used only if it lies within the table being searched and its name matches, so concurrent updates from
+// different tasks and hash collisions can only cause a cache miss, never a wrong result.
+static const ObjectModelTableEntry *_ecv_null lookupCache[OBJECT_MODEL_LOOKUP_CACHE_SIZE] = { 0 };
+
+// Hash the table identity and the current element of the path
+static inline size_t LookupCacheSlot(const ObjectModelTableEntry *_ecv_array tbl, const char *_ecv_array idString) noexcept
+{
+	uint32_t hash = (uint32_t)reinterpret_cast<uintptr_t>(tbl);
+	while (*idString != 0 && *idString != '.' && *idString != '[' && *idString != '^')
+	{
+		hash = (hash * 31u) + (uint8_t)*idString++;
+	}
+	return (hash ^ (hash >> 16)) & (OBJECT_MODEL_LOOKUP_CACHE_SIZE - 1);
+}
+
+#endif
+
 // Find the requested entry
 const ObjectModelTableEntry* ObjectModel::FindObjectModelTableEntry(const ObjectModelClassDescriptor *classDescriptor, uint8_t tableNumber, const char *_ecv_array idString) const noexcept
 {
@@ -882,6 +902,23 @@ const ObjectModelTableEntry* ObjectModel::FindObjectModelTableEntry(const Object
 	}
 
 	const size_t numEntries = descriptor[tableNumber + 1];
+
+#if OBJECT_MODEL_LOOKUP_CACHE_SIZE
+	// Empty and wildcard elements match any entry, so don't use the cache for them
+	const bool useCache = (idString[0] != 0 && idString[0] != '*');
+	size_t slot = 0;
+	if (useCache)
+	{
+		slot = LookupCacheSlot(tbl, idString);
+		const ObjectModelTableEntry *const cached = lookupCache[slot];
+		if (cached != nullptr && cached >= tbl && cached < tbl + numEntries && cached->IdCompare(idString) == 0)
+		{
+			return cached;
+		}
+	}
+#endif
+
+	const ObjectModelTableEntry *found = nullptr;
 	size_t low = 0, high = numEntries;
 	while (high > low)
 	{
@@ -889,7 +926,8 @@ const ObjectModelTableEntry* ObjectModel::FindObjectModelTableEntry(const Object
 		const int t = tbl[mid].IdCompare(idString);
 		if (t == 0)
 		{
-			return &tbl[mid];
+			found = &tbl[mid];
+			break;
 		}
 		if (t > 0)
 		{
@@ -900,11 +938,18 @@ const ObjectModelTableEntry* ObjectModel::FindObjectModelTableEntry(const Object
 			high = mid;
 		}
 	}
-	if (low < numEntries && tbl[low].IdCompare(idString) == 0)
+	if (found == nullptr && low < numEntries && tbl[low].IdCompare(idString) == 0)
 	{
-		return &tbl[low];
+		found = &tbl[low];
 	}
-	return nullptr;
+
+#if OBJECT_MODEL_LOOKUP_CACHE_SIZE
+	if (found != nullptr && useCache)
+	{
+		lookupCache[slot] = found;
+	}
+#endif
+	return found;
 }
 
 /*static*/ const char* ObjectModel::GetNextElement(const char *id) noexcept
@@ -1221,6 +1266,40 @@ void ObjectModel::ReportFloat(OutputBuffer *buf, const ExpressionValue& val) noe
 	{
 		buf->cat("null");						// avoid generating bad JSON if the value is a NaN or infinity
 	}
+	else if (fabsf(val.fVal) < 1.0e9)
+	{
+		// Format the value without using printf, which is slow for floating point values.
+		// The product of a float and a power of 10 up to 10^7 is exact in double precision, so rounding it to nearest even gives the same result as printf.
+		static constexpr uint32_t PowersOfTen[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+		static_assert(ARRAY_SIZE(PowersOfTen) == MaxFloatDigitsDisplayedAfterPoint + 1);
+
+		const unsigned int digitsAfterPoint = GetFloatDigitsAfterPoint(val.fVal, val.param);
+		const uint32_t scale = PowersOfTen[digitsAfterPoint];
+		const uint64_t scaled = (uint64_t)llrint(fabs((double)val.fVal) * (double)scale);
+		const uint32_t intPart = (uint32_t)(scaled/scale);
+		uint32_t fracPart = (uint32_t)(scaled - (uint64_t)intPart * scale);
+
+		char digits[22];							// enough for sign, 10 integer digits, point, 7 fraction digits and null
+		char *p = digits + sizeof(digits);
+		*--p = 0;
+		for (unsigned int i = 0; i < digitsAfterPoint; ++i)
+		{
+			*--p = (char)('0' + fracPart % 10);
+			fracPart /= 10;
+		}
+		*--p = '.';
+		uint32_t n = intPart;
+		do
+		{
+			*--p = (char)('0' + n % 10);
+			n /= 10;
+		} while (n != 0);
+		if (val.fVal < 0.0)
+		{
+			*--p = '-';
+		}
+		buf->cat(p);
+	}
 	else
 	{
 		buf->catf(val.GetFloatFormatString(), (double)val.fVal);
@@ -19,6 +19,13 @@
 #include <RTOSIface/RTOSIface.h>
 #include <Networking/NetworkDefs.h>
 
+// Number of entries in the cache of recently resolved object model path elements. Must be a power of 2, or zero to disable the cache.
+#ifndef OBJECT_MODEL_LOOKUP_CACHE_SIZE
+# define OBJECT_MODEL_LOOKUP_CACHE_SIZE	(32)
+#endif
+
+static_assert((OBJECT_MODEL_LOOKUP_CACHE_SIZE & (OBJECT_MODEL_LOOKUP_CACHE_SIZE - 1)) == 0, "OBJECT_MODEL_LOOKUP_CACHE_SIZE must be a power of 2");
+
 // Type codes to indicate what type of expression we have and how it is represented.
 // The "Special" type is for items that we have to evaluate when we are ready to write them out, in particular strings whose storage might disappear.
 enum class TypeCode : uint8_t
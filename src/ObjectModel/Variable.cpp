@@ -18,38 +18,65 @@ Variable::~Variable()
 	val.Release();
 }
 
-Variable* VariableSet::Lookup(const char *str) noexcept
+// Hash a variable name. This is the FNV-1a hash.
+/*static*/ uint32_t VariableSet::HashName(const char *str) noexcept
 {
-	LinkedVariable *lv;
-	for (lv = root; lv != nullptr; lv = lv->next)
+	uint32_t hash = 2166136261u;
+	while (*str != 0)
 	{
-		auto vname = lv->v.GetName();
-		if (strcmp(vname.Ptr(), str) == 0)
-		{
-			return &(lv->v);
-		}
+		hash = (hash ^ (uint8_t)*str++) * 16777619u;
 	}
-	return nullptr;
+	return hash;
 }
 
-const Variable* VariableSet::Lookup(const char *str) const noexcept
+// Find the most recently created variable with the specified name. Only variables whose hash matches need to have their names compared.
+VariableSet::LinkedVariable *VariableSet::Find(const char *str) const noexcept
 {
-	const LinkedVariable *lv;
-	for (lv = root; lv != nullptr; lv = lv->next)
+	const uint32_t hash = HashName(str);
+	for (LinkedVariable *lv = buckets[hash & (NumHashBuckets - 1)]; lv != nullptr; lv = lv->nextInBucket)
 	{
-		auto vname = lv->v.GetName();
-		if (strcmp(vname.Ptr(), str) == 0)
+		if (lv->hash == hash)
 		{
-			return &(lv->v);
+			auto vname = lv->v.GetName();
+			if (strcmp(vname.Ptr(), str) == 0)
+			{
+				return lv;
+			}
 		}
 	}
 	return nullptr;
 }
 
+// Unlink a variable from its hash bucket
+void VariableSet::RemoveFromBucket(LinkedVariable *lv) noexcept
+{
+	LinkedVariable **pp = &buckets[lv->hash & (NumHashBuckets - 1)];
+	while (*pp != lv)
+	{
+		pp = &((*pp)->nextInBucket);
+	}
+	*pp = lv->nextInBucket;
+}
+
+Variable* VariableSet::Lookup(const char *str) noexcept
+{
+	LinkedVariable * const lv = Find(str);
+	return (lv == nullptr) ? nullptr : &(lv->v);
+}
+
+const Variable* VariableSet::Lookup(const char *str) const noexcept
+{
+	const LinkedVariable * const lv = Find(str);
+	return (lv == nullptr) ? nullptr : &(lv->v);
+}
+
 void VariableSet::InsertNew(const char *str, ExpressionValue pVal, int8_t pScope) noexcept
 {
-	LinkedVariable * const toInsert = new LinkedVariable(str, pVal, pScope, root);
+	const uint32_t hash = HashName(str);
+	LinkedVariable *& bucket = buckets[hash & (NumHashBuckets - 1)];
+	LinkedVariable * const toInsert = new LinkedVariable(str, pVal, pScope, hash, root, bucket);
 	root = toInsert;
+	bucket = toInsert;
 }
 
 // Remove all variables with a scope greater than the parameter
@@ -70,6 +97,7 @@ void VariableSet::EndScope(uint8_t blockNesting) noexcept
 			{
 				prev->next = lv;
 			}
+			RemoveFromBucket(temp);
 			delete temp;
 		}
 		else
@@ -82,24 +110,17 @@ void VariableSet::EndScope(uint8_t blockNesting) noexcept
 
 void VariableSet::Delete(const char *str) noexcept
 {
-	LinkedVariable *prev = nullptr;
-	for (LinkedVariable *lv = root; lv != nullptr; lv = lv->next)
+	LinkedVariable * const toDelete = Find(str);
+	if (toDelete != nullptr)
 	{
-		auto vname = lv->v.GetName();
-		if (strcmp(vname.Ptr(), str) == 0)
+		LinkedVariable **pp = &root;
+		while (*pp != toDelete)
 		{
-			if (prev == nullptr)
-			{
-				root = lv->next;
-			}
-			else
-			{
-				prev->next = lv->next;
-			}
-			delete lv;
-			break;
+			pp = &((*pp)->next);
 		}
-		prev = lv;
+		*pp = toDelete->next;
+		RemoveFromBucket(toDelete);
+		delete toDelete;
 	}
 }
 
@@ -111,6 +132,10 @@ void VariableSet::Clear() noexcept
 		root = lv->next;
 		delete lv;
 	}
+	for (LinkedVariable *&bucket : buckets)
+	{
+		bucket = nullptr;
+	}
 }
 
 VariableSet::~VariableSet()
@@ -124,6 +149,11 @@ void VariableSet::AssignFrom(VariableSet& other) noexcept
 	Clear();
 	root = other.root;
 	other.root = nullptr;
+	for (size_t i = 0; i < NumHashBuckets; ++i)
+	{
+		buckets[i] = other.buckets[i];
+		other.buckets[i] = nullptr;
+	}
 }
 
 void VariableSet::IterateWhile(function_ref<bool(unsigned int, const Variable&) /*noexcept*/ > func) const noexcept
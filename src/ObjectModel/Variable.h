@@ -33,11 +33,12 @@ private:
 };
 
 // Class to represent a collection of variables.
-// For now this is just a linked list, but it could be changed to a hash table for faster lookup and insertion.
+// The variables are kept in a linked list in reverse order of creation, which is the order used by IterateWhile.
+// Each variable is also linked into a hash bucket keyed on its name so that lookups don't need to compare every name in the set.
 class VariableSet
 {
 public:
-	VariableSet() noexcept : root(nullptr) { }
+	VariableSet() noexcept : root(nullptr), buckets() { }
 	~VariableSet();
 	VariableSet(const VariableSet&) = delete;
 	VariableSet& operator=(const VariableSet& other) = delete;
@@ -55,17 +56,27 @@ public:
 	void IterateWhile(function_ref<bool(unsigned int index, const Variable& v) /*noexcept*/ > func) const noexcept;
 
 private:
+	static constexpr size_t NumHashBuckets = 8;				// must be a power of 2
+
 	struct LinkedVariable
 	{
 		DECLARE_FREELIST_NEW_DELETE(LinkedVariable)
 
-		LinkedVariable(const char *_ecv_array str, ExpressionValue pVal, int8_t pScope, LinkedVariable *p_next) : next(p_next), v(str, pVal, pScope) {}
+		LinkedVariable(const char *_ecv_array str, ExpressionValue pVal, int8_t pScope, uint32_t p_hash, LinkedVariable *p_next, LinkedVariable *p_nextInBucket)
+			: next(p_next), nextInBucket(p_nextInBucket), hash(p_hash), v(str, pVal, pScope) {}
 
 		LinkedVariable * null next;
+		LinkedVariable * null nextInBucket;
+		uint32_t hash;
 		Variable v;
 	};
 
+	static uint32_t HashName(const char *_ecv_array str) noexcept;
+	LinkedVariable *null Find(const char *_ecv_array str) const noexcept;
+	void RemoveFromBucket(LinkedVariable *lv) noexcept;
+
 	LinkedVariable * null root;
+	LinkedVariable * null buckets[NumHashBuckets];
 };
 
 #endif /* SRC_GCODES_VARIABLE_H_ */
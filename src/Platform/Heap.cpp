@@ -13,13 +13,21 @@
 #include <Platform/Tasks.h>
 #include <Platform/Platform.h>
 #include <Platform/RepRap.h>
+#include <Movement/StepTimer.h>
 #include <General/String.h>
 #include <atomic>
 
 #define CHECK_HANDLES	(1)							// set nonzero to check that handles are valid before dereferencing them
 
+#ifndef STRING_HEAP_BLOCK_SIZE
+# define STRING_HEAP_BLOCK_SIZE	(2048)				// the size of each heap block, may be overridden in the build configuration
+#endif
+
 constexpr size_t IndexBlockSlots = 99;				// number of 4-byte handles per index block, plus one for link to next index block
-constexpr size_t HeapBlockSize = 2048;				// the size of each heap block
+constexpr size_t HeapBlockSize = STRING_HEAP_BLOCK_SIZE;
+constexpr size_t MinRecyclableForIncrementalGc = HeapBlockSize/16;	// how much recyclable space there must be before we compact from the main loop
+
+static_assert(HeapBlockSize % 2 == 0 && HeapBlockSize <= 65534, "STRING_HEAP_BLOCK_SIZE must be even and fit in the 16-bit length field");
 
 struct StorageSpace
 {
@@ -70,6 +78,9 @@ size_t StringHandle::heapAllocated = 0;
 size_t StringHandle::heapUsed = 0;
 std::atomic<size_t> StringHandle::heapToRecycle = 0;
 unsigned int StringHandle::gcCyclesDone = 0;
+HeapBlock *StringHandle::nextBlockToCompact = nullptr;
+unsigned int StringHandle::incrementalGcStepsDone = 0;
+uint32_t StringHandle::maxAllocateTicks = 0;
 
 /*static*/ void StringHandle::GarbageCollect() noexcept
 {
@@ -84,73 +95,99 @@ unsigned int StringHandle::gcCyclesDone = 0;
 #endif
 
 	heapUsed = 0;
-	for (HeapBlock *currentBlock = heapRoot; currentBlock != nullptr; )
+	for (HeapBlock *currentBlock = heapRoot; currentBlock != nullptr; currentBlock = currentBlock->next)
+	{
+		CompactBlock(currentBlock);
+		heapUsed += currentBlock->allocated;
+	}
+
+	heapToRecycle = 0;
+	++gcCyclesDone;
+}
+
+// Compact a single heap block if enough space is waiting to be recycled. Called from the main loop so that the heap is tidied up a block
+// at a time, which keeps the time taken bounded and makes it less likely that AllocateSpace will need to do a full garbage collection.
+/*static*/ void StringHandle::IncrementalGarbageCollect() noexcept
+{
+	if (heapToRecycle >= MinRecyclableForIncrementalGc)
+	{
+		WriteLocker locker(heapLock);
+
+		HeapBlock * const currentBlock = (nextBlockToCompact != nullptr) ? nextBlockToCompact : heapRoot;
+		if (currentBlock != nullptr)
+		{
+			const size_t reclaimed = CompactBlock(currentBlock);
+			heapUsed -= reclaimed;
+			heapToRecycle -= min<size_t>(reclaimed, heapToRecycle);
+			nextBlockToCompact = currentBlock->next;			// heap blocks are never freed, so it's safe to remember this
+			++incrementalGcStepsDone;
+		}
+	}
+}
+
+// Move the used storage in a heap block down to squeeze out the free entries. Returns the number of bytes reclaimed. Must own the write lock when calling this.
+/*static*/ size_t StringHandle::CompactBlock(HeapBlock *currentBlock) noexcept
+{
+	const size_t oldAllocated = currentBlock->allocated;
+	// Skip any used blocks at the start because they won't be moved
+	char *p = currentBlock->data;
+	while (p < currentBlock->data + currentBlock->allocated)
 	{
-		// Skip any used blocks at the start because they won't be moved
-		char *p = currentBlock->data;
-		while (p < currentBlock->data + currentBlock->allocated)
+		const size_t len = reinterpret_cast<StorageSpace*>(p)->length;
+		if (len & 1u)					// if this slot has been marked as free
 		{
-			const size_t len = reinterpret_cast<StorageSpace*>(p)->length;
-			if (len & 1u)					// if this slot has been marked as free
-			{
-				break;
-			}
-			p += len + sizeof(StorageSpace::length);
+			break;
 		}
+		p += len + sizeof(StorageSpace::length);
+	}
+
+	if (p < currentBlock->data + currentBlock->allocated)					// if we found an unused block before we reached the end
+	{
+		char* startSkip = p;
 
-		if (p < currentBlock->data + currentBlock->allocated)					// if we found an unused block before we reached the end
+		for (;;)
 		{
-			char* startSkip = p;
+			// Find the end of the unused blocks
+			while (p < currentBlock->data + currentBlock->allocated)
+			{
+				const size_t len = reinterpret_cast<StorageSpace*>(p)->length;
+				if ((len & 1u) == 0)
+				{
+					break;
+				}
+				p += (len & ~1u) + sizeof(StorageSpace::length);
+			}
 
-			for (;;)
+			if (p >= currentBlock->data + currentBlock->allocated)
+			{
+				currentBlock->allocated = startSkip - currentBlock->data;	// the unused blocks were at the end so just change the allocated size
+				break;
+			}
+			else
 			{
-				// Find the end of the unused blocks
+				// Find all the contiguous blocks
+				char *startUsed = p;
+				unsigned int numHandlesToAdjust = 0;
 				while (p < currentBlock->data + currentBlock->allocated)
 				{
 					const size_t len = reinterpret_cast<StorageSpace*>(p)->length;
-					if ((len & 1u) == 0)
+					if (len & 1u)
 					{
 						break;
 					}
-					p += (len & ~1u) + sizeof(StorageSpace::length);
+					++numHandlesToAdjust;
+					p += len + sizeof(StorageSpace::length);
 				}
 
-				if (p >= currentBlock->data + currentBlock->allocated)
-				{
-					currentBlock->allocated = startSkip - currentBlock->data;	// the unused blocks were at the end so just change the allocated size
-					break;
-				}
-				else
-				{
-					// Find all the contiguous blocks
-					char *startUsed = p;
-					unsigned int numHandlesToAdjust = 0;
-					while (p < currentBlock->data + currentBlock->allocated)
-					{
-						const size_t len = reinterpret_cast<StorageSpace*>(p)->length;
-						if (len & 1u)
-						{
-							break;
-						}
-						++numHandlesToAdjust;
-						p += len + sizeof(StorageSpace::length);
-					}
-
-					// Move the contiguous blocks down
-					memmove(startSkip, startUsed, p - startUsed);
-					//TODO make this more efficient by building up a small table of several adjustments, so we need to make fewer passes through the index
-					AdjustHandles(startUsed, p, startUsed - startSkip, numHandlesToAdjust);
-					startSkip += p - startUsed;
-				}
+				// Move the contiguous blocks down
+				memmove(startSkip, startUsed, p - startUsed);
+				//TODO make this more efficient by building up a small table of several adjustments, so we need to make fewer passes through the index
+				AdjustHandles(startUsed, p, startUsed - startSkip, numHandlesToAdjust);
+				startSkip += p - startUsed;
 			}
 		}
-
-		heapUsed += currentBlock->allocated;
-		currentBlock = currentBlock->next;
 	}
-
-	heapToRecycle = 0;
-	++gcCyclesDone;
+	return oldAllocated - currentBlock->allocated;
 }
 
 // Find all handles pointing to storage between startAddr and endAddr and move the pointers down by amount moveDown
@@ -301,6 +338,19 @@ unsigned int StringHandle::gcCyclesDone = 0;
 
 	length = min<size_t>((length + 1) & (~1u), HeapBlockSize - sizeof(StorageSpace::length));	// round to an even length to keep things aligned and limit to max size
 
+	const uint32_t startTicks = StepTimer::GetTimerTicks();
+	StorageSpace * const ret = AllocateSpaceInternal(length);
+	const uint32_t ticks = StepTimer::GetTimerTicks() - startTicks;
+	if (ticks > maxAllocateTicks)
+	{
+		maxAllocateTicks = ticks;
+	}
+	return ret;
+}
+
+// Allocate the requested space, which has already been rounded and limited. Must own the write lock when calling this.
+/*static*/ StorageSpace *StringHandle::AllocateSpaceInternal(size_t length) noexcept
+{
 	bool collected = false;
 	do
 	{
@@ -494,8 +544,12 @@ size_t StringHandle::GetLength() const noexcept
 	{
 		temp.copy("Heap OK");
 	}
-	temp.catf(", handles allocated/used %u/%u, heap memory allocated/used/recyclable %u/%u/%u, gc cycles %u\n",
-					handlesAllocated, (unsigned int)handlesUsed, heapAllocated, heapUsed, (unsigned int)heapToRecycle, gcCyclesDone);
+	const size_t recyclable = heapToRecycle;
+	temp.catf(", handles allocated/used %u/%u, heap memory allocated/used/recyclable %u/%u/%u (%u%%), gc cycles %u, incremental %u, max alloc time %" PRIu32 "us\n",
+					handlesAllocated, (unsigned int)handlesUsed, heapAllocated, heapUsed, recyclable,
+					(heapUsed == 0) ? 0 : (unsigned int)((recyclable * 100u)/heapUsed), gcCyclesDone, incrementalGcStepsDone,
+					(uint32_t)(((uint64_t)maxAllocateTicks * 1000000u)/StepClockRate));
+	maxAllocateTicks = 0;
 	p.Message(mt, temp.c_str());
 }
 
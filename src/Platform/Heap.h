@@ -40,6 +40,7 @@ public:
 	void Assign(const char *s) noexcept;
 
 	static void GarbageCollect() noexcept;
+	static void IncrementalGarbageCollect() noexcept;
 //	static size_t GetWastedSpace() noexcept { return spaceToRecycle; }
 //	static size_t GetIndexSpace() noexcept { return totalIndexSpace; }
 //	static size_t GetHeapSpace() noexcept { return totalHeapSpace; }
@@ -52,7 +53,9 @@ protected:
 
 	static IndexSlot *AllocateHandle() noexcept;
 	static StorageSpace *AllocateSpace(size_t length) noexcept;
+	static StorageSpace *AllocateSpaceInternal(size_t length) noexcept;
 	static void GarbageCollectInternal() noexcept;
+	static size_t CompactBlock(HeapBlock *currentBlock) noexcept;
 	static void AdjustHandles(char *startAddr, char *endAddr, size_t moveDown, unsigned int numHandles) noexcept;
 
 	IndexSlot * null slotPtr;
@@ -66,6 +69,9 @@ protected:
 	static size_t heapUsed;
 	static std::atomic<size_t> heapToRecycle;
 	static unsigned int gcCyclesDone;
+	static HeapBlock *nextBlockToCompact;
+	static unsigned int incrementalGcStepsDone;
+	static uint32_t maxAllocateTicks;
 };
 
 // Version of StringHandle that updates the reference counts automatically
@@ -13,6 +13,7 @@
 #include "RepRap.h"
 #include "Platform.h"
 #include "Version.h"
+#include <RTOSIface/RTOSIface.h>
 
 // Simple lock class that sets a variable true when it is created and makes sure it gets set false when it falls out of scope
 class Lock
@@ -25,7 +26,9 @@ private:
 	bool& b;
 };
 
-Logger::Logger(LogLevel logLvl) noexcept : logFile(), lastFlushTime(0), lastFlushFileSize(0), dirty(false), inLogger(false), logLevel(logLvl)
+Logger::Logger(LogLevel logLvl) noexcept
+	: readIndex(0), writeIndex(0), maxBytesQueued(0), messagesDropped(0),
+	  logFile(), lastWriteTime(0), lastFlushTime(0), lastFlushFileSize(0), dirty(false), inLogger(false), logLevel(logLvl)
 {
 }
 
@@ -41,6 +44,7 @@ GCodeResult Logger::Start(time_t time, const StringRef& filename, const StringRe
 			return GCodeResult::error;
 		}
 
+		readIndex = writeIndex = 0;							// discard anything left over from a log file that we failed to write
 		logFile.Set(f);
 		lastFlushFileSize = logFile.Length();
 		logFile.Seek(lastFlushFileSize);
@@ -82,6 +86,7 @@ void Logger::Stop(time_t time) noexcept
 	{
 		Lock loggerLock(inLogger);
 		InternalLogMessage(time, "Event logging stopped\n", MessageLogLevel::info);
+		(void)WriteQueuedData(BytesQueued());
 		logFile.Close();
 		reprap.StateUpdated();
 	}
@@ -105,81 +110,148 @@ bool Logger::IsLoggingEnabledFor(const MessageType mt) const noexcept
 }
 #endif
 
+// The LogMessage functions may be called from any task. They only copy the message into the ring buffer; the file is written by Flush.
 void Logger::LogMessage(time_t time, const char *message, MessageType type) noexcept
 {
-
-	if (logFile.IsLive() && !inLogger && !IsEmptyMessage(message))
+	if (logFile.IsLive() && !IsEmptyMessage(message))
 	{
 		const auto messageLogLevel = GetMessageLogLevel(type);
-		if (!IsLoggingEnabledFor(messageLogLevel))
+		if (IsLoggingEnabledFor(messageLogLevel))
 		{
-			return;
+			InternalLogMessage(time, message, messageLogLevel);
 		}
-		Lock loggerLock(inLogger);
-		InternalLogMessage(time, message, messageLogLevel);
 	}
 }
 
 void Logger::LogMessage(time_t time, OutputBuffer *buf, MessageType type) noexcept
 {
-	if (logFile.IsLive() && !inLogger && !IsEmptyMessage(buf->Data()))
+	if (logFile.IsLive() && !IsEmptyMessage(buf->Data()))
 	{
 		const auto messageLogLevel = GetMessageLogLevel(type);
 		if (!IsLoggingEnabledFor(messageLogLevel))
 		{
 			return;
 		}
-		Lock loggerLock(inLogger);
-		bool ok = WriteDateTimeAndLogLevelPrefix(time, messageLogLevel);
-		if (ok)
-		{
-			ok = buf->WriteToFile(logFile);
-		}
 
-		if (ok)
+		String<StringLength50> prefix;
+		FormatDateTimeAndLogLevelPrefix(time, messageLogLevel, prefix.GetRef());
+		const size_t totalLength = prefix.strlen() + buf->Length();
+
+		TaskCriticalSectionLocker lock;
+		if (totalLength > SpaceLeft())
 		{
-			dirty = true;
+			++messagesDropped;
+			return;
 		}
-		else
+		AppendToBuffer(prefix.c_str(), prefix.strlen());
+		for (const OutputBuffer *b = buf; b != nullptr; b = b->Next())
 		{
-			logFile.Close();
-			reprap.StateUpdated();
+			AppendToBuffer(b->Data(), b->DataLength());
 		}
 	}
 }
 
-// Version of LogMessage for when we already know we want to proceed and we have already set inLogger
+// Version of LogMessage for when we already know we want to proceed
 void Logger::InternalLogMessage(time_t time, const char *message, const MessageLogLevel messageLogLevel) noexcept
 {
-	bool ok = WriteDateTimeAndLogLevelPrefix(time, messageLogLevel);
-	if (ok)
+	String<StringLength50> prefix;
+	FormatDateTimeAndLogLevelPrefix(time, messageLogLevel, prefix.GetRef());
+	const size_t len = strlen(message);
+	const bool addNewline = (len == 0 || message[len - 1] != '\n');
+	const size_t totalLength = prefix.strlen() + len + ((addNewline) ? 1 : 0);
+
+	TaskCriticalSectionLocker lock;
+	if (totalLength > SpaceLeft())
 	{
-		const size_t len = strlen(message);
-		if (len != 0)
-		{
-			ok = logFile.Write(message, len);
-		}
-		if (ok && (len == 0 || message[len - 1] != '\n'))
-		{
-			ok = logFile.Write('\n');
-		}
+		++messagesDropped;
+		return;
+	}
+	AppendToBuffer(prefix.c_str(), prefix.strlen());
+	AppendToBuffer(message, len);
+	if (addNewline)
+	{
+		AppendToBuffer("\n", 1);
 	}
+}
 
-	if (ok)
+// Copy data into the ring buffer. The caller must have locked out other tasks and checked that there is enough space.
+void Logger::AppendToBuffer(const char *data, size_t len) noexcept
+{
+	size_t wi = writeIndex;
+	while (len != 0)
 	{
-		dirty = true;
+		const size_t chunk = min<size_t>(len, LogBufferSize - wi);
+		memcpy(buffer + wi, data, chunk);
+		data += chunk;
+		len -= chunk;
+		wi = (wi + chunk) % LogBufferSize;
 	}
-	else
+	writeIndex = wi;
+
+	const size_t queued = BytesQueued();
+	if (queued > maxBytesQueued)
 	{
-		logFile.Close();
-		reprap.StateUpdated();
+		maxBytesQueued = queued;
 	}
 }
 
-// This is called regularly by Platform to give the logger an opportunity to flush the file buffer
+// Write the specified number of bytes from the ring buffer to the file.
+// Caller must already have checked and set inLogger. Only the tail of the buffer is touched here, so other tasks may keep appending to it.
+bool Logger::WriteQueuedData(size_t count) noexcept
+{
+	size_t ri = readIndex;
+	while (count != 0)
+	{
+		const size_t chunk = min<size_t>(count, LogBufferSize - ri);
+		if (!logFile.Write(buffer + ri, chunk))
+		{
+			return false;
+		}
+		count -= chunk;
+		ri = (ri + chunk) % LogBufferSize;
+		readIndex = ri;
+	}
+	dirty = true;
+	return true;
+}
+
+// This is called regularly by Platform to give the logger an opportunity to write queued messages and flush the file buffer
 void Logger::Flush(bool forced) noexcept
 {
-	if (logFile.IsLive() && dirty && !inLogger)
+	if (!logFile.IsLive() || inLogger)
+	{
+		return;
+	}
+
+	// Write queued messages to the file. Unless we are forced to or they have been waiting too long, write only whole sectors.
+	const size_t queued = BytesQueued();
+	if (queued == 0)
+	{
+		lastWriteTime = millis();
+	}
+	else
+	{
+		size_t toWrite = queued;
+		if (!forced && millis() - lastWriteTime < LogWriteInterval)
+		{
+			const size_t partSector = (logFile.GetPosition() + queued) % LogWriteChunkSize;
+			toWrite = (partSector < queued) ? queued - partSector : 0;
+		}
+
+		if (toWrite != 0)
+		{
+			Lock loggerLock(inLogger);
+			if (!WriteQueuedData(toWrite))
+			{
+				logFile.Close();
+				reprap.StateUpdated();
+				return;
+			}
+			lastWriteTime = millis();
+		}
+	}
+
+	if (dirty)
 	{
 		// Log file is dirty and can be flushed.
 		// To avoid excessive disk write operations, flush it only if one of the following is true:
@@ -199,12 +271,17 @@ void Logger::Flush(bool forced) noexcept
 	}
 }
 
-// Write the data, time and message log level to the file followed by a space.
-// Caller must already have checked and set inLogger.
-bool Logger::WriteDateTimeAndLogLevelPrefix(time_t time, MessageLogLevel messageLogLevel) noexcept
+// Report and reset the ring buffer statistics
+void Logger::Diagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "Event log buffer max used %u of %u bytes, messages dropped %u\n", maxBytesQueued, LogBufferSize - 1, messagesDropped);
+	maxBytesQueued = BytesQueued();
+	messagesDropped = 0;
+}
+
+// Format the date, time and message log level followed by a space
+void Logger::FormatDateTimeAndLogLevelPrefix(time_t time, MessageLogLevel messageLogLevel, const StringRef& buf) const noexcept
 {
-	String<StringLength50> bufferSpace;
-	const StringRef buf = bufferSpace.GetRef();
 	if (time == 0)
 	{
 		const uint32_t timeSincePowerUp = (uint32_t)(millis64()/1000u);
@@ -218,7 +295,6 @@ bool Logger::WriteDateTimeAndLogLevelPrefix(time_t time, MessageLogLevel message
 						timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday, timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec);
 	}
 	buf.catf("[%s] ", messageLogLevel.ToString());
-	return logFile.Write(buf.c_str());
 }
 
 #endif
@@ -27,6 +27,7 @@ public:
 	void LogMessage(time_t time, const char *message, MessageType type) noexcept;
 	void LogMessage(time_t time, OutputBuffer *buf, MessageType type) noexcept;
 	void Flush(bool forced) noexcept;
+	void Diagnostics(MessageType mtype) noexcept;
 	bool IsActive() const noexcept { return logFile.IsLive(); }
 	const char *GetFileName() const noexcept { return (IsActive()) ? logFileName.c_str() : nullptr; }
 	LogLevel GetLogLevel() const noexcept { return logLevel; }
@@ -44,14 +45,28 @@ private:
 
 	static const uint8_t LogEnabledThreshold = 3;
 
-	bool WriteDateTimeAndLogLevelPrefix(time_t time, MessageLogLevel messageLogLevel) noexcept;
+	static const size_t LogWriteChunkSize = 512;		// we try to write whole sectors to the file
+
+	void FormatDateTimeAndLogLevelPrefix(time_t time, MessageLogLevel messageLogLevel, const StringRef& buf) const noexcept;
 	void InternalLogMessage(time_t time, const char *message, const MessageLogLevel messageLogLevel) noexcept;
+	void AppendToBuffer(const char *data, size_t len) noexcept;
+	bool WriteQueuedData(size_t count) noexcept;
+	size_t BytesQueued() const noexcept { return (writeIndex + LogBufferSize - readIndex) % LogBufferSize; }
+	size_t SpaceLeft() const noexcept { return (readIndex + LogBufferSize - 1 - writeIndex) % LogBufferSize; }
 	bool IsLoggingEnabledFor(const MessageLogLevel mll) const noexcept { return (mll < MessageLogLevel::off) && (mll.ToBaseType() + logLevel.ToBaseType() >= LogEnabledThreshold); }
 	void LogFirmwareInfo(time_t time) noexcept;
 	bool IsEmptyMessage(const char * message) const noexcept { return message[0] == '\0' || (message[0] == '\n' && message[1] == '\0'); }
 
+	// Messages are queued in this ring buffer by whichever task logs them and written to the file by Flush, which Platform::Spin calls
+	char buffer[LogBufferSize];
+	volatile size_t readIndex;						// only changed by Flush and Stop
+	volatile size_t writeIndex;						// only changed by InternalLogMessage and LogMessage
+	size_t maxBytesQueued;
+	unsigned int messagesDropped;
+
 	String<MaxFilenameLength> logFileName;
 	FileData logFile;
+	uint32_t lastWriteTime;
 	uint32_t lastFlushTime;
 	FilePosition lastFlushFileSize;
 	bool dirty;
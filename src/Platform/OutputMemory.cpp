@@ -13,6 +13,9 @@
 /*static*/ OutputBuffer * volatile OutputBuffer::freeOutputBuffers = nullptr;		// Messages may also be sent by ISRs,
 /*static*/ volatile size_t OutputBuffer::usedOutputBuffers = 0;						// so make these volatile.
 /*static*/ volatile size_t OutputBuffer::maxUsedOutputBuffers = 0;
+/*static*/ OutputBuffer * volatile OutputBuffer::freeLargeOutputBuffers = nullptr;
+/*static*/ volatile size_t OutputBuffer::usedLargeOutputBuffers = 0;
+/*static*/ volatile size_t OutputBuffer::maxUsedLargeOutputBuffers = 0;
 
 //*************************************************************************************************
 // OutputBuffer class implementation
@@ -173,11 +176,11 @@ size_t OutputBuffer::copy(const char *_ecv_array src, size_t len) noexcept
 size_t OutputBuffer::cat(const char c) noexcept
 {
 	// See if we can append a char
-	if (last->dataLength == OUTPUT_BUFFER_SIZE)
+	if (last->dataLength == last->capacity)
 	{
 		// No - allocate a new item and copy the data
 		OutputBuffer *nextBuffer;
-		if (!Allocate(nextBuffer))
+		if (!AllocateNext(nextBuffer))
 		{
 			// We cannot store any more data
 			hadOverflow = true;
@@ -216,11 +219,11 @@ size_t OutputBuffer::cat(const char *_ecv_array src, size_t len) noexcept
 	size_t copied = 0;
 	while (copied < len)
 	{
-		if (last->dataLength == OUTPUT_BUFFER_SIZE)
+		if (last->dataLength == last->capacity)
 		{
 			// The last buffer is full
 			OutputBuffer *nextBuffer;
-			if (!Allocate(nextBuffer))
+			if (!AllocateNext(nextBuffer))
 			{
 				// We cannot store any more data, stop here
 				hadOverflow = true;
@@ -235,7 +238,7 @@ size_t OutputBuffer::cat(const char *_ecv_array src, size_t len) noexcept
 				item = item->Next();
 			} while (item != nextBuffer);
 		}
-		const size_t copyLength = min<size_t>(len - copied, OUTPUT_BUFFER_SIZE - last->dataLength);
+		const size_t copyLength = min<size_t>(len - copied, last->capacity - last->dataLength);
 		memcpy(last->data + last->dataLength, src + copied, copyLength);
 		last->dataLength += copyLength;
 		copied += copyLength;
@@ -349,42 +352,92 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 #endif
 
 // Initialise the output buffers manager
+// The data for all the buffers is carved out of a single slab. Small buffers come first, followed by the large ones.
 /*static*/ void OutputBuffer::Init() noexcept
 {
+	char *_ecv_array slab = new char[OUTPUT_BUFFER_COUNT * OUTPUT_BUFFER_SIZE + LARGE_OUTPUT_BUFFER_COUNT * LARGE_OUTPUT_BUFFER_SIZE];
+
 	freeOutputBuffers = nullptr;
 	for (size_t i = 0; i < OUTPUT_BUFFER_COUNT; i++)
 	{
-		freeOutputBuffers = new OutputBuffer(freeOutputBuffers);
+		freeOutputBuffers = new OutputBuffer(freeOutputBuffers, slab, OUTPUT_BUFFER_SIZE);
+		slab += OUTPUT_BUFFER_SIZE;
+	}
+
+	freeLargeOutputBuffers = nullptr;
+	for (size_t i = 0; i < LARGE_OUTPUT_BUFFER_COUNT; i++)
+	{
+		freeLargeOutputBuffers = new OutputBuffer(freeLargeOutputBuffers, slab, LARGE_OUTPUT_BUFFER_SIZE);
+		slab += LARGE_OUTPUT_BUFFER_SIZE;
 	}
 }
 
-// Allocates an output buffer instance which can be used for (large) string outputs. This must be thread safe. Not safe to call from interrupts!
-/*static*/ bool OutputBuffer::Allocate(OutputBuffer *&buf) noexcept
+// Take a buffer from the free list of the requested size class and initialise it. Returns false if that class has no free buffers.
+/*static*/ bool OutputBuffer::TakeFreeBuffer(OutputBuffer *&buf, bool large) noexcept
 {
-	{
-		TaskCriticalSectionLocker lock;
+	TaskCriticalSectionLocker lock;
 
+	if (large)
+	{
+		buf = freeLargeOutputBuffers;
+		if (buf == nullptr)
+		{
+			return false;
+		}
+		freeLargeOutputBuffers = buf->next;
+		usedLargeOutputBuffers++;
+		if (usedLargeOutputBuffers > maxUsedLargeOutputBuffers)
+		{
+			maxUsedLargeOutputBuffers = usedLargeOutputBuffers;
+		}
+	}
+	else
+	{
 		buf = freeOutputBuffers;
-		if (buf != nullptr)
+		if (buf == nullptr)
 		{
-			freeOutputBuffers = buf->next;
-			usedOutputBuffers++;
-			if (usedOutputBuffers > maxUsedOutputBuffers)
-			{
-				maxUsedOutputBuffers = usedOutputBuffers;
-			}
+			return false;
+		}
+		freeOutputBuffers = buf->next;
+		usedOutputBuffers++;
+		if (usedOutputBuffers > maxUsedOutputBuffers)
+		{
+			maxUsedOutputBuffers = usedOutputBuffers;
+		}
+	}
 
-			// Initialise the buffer before we release the lock in case another task uses it immediately
-			buf->next = nullptr;
-			buf->last = buf;
-			buf->dataLength = buf->bytesRead = 0;
-			buf->references = 1;					// assume it's only used once by default
-			buf->isReferenced = false;
-			buf->hadOverflow = false;
-			buf->UpdateWhenQueued();				// use the time of allocation as the default when-used time
+	// Initialise the buffer before we release the lock in case another task uses it immediately
+	buf->next = nullptr;
+	buf->last = buf;
+	buf->dataLength = buf->bytesRead = 0;
+	buf->references = 1;					// assume it's only used once by default
+	buf->isReferenced = false;
+	buf->hadOverflow = false;
+	buf->UpdateWhenQueued();				// use the time of allocation as the default when-used time
+	return true;
+}
 
-			return true;
-		}
+// Allocates an output buffer instance which can be used for (large) string outputs. This must be thread safe. Not safe to call from interrupts!
+// New chains start with a small buffer so that short replies don't tie up the large ones.
+/*static*/ bool OutputBuffer::Allocate(OutputBuffer *&buf) noexcept
+{
+	if (TakeFreeBuffer(buf, false) || TakeFreeBuffer(buf, true))
+	{
+		return true;
+	}
+
+	reprap.GetPlatform().LogError(ErrorCode::OutputStarvation);
+	return false;
+}
+
+// Allocate a buffer to extend this chain. Once the chain already spans more than one buffer the reply is evidently a long one,
+// so we prefer a large buffer. We also prefer a large buffer when the small ones are down to the number reserved for status responses.
+bool OutputBuffer::AllocateNext(OutputBuffer *&buf) const noexcept
+{
+	const bool preferLarge = last != this || OUTPUT_BUFFER_COUNT - usedOutputBuffers <= RESERVED_OUTPUT_BUFFERS;
+	if (TakeFreeBuffer(buf, preferLarge) || TakeFreeBuffer(buf, !preferLarge))
+	{
+		return true;
 	}
 
 	reprap.GetPlatform().LogError(ErrorCode::OutputStarvation);
@@ -395,7 +448,8 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 /*static*/ size_t OutputBuffer::GetBytesLeft(const OutputBuffer *writingBuffer) noexcept
 {
 	const size_t freeBuffers = OUTPUT_BUFFER_COUNT - usedOutputBuffers;
-	const size_t bytesLeft = OUTPUT_BUFFER_SIZE - writingBuffer->last->DataLength();
+	const size_t bytesLeft = writingBuffer->last->Capacity() - writingBuffer->last->DataLength()
+								+ (LARGE_OUTPUT_BUFFER_COUNT - usedLargeOutputBuffers) * LARGE_OUTPUT_BUFFER_SIZE;
 
 	if (freeBuffers < RESERVED_OUTPUT_BUFFERS)
 	{
@@ -431,8 +485,8 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 		}
 
 		// Unlink and free the last entry
+		releasedBytes += lastItem->Capacity();
 		ReleaseAll(previousItem->next);
-		releasedBytes += OUTPUT_BUFFER_SIZE;
 	} while (previousItem != buffer && releasedBytes < bytesNeeded);
 
 	// Update all the references to the last item
@@ -457,10 +511,19 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 	}
 	else
 	{
-		// Otherwise prepend it to the list of free output buffers again
-		buf->next = freeOutputBuffers;
-		freeOutputBuffers = buf;
-		usedOutputBuffers--;
+		// Otherwise prepend it to the free list of its size class again
+		if (buf->capacity > OUTPUT_BUFFER_SIZE)
+		{
+			buf->next = freeLargeOutputBuffers;
+			freeLargeOutputBuffers = buf;
+			usedLargeOutputBuffers--;
+		}
+		else
+		{
+			buf->next = freeOutputBuffers;
+			freeOutputBuffers = buf;
+			usedOutputBuffers--;
+		}
 	}
 	return nextBuffer;
 }
@@ -477,6 +540,11 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 {
 	reprap.GetPlatform().MessageF(mtype, "Used output buffers: %d of %d (%d max)\n",
 			usedOutputBuffers, OUTPUT_BUFFER_COUNT, maxUsedOutputBuffers);
+	if (LARGE_OUTPUT_BUFFER_COUNT != 0)
+	{
+		reprap.GetPlatform().MessageF(mtype, "Used large output buffers: %d of %d (%d max)\n",
+				usedLargeOutputBuffers, LARGE_OUTPUT_BUFFER_COUNT, maxUsedLargeOutputBuffers);
+	}
 }
 
 //*************************************************************************************************
@@ -21,7 +21,7 @@ const size_t OUTPUT_STACK_DEPTH = 4;	// Number of OutputBuffer chains that can b
 class OutputBuffer
 {
 public:
-	explicit OutputBuffer(OutputBuffer *null n) noexcept : next(n) { }
+	OutputBuffer(OutputBuffer *null n, char *_ecv_array storage, size_t cap) noexcept : next(n), data(storage), capacity(cap) { }
 	OutputBuffer(const OutputBuffer&) = delete;
 
 	void Append(OutputBuffer *other) noexcept;
@@ -33,6 +33,7 @@ public:
 	const char *_ecv_array Data() const noexcept { return data; }
 	const char *_ecv_array UnreadData() const noexcept { return data + bytesRead; }
 	size_t DataLength() const noexcept { return dataLength; }	// How many bytes have been written to this instance?
+	size_t Capacity() const noexcept { return capacity; }		// How many bytes can this instance hold?
 	size_t Length() const noexcept;								// How many bytes have been written to the whole chain?
 
 	char operator[](size_t index) const noexcept;
@@ -90,17 +91,21 @@ public:
 
 	static void Diagnostics(MessageType mtype) noexcept;
 
-	static unsigned int GetFreeBuffers() noexcept { return OUTPUT_BUFFER_COUNT - usedOutputBuffers; }
+	static unsigned int GetFreeBuffers() noexcept { return (OUTPUT_BUFFER_COUNT - usedOutputBuffers) + (LARGE_OUTPUT_BUFFER_COUNT - usedLargeOutputBuffers); }
 
 private:
 	void Clear() noexcept;
+	bool AllocateNext(OutputBuffer *&buf) const noexcept;
+
+	static bool TakeFreeBuffer(OutputBuffer *&buf, bool large) noexcept;
 
 	OutputBuffer *null next;
 	OutputBuffer *last;
 
 	uint32_t whenQueued;									// milliseconds timer when this buffer was filled in
 
-	char data[OUTPUT_BUFFER_SIZE];
+	char *_ecv_array data;									// points into the slab allocated by Init()
+	size_t capacity;
 	size_t dataLength, bytesRead;
 
 	bool isReferenced;
@@ -110,6 +115,10 @@ private:
 	static OutputBuffer * volatile freeOutputBuffers;		// Messages may be sent by multiple tasks
 	static volatile size_t usedOutputBuffers;				// so make these volatile.
 	static volatile size_t maxUsedOutputBuffers;
+
+	static OutputBuffer * volatile freeLargeOutputBuffers;	// Large buffers are used to extend long chains
+	static volatile size_t usedLargeOutputBuffers;
+	static volatile size_t maxUsedLargeOutputBuffers;
 };
 
 inline uint32_t OutputBuffer::GetAge() const noexcept
@@ -25,6 +25,7 @@
 #include <Movement/DDA.h>
 #include <Movement/Move.h>
 #include <Movement/StepTimer.h>
+#include <Movement/MoveTrace.h>
 #include <Tools/Tool.h>
 #include <Endstops/ZProbe.h>
 #include <Networking/Network.h>
@@ -1690,6 +1691,13 @@ void Platform::Diagnostics(MessageType mtype) noexcept
 	}
 #endif
 
+#if HAS_MASS_STORAGE
+	if (logger != nullptr)
+	{
+		logger->Diagnostics(mtype);
+	}
+#endif
+
 #ifdef DUET3MINI
 	// Report the processor revision level and analogIn status (trying to debug the spurious zero VIN issue)
 	{
@@ -2093,6 +2101,15 @@ GCodeResult Platform::DiagnosticTest(GCodeBuffer& gb, const StringRef& reply, Ou
 		DDA::PrintMoves();
 		break;
 
+	case (unsigned int)DiagnosticTestType::PrintMoveTrace:
+#if SUPPORT_MOVE_TRACE
+		MoveTrace::Print(gb.GetResponseMessageType());
+		break;
+#else
+		reply.copy("Move trace not supported in this build");
+		return GCodeResult::error;
+#endif
+
 	case (unsigned int)DiagnosticTestType::TimeCalculations:	// Show the square root calculation time. Caution: may disable interrupt for several tens of microseconds.
 		{
 			constexpr uint32_t iterations = 100;				// use a value that divides into one million
@@ -3297,7 +3314,7 @@ void Platform::RawMessage(MessageType type, const char *_ecv_array message) noex
 		}
 		// We no longer flush afterwards
 	}
-	else if ((type & UsbMessage) != 0)
+	else if ((type & UsbMessage) != 0 && SERIAL_MAIN_DEVICE.IsConnected())		// if the USB line is not open then Spin would discard the message anyway
 	{
 		// Message that is to be sent via the USB line (non-blocking)
 		MutexLocker lock(usbMutex);
@@ -4067,6 +4084,18 @@ FileStore* Platform::OpenSysFile(const char *_ecv_array filename, OpenMode mode)
 				: nullptr;
 }
 
+FileStore* Platform::OpenSysMacroFile(const char *_ecv_array filename) const noexcept
+{
+#if SUPPORT_MACRO_CACHE
+	String<MaxFilenameLength> location;
+	return (MakeSysFileName(location.GetRef(), filename))
+			? MassStorage::OpenMacroFile(location.c_str())
+				: nullptr;
+#else
+	return OpenSysFile(filename, OpenMode::read);
+#endif
+}
+
 bool Platform::MakeSysFileName(const StringRef& result, const char *_ecv_array filename) const noexcept
 {
 	return MassStorage::CombineName(result, GetSysDir().Ptr(), filename);
@@ -173,6 +173,7 @@ enum class DiagnosticTestType : unsigned int
 	TimeCRC32 = 107,				// time how long it takes to calculate CRC32
 	TimeGetTimerTicks = 108,		// time now long it takes to read the step clock
 	UndervoltageEvent = 109,		// pretend an undervoltage condition has occurred
+	PrintMoveTrace = 110,			// print the recent motion event trace (only if SUPPORT_MOVE_TRACE was enabled in firmware)
 
 #ifdef __LPC17xx__
 	PrintBoardConfiguration = 200,	// Prints out all pin/values loaded from SDCard to configure board
@@ -419,6 +420,7 @@ public:
 	GCodeResult SetSysDir(const char *_ecv_array dir, const StringRef& reply) noexcept;				// Set the system files path
 	bool SysFileExists(const char *_ecv_array filename) const noexcept;
 	FileStore* OpenSysFile(const char *_ecv_array filename, OpenMode mode) const noexcept;
+	FileStore* OpenSysMacroFile(const char *_ecv_array filename) const noexcept;		// Open a macro for reading, from the macro cache if possible
 # if HAS_MASS_STORAGE || HAS_SBC_INTERFACE
 	bool DeleteSysFile(const char *_ecv_array filename) const noexcept;
 # endif
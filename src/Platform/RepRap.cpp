@@ -508,6 +508,14 @@ void RepRap::Init() noexcept
 #endif
 
 	messageBoxMutex.Create("MessageBox");
+#if JSON_RESPONSE_CACHE_MILLIS
+	responseCacheMutex.Create("RespCache");
+	for (CachedResponse& cr : responseCache)
+	{
+		cr.response = nullptr;
+	}
+	responseCacheHits = responseCacheMisses = 0;
+#endif
 
 	platform->Init();
 	network->Init();
@@ -683,6 +691,11 @@ void RepRap::Init() noexcept
 
 	fastLoop = UINT32_MAX;
 	slowLoop = 0;
+	slowLoopModule = noModule;
+	for (uint32_t& t : maxModuleSpinTicks)
+	{
+		t = 0;
+	}
 
 #if STEP_TIMER_DEBUG
 	(void)StepTimer::GetTimerTicks();
@@ -740,38 +753,33 @@ void RepRap::Spin() noexcept
 	}
 
 	const uint32_t lastTime = StepTimer::GetTimerTicks();
+	slowestModuleTicksThisLoop = 0;
+	slowestModuleThisLoop = noModule;
 
-	ticksInSpinState = 0;
-	spinningModule = modulePlatform;
+	SetSpinningModule(modulePlatform);
 	platform->Spin();
 
-	ticksInSpinState = 0;
-	spinningModule = moduleGcodes;
+	SetSpinningModule(moduleGcodes);
 	gCodes->Spin();
 
 #if SUPPORT_ROLAND
-	ticksInSpinState = 0;
-	spinningModule = moduleRoland;
+	SetSpinningModule(moduleRoland);
 	roland->Spin();
 #endif
 
 #if SUPPORT_SCANNER && !SCANNER_AS_SEPARATE_TASK
-	ticksInSpinState = 0;
-	spinningModule = moduleScanner;
+	SetSpinningModule(moduleScanner);
 	scanner->Spin();
 #endif
 
-	ticksInSpinState = 0;
-	spinningModule = modulePrintMonitor;
+	SetSpinningModule(modulePrintMonitor);
 	printMonitor->Spin();
 
-	ticksInSpinState = 0;
-	spinningModule = moduleFilamentSensors;
+	SetSpinningModule(moduleFilamentSensors);
 	FilamentMonitor::Spin();
 
 #if SUPPORT_12864_LCD
-	ticksInSpinState = 0;
-	spinningModule = moduleDisplay;
+	SetSpinningModule(moduleDisplay);
 	display->Spin();
 #endif
 
@@ -779,14 +787,15 @@ void RepRap::Spin() noexcept
 	// Keep the SBC task spinning from the main task in standalone mode to respond to a SBC if necessary
 	if (!UsingSbcInterface())
 	{
-		ticksInSpinState = 0;
-		spinningModule = moduleSbcInterface;
+		SetSpinningModule(moduleSbcInterface);
 		sbcInterface->Spin();
 	}
 #endif
 
-	ticksInSpinState = 0;
-	spinningModule = noModule;
+	SetSpinningModule(noModule);
+
+	// Tidy up part of the string heap if it has become fragmented
+	StringHandle::IncrementalGarbageCollect();
 
 	// Check if we need to send diagnostics
 	if (diagnosticsDestination != MessageType::NoDestinationMessage)
@@ -872,17 +881,51 @@ void RepRap::Spin() noexcept
 		if (dt > slowLoop)
 		{
 			slowLoop = dt;
+			slowLoopModule = slowestModuleThisLoop;
 		}
 	}
 
 	RTOSIface::Yield();
 }
 
+// Record how long the module that was spinning took, then start timing the next one
+void RepRap::SetSpinningModule(Module m) noexcept
+{
+	const uint32_t now = StepTimer::GetTimerTicks();
+	if (spinningModule < numModules)
+	{
+		const uint32_t dt = now - moduleSpinStartTime;
+		if (dt > maxModuleSpinTicks[spinningModule])
+		{
+			maxModuleSpinTicks[spinningModule] = dt;
+		}
+		if (dt > slowestModuleTicksThisLoop)
+		{
+			slowestModuleTicksThisLoop = dt;
+			slowestModuleThisLoop = spinningModule;
+		}
+	}
+	moduleSpinStartTime = now;
+	ticksInSpinState = 0;
+	spinningModule = m;
+}
+
 void RepRap::Timing(MessageType mtype) noexcept
 {
-	platform->MessageF(mtype, "Slowest loop: %.2fms; fastest: %.2fms\n", (double)(slowLoop * StepClocksToMillis), (double)(fastLoop * StepClocksToMillis));
+	platform->MessageF(mtype, "Slowest loop: %.2fms (mostly %s); fastest: %.2fms\nSlowest module spins (ms):",
+						(double)(slowLoop * StepClocksToMillis), GetModuleName(slowLoopModule), (double)(fastLoop * StepClocksToMillis));
+	for (size_t i = 0; i < numModules; ++i)
+	{
+		if (maxModuleSpinTicks[i] != 0)
+		{
+			platform->MessageF(mtype, " %s %.2f", GetModuleName(i), (double)(maxModuleSpinTicks[i] * StepClocksToMillis));
+			maxModuleSpinTicks[i] = 0;
+		}
+	}
+	platform->Message(mtype, "\n");
 	fastLoop = UINT32_MAX;
 	slowLoop = 0;
+	slowLoopModule = noModule;
 }
 
 void RepRap::Diagnostics(MessageType mtype) noexcept
@@ -952,6 +995,10 @@ void RepRap::Diagnostics(MessageType mtype) noexcept
 
 	// Show the used and free buffer counts. Do this early in case we are running out of them and the diagnostics get truncated.
 	OutputBuffer::Diagnostics(mtype);
+#if JSON_RESPONSE_CACHE_MILLIS
+	platform->MessageF(mtype, "Response cache hits %u, misses %u\n", responseCacheHits, responseCacheMisses);
+	responseCacheHits = responseCacheMisses = 0;
+#endif
 
 	// Now print diagnostics for other modules
 	Tasks::Diagnostics(mtype);
@@ -1403,6 +1450,18 @@ bool RepRap::SpinTimeoutImminent() const noexcept
 // Type 3 is the same but instead of static parameters we report print estimation values.
 OutputBuffer *RepRap::GetStatusResponse(uint8_t type, ResponseSource source) const noexcept
 {
+#if JSON_RESPONSE_CACHE_MILLIS
+	// The response depends only on the type and source, so if another client on the same channel asked for the same type recently then we can return a copy of that.
+	// Clients on different channels (e.g. PanelDue and HTTP) use different keys, so they never share a cache entry.
+	String<StringLength20> cacheKey;
+	cacheKey.printf("%u:%u", type, (unsigned int)source);
+	OutputBuffer * const cached = GetCachedResponse(ResponseCacheSlot::status, cacheKey.c_str(), "");
+	if (cached != nullptr)
+	{
+		return cached;
+	}
+#endif
+
 	// Need something to write to...
 	OutputBuffer *response;
 	if (!OutputBuffer::Allocate(response))
@@ -1899,6 +1958,12 @@ OutputBuffer *RepRap::GetStatusResponse(uint8_t type, ResponseSource source) con
 	}
 
 	response->cat('}');
+#if JSON_RESPONSE_CACHE_MILLIS
+	if (!response->HadOverflow())
+	{
+		CacheResponse(ResponseCacheSlot::status, cacheKey.c_str(), "", response);
+	}
+#endif
 	return response;
 }
 
@@ -2157,7 +2222,8 @@ OutputBuffer *RepRap::GetLegacyStatusResponse(uint8_t type, int seq) const noexc
 
 // Get the list of files in the specified directory in JSON format. PanelDue uses this one, so include a newline at the end.
 // If flagDirs is true then we prefix each directory with a * character.
-OutputBuffer *RepRap::GetFilesResponse(const char *dir, unsigned int startAt, bool flagsDirs) noexcept
+// maxBytes limits the size of the response; if the listing doesn't fit then "next" tells the client where to resume.
+OutputBuffer *RepRap::GetFilesResponse(const char *dir, unsigned int startAt, bool flagsDirs, size_t maxBytes) noexcept
 {
 	// Need something to write to...
 	OutputBuffer *response;
@@ -2185,10 +2251,10 @@ OutputBuffer *RepRap::GetFilesResponse(const char *dir, unsigned int startAt, bo
 	{
 		err = 0;
 		FileInfo fileInfo;
-		unsigned int filesFound = 0;
-		bool gotFile = MassStorage::FindFirst(dir, fileInfo);
+		unsigned int filesFound = startAt;							// if this is a later page, the directory cursor cache may let us resume at it
+		bool gotFile = MassStorage::FindFirst(dir, fileInfo, filesFound);
 
-		size_t bytesLeft = OutputBuffer::GetBytesLeft(response);	// don't write more bytes than we can
+		size_t bytesLeft = min<size_t>(OutputBuffer::GetBytesLeft(response), maxBytes);	// don't write more bytes than we can or were asked to
 
 		while (gotFile)
 		{
@@ -2200,6 +2266,9 @@ OutputBuffer *RepRap::GetFilesResponse(const char *dir, unsigned int startAt, bo
 					if (bytesLeft < fileInfo.fileName.strlen() * 2 + 20)
 					{
 						// No more space available - stop here
+#if HAS_MASS_STORAGE
+						MassStorage::RememberFindPosition(filesFound);
+#endif
 						MassStorage::AbandonFindNext();
 						nextFile = filesFound;
 						break;
@@ -2235,8 +2304,8 @@ OutputBuffer *RepRap::GetFilesResponse(const char *dir, unsigned int startAt, bo
 	return response;
 }
 
-// Get a JSON-style filelist including file types and sizes
-OutputBuffer *RepRap::GetFilelistResponse(const char *dir, unsigned int startAt) noexcept
+// Get a JSON-style filelist including file types and sizes. maxBytes limits the size of the response as for GetFilesResponse.
+OutputBuffer *RepRap::GetFilelistResponse(const char *dir, unsigned int startAt, size_t maxBytes) noexcept
 {
 	// Need something to write to...
 	OutputBuffer *response;
@@ -2264,9 +2333,9 @@ OutputBuffer *RepRap::GetFilelistResponse(const char *dir, unsigned int startAt)
 	{
 		err = 0;
 		FileInfo fileInfo;
-		unsigned int filesFound = 0;
-		bool gotFile = MassStorage::FindFirst(dir, fileInfo);
-		size_t bytesLeft = OutputBuffer::GetBytesLeft(response);	// don't write more bytes than we can
+		unsigned int filesFound = startAt;							// if this is a later page, the directory cursor cache may let us resume at it
+		bool gotFile = MassStorage::FindFirst(dir, fileInfo, filesFound);
+		size_t bytesLeft = min<size_t>(OutputBuffer::GetBytesLeft(response), maxBytes);	// don't write more bytes than we can or were asked to
 
 		while (gotFile)
 		{
@@ -2278,6 +2347,9 @@ OutputBuffer *RepRap::GetFilelistResponse(const char *dir, unsigned int startAt)
 					if (bytesLeft < fileInfo.fileName.strlen() * 2 + 50)
 					{
 						// No more space available - stop here
+#if HAS_MASS_STORAGE
+						MassStorage::RememberFindPosition(filesFound);
+#endif
 						MassStorage::AbandonFindNext();
 						nextFile = filesFound;
 						break;
@@ -2599,15 +2671,47 @@ void RepRap::AppendStringArray(OutputBuffer *buf, const char *name, size_t numVa
 
 #if SUPPORT_OBJECT_MODEL
 
+// Return the sum of all the values in the seqs object model element. Each one only ever increases (modulo 2^16), so any change to any of them changes the sum.
+uint32_t RepRap::GetSeqsTotal() const noexcept
+{
+	uint32_t total = (uint32_t)boardsSeq + directoriesSeq + fansSeq + globalSeq + heatSeq + inputsSeq + jobSeq + moveSeq
+					+ networkSeq + scannerSeq + sensorsSeq + spindlesSeq + stateSeq + toolsSeq + volumesSeq;
+#if HAS_NETWORKING
+	total += HttpResponder::GetReplySeq();
+#endif
+#if HAS_MASS_STORAGE
+	for (size_t i = 0; i < MassStorage::GetNumVolumes(); ++i)
+	{
+		total += MassStorage::GetVolumeSeq(i);
+	}
+#endif
+	return total;
+}
+
 // Return a query into the object model, or return nullptr if no buffer available
 // We append a newline to help PanelDue resync after receiving corrupt or incomplete data. DWC ignores it.
 OutputBuffer *RepRap::GetModelResponse(const GCodeBuffer *_ecv_null gb, const char *key, const char *flags) const THROWS(GCodeException)
 {
+#if JSON_RESPONSE_CACHE_MILLIS
+	// Requests from network and SBC clients may be satisfied from the cache
+	if (gb == nullptr)
+	{
+		OutputBuffer * const cached = GetCachedResponse(ResponseCacheSlot::model, (key == nullptr) ? "" : key, (flags == nullptr) ? "" : flags);
+		if (cached != nullptr)
+		{
+			return cached;
+		}
+	}
+#endif
+
 	OutputBuffer *outBuf;
 	if (OutputBuffer::Allocate(outBuf))
 	{
 		if (key == nullptr) { key = ""; }
 		if (flags == nullptr) { flags = ""; }
+#if JSON_RESPONSE_CACHE_MILLIS
+		const char * const originalKey = key;
+#endif
 
 		outBuf->printf("{\"key\":\"%.s\",\"flags\":\"%.s\",\"result\":", key, flags);
 
@@ -2631,11 +2735,96 @@ OutputBuffer *RepRap::GetModelResponse(const GCodeBuffer *_ecv_null gb, const ch
 			OutputBuffer::ReleaseAll(outBuf);
 			throw;
 		}
+#if JSON_RESPONSE_CACHE_MILLIS
+		if (gb == nullptr && outBuf != nullptr)
+		{
+			CacheResponse(ResponseCacheSlot::model, originalKey, flags, outBuf);
+		}
+#endif
 	}
 
 	return outBuf;
 }
 
+#if JSON_RESPONSE_CACHE_MILLIS
+
+// Return a copy of the cached response in the specified slot if it matches the key and flags and is recent enough, else nullptr
+OutputBuffer *_ecv_null RepRap::GetCachedResponse(ResponseCacheSlot slot, const char *key, const char *flags) const noexcept
+{
+	MutexLocker lock(responseCacheMutex);
+	CachedResponse& cr = responseCache[(size_t)slot];
+	if (cr.response != nullptr)
+	{
+		if (millis() - cr.whenCached >= JSON_RESPONSE_CACHE_MILLIS)
+		{
+			OutputBuffer::ReleaseAll(cr.response);					// it's out of date, so free up the buffers
+		}
+		else if (strcmp(cr.key.c_str(), key) == 0 && strcmp(cr.flags.c_str(), flags) == 0)
+		{
+			OutputBuffer * const copy = CopyOutputBufferChain(cr.response);
+			if (copy != nullptr)
+			{
+				++responseCacheHits;
+				return copy;
+			}
+		}
+	}
+	++responseCacheMisses;
+	return nullptr;
+}
+
+// Keep a copy of a newly-generated response in the specified slot if it is short enough and copying it won't leave too few free output buffers
+void RepRap::CacheResponse(ResponseCacheSlot slot, const char *key, const char *flags, const OutputBuffer *response) const noexcept
+{
+	CachedResponse& cr = responseCache[(size_t)slot];
+	if (strlen(key) >= cr.key.Capacity() || strlen(flags) >= cr.flags.Capacity() || response->Length() > MaxCachedResponseLength)
+	{
+		return;
+	}
+
+	unsigned int buffersNeeded = 0;
+	for (const OutputBuffer *item = response; item != nullptr; item = item->Next())
+	{
+		++buffersNeeded;
+	}
+
+	MutexLocker lock(responseCacheMutex);
+	OutputBuffer::ReleaseAll(cr.response);
+	if (OutputBuffer::GetFreeBuffers() >= buffersNeeded + MinFreeBuffersAfterCaching)
+	{
+		cr.response = CopyOutputBufferChain(response);
+		if (cr.response != nullptr)
+		{
+			cr.key.copy(key);
+			cr.flags.copy(flags);
+			cr.whenCached = millis();
+		}
+	}
+}
+
+// Make a copy of a chain of output buffers, returning nullptr if there were not enough free buffers
+/*static*/ OutputBuffer *_ecv_null RepRap::CopyOutputBufferChain(const OutputBuffer *src) noexcept
+{
+	OutputBuffer *copy;
+	if (!OutputBuffer::Allocate(copy))
+	{
+		return nullptr;
+	}
+
+	for (const OutputBuffer *item = src; item != nullptr; item = item->Next())
+	{
+		copy->cat(item->Data(), item->DataLength());
+	}
+
+	if (copy->HadOverflow())
+	{
+		OutputBuffer::ReleaseAll(copy);
+	}
+	return copy;
+}
+
+#endif
+
 #endif
 
 // Send a beep. We send it to both PanelDue and the web interface.
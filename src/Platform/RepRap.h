@@ -27,6 +27,16 @@ Licence: GPL
 #include <General/function_ref.h>
 #include <ObjectModel/GlobalVariables.h>
 
+// If JSON_RESPONSE_CACHE_MILLIS is nonzero then object model responses requested by HTTP or SBC clients, and status responses, are kept for up to that number
+// of milliseconds and returned again if another client asks for the same data, so that several clients polling the same data don't each cause it to be generated
+#ifndef JSON_RESPONSE_CACHE_MILLIS
+# if SUPPORT_OBJECT_MODEL && (SAME70 || SAME5x)
+#  define JSON_RESPONSE_CACHE_MILLIS	(100)
+# else
+#  define JSON_RESPONSE_CACHE_MILLIS	(0)
+# endif
+#endif
+
 #if SUPPORT_CAN_EXPANSION
 # include <CAN/ExpansionManager.h>
 #endif
@@ -151,8 +161,8 @@ public:
 	OutputBuffer *GetLegacyStatusResponse(uint8_t type, int seq) const noexcept;
 
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
-	OutputBuffer *GetFilesResponse(const char* dir, unsigned int startAt, bool flagsDirs) noexcept;
-	OutputBuffer *GetFilelistResponse(const char* dir, unsigned int startAt) noexcept;
+	OutputBuffer *GetFilesResponse(const char* dir, unsigned int startAt, bool flagsDirs, size_t maxBytes = SIZE_MAX) noexcept;
+	OutputBuffer *GetFilelistResponse(const char* dir, unsigned int startAt, size_t maxBytes = SIZE_MAX) noexcept;
 	OutputBuffer *GetThumbnailResponse(const char *filename, FilePosition offset, bool forM31point1) noexcept;
 #endif
 
@@ -206,6 +216,7 @@ public:
 	void StateUpdated() noexcept { ++stateSeq; }
 	void ToolsUpdated() noexcept { ++toolsSeq; }
 	void VolumesUpdated() noexcept { ++volumesSeq; }
+	uint32_t GetSeqsTotal() const noexcept;								// return the sum of the values in seqs, so that callers can tell cheaply whether any of them has changed
 
 	ReadLockedPointer<const VariableSet> GetGlobalVariablesForReading() noexcept { return globalVariables.GetForReading(); }
 	WriteLockedPointer<VariableSet> GetGlobalVariablesForWriting() noexcept { return globalVariables.GetForWriting(); }
@@ -233,6 +244,27 @@ private:
 	const char* GetStatusString() const noexcept;
 	void ReportToolTemperatures(const StringRef& reply, const Tool *tool, bool includeNumber) const noexcept;
 	bool RunStartupFile(const char *filename) noexcept;
+	void SetSpinningModule(Module m) noexcept;
+
+#if JSON_RESPONSE_CACHE_MILLIS
+	// Each kind of response has its own cache slot so that clients polling for different kinds of response don't evict each other's entries
+	enum class ResponseCacheSlot : uint8_t { model = 0, status, numSlots };
+
+	struct CachedResponse
+	{
+		OutputBuffer *_ecv_null response;
+		uint32_t whenCached;
+		String<StringLength50> key;
+		String<StringLength20> flags;
+	};
+
+	OutputBuffer *_ecv_null GetCachedResponse(ResponseCacheSlot slot, const char *key, const char *flags) const noexcept;
+	void CacheResponse(ResponseCacheSlot slot, const char *key, const char *flags, const OutputBuffer *response) const noexcept;
+	static OutputBuffer *_ecv_null CopyOutputBufferChain(const OutputBuffer *src) noexcept;
+
+	static constexpr size_t MaxCachedResponseLength = 2048;			// we don't cache responses longer than this, to limit the number of output buffers held
+	static constexpr unsigned int MinFreeBuffersAfterCaching = 8;		// we don't cache a response if that would leave fewer than this number of output buffers free
+#endif
 
 	static constexpr uint32_t MaxTicksInSpinState = 20000;	// timeout before we reset the processor
 	static constexpr uint32_t HighTicksInSpinState = 16000;	// how long before we warn that timeout is approaching
@@ -270,6 +302,13 @@ private:
 
  	mutable Mutex messageBoxMutex;				// mutable so that we can lock and release it in const functions
 
+#if JSON_RESPONSE_CACHE_MILLIS
+	// The cache is mutable because GetModelResponse and GetStatusResponse are const functions
+	mutable Mutex responseCacheMutex;
+	mutable CachedResponse responseCache[(size_t)ResponseCacheSlot::numSlots];
+	mutable unsigned int responseCacheHits, responseCacheMisses;
+#endif
+
 	uint16_t boardsSeq, directoriesSeq, fansSeq, heatSeq, inputsSeq, jobSeq, moveSeq, globalSeq;
 	uint16_t networkSeq, scannerSeq, sensorsSeq, spindlesSeq, stateSeq, toolsSeq, volumesSeq;
 
@@ -286,6 +325,11 @@ private:
 	uint16_t ticksInSpinState;
 	uint16_t heatTaskIdleTicks;
 	uint32_t fastLoop, slowLoop;
+	uint32_t moduleSpinStartTime;				// step clock when the current module started spinning
+	uint32_t slowestModuleTicksThisLoop;
+	uint32_t maxModuleSpinTicks[Module::numModules];	// longest time each module has taken in a single call to its Spin function
+	Module slowestModuleThisLoop;
+	Module slowLoopModule;						// the module that took the longest time during the slowest loop
 
 #if SUPPORT_REMOTE_COMMANDS
 	enum class DeferredCommand : uint8_t { none, reboot, updateFirmware };
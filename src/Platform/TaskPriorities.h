@@ -24,7 +24,7 @@ namespace TaskPriority
 	constexpr unsigned int MovePriority = 4;
 	constexpr unsigned int TmcPriority = 4;
 	constexpr unsigned int AinPriority = 4;
-	constexpr unsigned int HeightFollowingPriority = 4;
+	constexpr unsigned int HeightFollowingPriority = 5;				// above the Move, TMC and Ain tasks so that the sample period has little jitter
 #ifdef DUET_NG
 	constexpr unsigned int DueXPriority = 5;
 #endif
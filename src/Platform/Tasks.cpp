@@ -37,6 +37,10 @@ const uint8_t memPattern = 0xA5;		// this must be the same pattern as FreeRTOS b
 extern uint32_t _firmware_crc;			// defined in linker script
 #endif
 
+#if SPEED_CRITICAL_IN_RAM && (SAM4E || SAM4S)
+extern char _srelocate, _eramfunc;		// defined in linker script
+#endif
+
 // MAIN task data
 // The main task currently runs GCodes, so it needs to be large enough to hold the matrices used for delta auto calibration.
 // The worst case stack usage is after running delta auto calibration with Move debugging enabled.
@@ -82,6 +86,8 @@ extern "C" void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuf
 static Mutex i2cMutex;
 static Mutex mallocMutex;
 
+static size_t permanentlyAllocatedRam = 0;					// total bytes requested from AllocPermanent
+
 // We need to make malloc/free thread safe. We must use a recursive mutex for it.
 extern "C" void GetMallocMutex() noexcept
 {
@@ -289,10 +295,20 @@ void *Tasks::AllocPermanent(size_t sz, std::align_val_t align) noexcept
 {
 	GetMallocMutex();
 	void * const ret = CoreAllocPermanent(sz, align);
+	if (ret != nullptr)
+	{
+		permanentlyAllocatedRam += sz;
+	}
 	ReleaseMallocMutex();
 	return ret;
 }
 
+// Return the total amount of memory allocated by AllocPermanent, not counting alignment padding
+size_t Tasks::GetPermanentlyAllocatedRam() noexcept
+{
+	return permanentlyAllocatedRam;
+}
+
 // Function called by FreeRTOS and internally to reset the run-time counter and return the number of timer ticks since it was last reset
 extern "C" uint32_t TaskResetRunTimeCounter() noexcept
 {
@@ -319,12 +335,15 @@ void Tasks::Diagnostics(MessageType mtype) noexcept
 			(char *) IRAM_ADDR;
 #endif
 		p.MessageF(mtype, "Static ram: %d\n", &_end - ramstart);
+#if SPEED_CRITICAL_IN_RAM && (SAM4E || SAM4S)
+		p.MessageF(mtype, "Code in ram: %d\n", &_eramfunc - &_srelocate);
+#endif
 
 #ifdef __LPC17xx__
 		p.MessageF(mtype, "Dynamic Memory (RTOS Heap 5): %d free, %d never used\n", xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize() );
 #else
 		const struct mallinfo mi = mallinfo();
-		p.MessageF(mtype, "Dynamic ram: %d of which %d recycled\n", mi.uordblks, mi.fordblks);
+		p.MessageF(mtype, "Dynamic ram: %d of which %d recycled, permanently allocated %u\n", mi.uordblks, mi.fordblks, GetPermanentlyAllocatedRam());
 #endif
 		p.MessageF(mtype, "Never used RAM %d, free system stack %d words\n", GetNeverUsedRam(), GetHandlerFreeStack()/4);
 
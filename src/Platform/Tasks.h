@@ -18,6 +18,7 @@ namespace Tasks
 	void TerminateMainTask() noexcept;
 	ptrdiff_t GetNeverUsedRam() noexcept;
 	void *AllocPermanent(size_t sz, std::align_val_t align = (std::align_val_t)__STDCPP_DEFAULT_NEW_ALIGNMENT__) noexcept;
+	size_t GetPermanentlyAllocatedRam() noexcept;
 	const char* GetHeapTop() noexcept;
 	Mutex *GetI2CMutex() noexcept;
 	void *GetNVMBuffer(const uint32_t *_ecv_array null stk) noexcept;
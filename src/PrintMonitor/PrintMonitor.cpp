@@ -283,9 +283,21 @@ void PrintMonitor::Spin() noexcept
 					const float currentFraction = FractionOfFilePrinted();
 					const float currentFilamentUsed = gCodes.GetTotalRawExtrusion();
 
+					// Use an exponentially-weighted average of the rates so that layers that take unusually long or short times don't make the estimates swing
+					const float latestFileProgressRate = 1000.0 * (currentFraction - lastSnapshotFileFraction)/printTimeSinceLastSnapshot;
+					const float latestFilamentProgressRate = 1000.0 * (currentFilamentUsed - lastSnapshotFilamentUsed)/printTimeSinceLastSnapshot;
+
 					TaskCriticalSectionLocker lock;
-					fileProgressRate = 1000.0 * (currentFraction - lastSnapshotFileFraction)/printTimeSinceLastSnapshot;
-					filamentProgressRate = 1000.0 * (currentFilamentUsed - lastSnapshotFilamentUsed)/printTimeSinceLastSnapshot;
+					if (lastSnapshotTime == printStartTime)
+					{
+						fileProgressRate = latestFileProgressRate;
+						filamentProgressRate = latestFilamentProgressRate;
+					}
+					else
+					{
+						fileProgressRate += (latestFileProgressRate - fileProgressRate) * ProgressRateSmoothing;
+						filamentProgressRate += (latestFilamentProgressRate - filamentProgressRate) * ProgressRateSmoothing;
+					}
 					lastSnapshotFileFraction = currentFraction;
 					lastSnapshotFilamentUsed = currentFilamentUsed;
 					lastSnapshotNonPrintingTime = totalNonPrintingTime;
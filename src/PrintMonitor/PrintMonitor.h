@@ -74,6 +74,7 @@ private:
 	static constexpr uint32_t UpdateIntervalMillis = 200;				// Update interval in milliseconds
 	static constexpr uint32_t SnapshotIntervalSecondsPrinting = 30;		// Snapshot interval in seconds
 	static constexpr uint32_t SnapshotIntervalSecondsSimulating = 1;	// Snapshot interval in seconds
+	static constexpr float ProgressRateSmoothing = 0.25;				// Weight given to the latest snapshot when averaging the progress rates
 
 	void Reset() noexcept;
 	void PrintingFileInfoUpdated() noexcept;
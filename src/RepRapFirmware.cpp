@@ -172,11 +172,9 @@ Licence: GPL
 RepRap reprap;
 
 // Get the format string to use for printing a floating point number to the specified number of decimal digits. Zero means the maximum sensible number.
-const char *_ecv_array GetFloatFormatString(float val, unsigned int numDigitsAfterPoint) noexcept
+// Return the number of digits after the decimal point that GetFloatFormatString would use
+unsigned int GetFloatDigitsAfterPoint(float val, unsigned int numDigitsAfterPoint) noexcept
 {
-	static constexpr const char *_ecv_array FormatStrings[] = { "%.7f", "%.1f", "%.2f", "%.3f", "%.4f", "%.5f", "%.6f", "%.7f" };
-	static_assert(ARRAY_SIZE(FormatStrings) == MaxFloatDigitsDisplayedAfterPoint + 1);
-
 	float f = 1.0;
 	unsigned int maxDigitsAfterPoint = MaxFloatDigitsDisplayedAfterPoint;
 	while (maxDigitsAfterPoint > 1 && val >= f)
@@ -185,7 +183,16 @@ const char *_ecv_array GetFloatFormatString(float val, unsigned int numDigitsAft
 		--maxDigitsAfterPoint;
 	}
 
-	return FormatStrings[min<unsigned int>(numDigitsAfterPoint, maxDigitsAfterPoint)];
+	const unsigned int digits = min<unsigned int>(numDigitsAfterPoint, maxDigitsAfterPoint);
+	return (digits == 0) ? MaxFloatDigitsDisplayedAfterPoint : digits;
+}
+
+const char *_ecv_array GetFloatFormatString(float val, unsigned int numDigitsAfterPoint) noexcept
+{
+	static constexpr const char *_ecv_array FormatStrings[] = { "%.7f", "%.1f", "%.2f", "%.3f", "%.4f", "%.5f", "%.6f", "%.7f" };
+	static_assert(ARRAY_SIZE(FormatStrings) == MaxFloatDigitsDisplayedAfterPoint + 1);
+
+	return FormatStrings[GetFloatDigitsAfterPoint(val, numDigitsAfterPoint)];
 }
 
 static const char *_ecv_array const moduleName[] =
@@ -63,7 +63,17 @@ inline MessageType GetGenericMessageType(GCodeResult rslt)
 	return (rslt == GCodeResult::warning) ? WarningMessage : ErrorMessage;
 }
 
-#define SPEED_CRITICAL	__attribute__((optimize("O2")))
+// On the SAM4E and SAM4S, code executes from flash with wait states and only a small prefetch buffer.
+// Define SPEED_CRITICAL_IN_RAM as 1 to copy the speed-critical functions to RAM at startup instead. The linker scripts limit the RAM used.
+#ifndef SPEED_CRITICAL_IN_RAM
+# define SPEED_CRITICAL_IN_RAM	0
+#endif
+
+#if SPEED_CRITICAL_IN_RAM && (SAM4E || SAM4S)
+# define SPEED_CRITICAL	__attribute__((optimize("O2"), section(".ramfunc"), long_call))
+#else
+# define SPEED_CRITICAL	__attribute__((optimize("O2")))
+#endif
 
 // API level definition.
 // ApiLevel 1 is the first level that supports rr_model.
@@ -555,6 +565,7 @@ static inline constexpr float InverseConvertAcceleration(float accel) noexcept
 
 constexpr unsigned int MaxFloatDigitsDisplayedAfterPoint = 7;
 const char *_ecv_array GetFloatFormatString(float val, unsigned int numDigitsAfterPoint) noexcept;
+unsigned int GetFloatDigitsAfterPoint(float val, unsigned int numDigitsAfterPoint) noexcept;
 
 #if SUPPORT_WORKPLACE_COORDINATES
 constexpr size_t NumCoordinateSystems = 9;							// G54 up to G59.3
@@ -404,7 +404,7 @@ alignas(4) __nocache char DataTransfer::rxBuffer[SbcTransferBufferSize];
 alignas(4) __nocache char DataTransfer::txBuffer[SbcTransferBufferSize];
 #endif
 
-DataTransfer::DataTransfer() noexcept : state(InternalTransferState::ExchangingData), lastTransferNumber(0), failedTransfers(0), checksumErrors(0),
+DataTransfer::DataTransfer() noexcept : state(InternalTransferState::ExchangingData), lastTransferNumber(0), failedTransfers(0), checksumErrors(0), rxChecksumErrors(0), checkDataChecksum(true),
 #if SAME5x
 	rxBuffer(nullptr), txBuffer(nullptr),
 #endif
@@ -512,7 +512,8 @@ void DataTransfer::InitFromTask() noexcept
 
 void DataTransfer::Diagnostics(MessageType mtype) noexcept
 {
-	reprap.GetPlatform().MessageF(mtype, "Transfer state: %d, failed transfers: %u, checksum errors: %u\n", (int)state, failedTransfers, checksumErrors);
+	reprap.GetPlatform().MessageF(mtype, "Transfer state: %d, failed transfers: %u, checksum errors: %u (%u detected here), data checksums %s\n",
+									(int)state, failedTransfers, checksumErrors, rxChecksumErrors, (checkDataChecksum) ? "checked" : "not checked");
 	reprap.GetPlatform().MessageF(mtype, "RX/TX seq numbers: %d/%d\n", (int)rxHeader.sequenceNumber, (int)txHeader.sequenceNumber);
 	reprap.GetPlatform().MessageF(mtype, "SPI underruns %u, overruns %u\n", spiTxUnderruns, spiRxOverruns);
 }
@@ -811,6 +812,7 @@ TransferState DataTransfer::DoTransfer() noexcept
 				{
 					debugPrintf("Bad header CRC (expected %08" PRIx32 ", got %08" PRIx32 ")\n", rxHeader.crcHeader, checksum);
 				}
+				rxChecksumErrors++;
 				ExchangeResponse(TransferResponse::BadHeaderChecksum);
 				break;
 			}
@@ -877,15 +879,21 @@ TransferState DataTransfer::DoTransfer() noexcept
 				break;
 			}
 
-			const uint32_t checksum = CalcCRC32(rxBuffer, rxHeader.dataLength);
-			if (rxHeader.crcData != checksum)
+			// Checking the data CRC can be disabled using M576 C0 to save CPU time when the SPI connection is known to be reliable.
+			// We must still calculate the CRC of data we send, because the SBC always checks it.
+			if (checkDataChecksum)
 			{
-				if (reprap.Debug(moduleSbcInterface))
+				const uint32_t checksum = CalcCRC32(rxBuffer, rxHeader.dataLength);
+				if (rxHeader.crcData != checksum)
 				{
-					debugPrintf("Bad data CRC (expected %08" PRIx32 ", got %08" PRIx32 ")\n", rxHeader.crcData, checksum);
+					if (reprap.Debug(moduleSbcInterface))
+					{
+						debugPrintf("Bad data CRC (expected %08" PRIx32 ", got %08" PRIx32 ")\n", rxHeader.crcData, checksum);
+					}
+					rxChecksumErrors++;
+					ExchangeResponse(TransferResponse::BadDataChecksum);
+					break;
 				}
-				ExchangeResponse(TransferResponse::BadDataChecksum);
-				break;
 			}
 
 			ExchangeResponse(TransferResponse::Success);
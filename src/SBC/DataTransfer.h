@@ -46,6 +46,8 @@ public:
 	TransferState DoTransfer() noexcept;													// Try to finish the current transfer
 	void StartNextTransfer() noexcept;														// Kick off the next transfer
 	void ResetConnection(bool fullReset) noexcept;											// Reset the connection after a longer timeout
+	void SetDataChecksumChecking(bool enable) noexcept { checkDataChecksum = enable; }		// Choose whether to verify the checksum of received data as well as the header
+	bool IsCheckingDataChecksum() const noexcept { return checkDataChecksum; }
 
 	size_t PacketsToRead() const noexcept;
 	const PacketHeader *ReadPacket() noexcept;												// Attempt to read the next packet header or return null. Advances the read pointer to the next packet or the packet's data
@@ -105,7 +107,8 @@ private:
 
 	// Transfer properties
 	uint16_t lastTransferNumber;
-	unsigned int failedTransfers, checksumErrors;
+	unsigned int failedTransfers, checksumErrors, rxChecksumErrors;		// checksumErrors counts transfers that either side rejected, rxChecksumErrors those that we rejected
+	bool checkDataChecksum;
 
 	// Transfer buffers
 #if SAME70
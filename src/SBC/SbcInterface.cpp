@@ -52,7 +52,8 @@ extern "C" [[noreturn]] void SBCTaskStart(void * pvParameters) noexcept
 SbcInterface::SbcInterface() noexcept : isConnected(false), numDisconnects(0), numTimeouts(0), numSbcTimeouts(0), lastTransferTime(0),
 	maxDelayBetweenTransfers(SpiTransferDelay), maxFileOpenDelay(SpiFileOpenDelay), numMaxEvents(SpiEventsRequired),
 	delaying(false), numEvents(0), reportPause(false), reportPauseWritten(false), printAborted(false),
-	codeBuffer(nullptr), rxPointer(0), txPointer(0), txEnd(0), sendBufferUpdate(true), waitingForFileChunk(false),
+	codeBuffer(nullptr), rxPointer(0), txPointer(0), txEnd(0), sendBufferUpdate(true),
+	maxCodeBufferUsed(0), codeBufferFullCount(0), codeBufferDefragCount(0), waitingForFileChunk(false),
 	fileMutex(), numOpenFiles(0), fileSemaphore(), fileOperation(FileOperation::none), fileOperationPending(false)
 #ifdef TRACK_FILE_CODES
 	, fileCodesRead(0), fileCodesHandled(0), fileMacrosRunning(0), fileMacrosClosing(0)
@@ -194,7 +195,7 @@ void SbcInterface::Spin() noexcept
 void SbcInterface::ExchangeData() noexcept
 {
 	// Process incoming packets
-	bool codeBufferAvailable = true;
+	bool codeBufferAvailable = true, receivedCodes = false;
 	for (size_t i = 0; i < transfer.PacketsToRead(); i++)
 	{
 		const PacketHeader * const packet = transfer.ReadPacket();
@@ -277,6 +278,7 @@ void SbcInterface::ExchangeData() noexcept
 				debugPrintf("Failed to store code, RX/TX %d/%d-%d\n", rxPointer, txPointer, txEnd);
 #endif
 				packetAcknowledged = codeBufferAvailable = false;
+				++codeBufferFullCount;
 				break;
 			}
 
@@ -298,6 +300,13 @@ void SbcInterface::ExchangeData() noexcept
 			const uint32_t *src = reinterpret_cast<const uint32_t *>(code);
 			memcpyu32(dst, src, packet->length / sizeof(uint32_t));
 			txPointer += bufferedCodeSize;
+			receivedCodes = true;
+
+			const uint16_t used = CodeBufferUsed();
+			if (used > maxCodeBufferUsed)
+			{
+				maxCodeBufferUsed = used;
+			}
 			break;
 		}
 
@@ -859,7 +868,8 @@ void SbcInterface::ExchangeData() noexcept
 	}
 
 	// Check if we can wait a short moment to reduce CPU load on the SBC
-	if (!skipNextDelay && numEvents < numMaxEvents && !waitingForFileChunk &&
+	// If the SBC is streaming codes to us and we still have room for more, don't delay because it probably has more codes queued
+	if (!skipNextDelay && !(receivedCodes && codeBufferAvailable) && numEvents < numMaxEvents && !waitingForFileChunk &&
 		!fileOperationPending && fileOperation == FileOperation::none)
 	{
 		delaying = true;
@@ -1198,6 +1208,10 @@ void SbcInterface::Diagnostics(MessageType mtype) noexcept
 	transfer.Diagnostics(mtype);
 	reprap.GetPlatform().MessageF(mtype, "State: %d, disconnects: %" PRIu32 ", timeouts: %" PRIu32 " total, %" PRIu32 " by SBC, IAP RAM available 0x%05" PRIx32 "\n", (int)state, numDisconnects, numTimeouts, numSbcTimeouts, iapRamAvailable);
 	reprap.GetPlatform().MessageF(mtype, "Buffer RX/TX: %d/%d-%d, open files: %u\n", (int)rxPointer, (int)txPointer, (int)txEnd, numOpenFiles);
+	reprap.GetPlatform().MessageF(mtype, "Code buffer max used %u/%u, full %" PRIu32 ", defragmented %" PRIu32 "\n",
+									maxCodeBufferUsed, (unsigned int)SpiCodeBufferSize, codeBufferFullCount, codeBufferDefragCount);
+	maxCodeBufferUsed = CodeBufferUsed();
+	codeBufferFullCount = codeBufferDefragCount = 0;
 #ifdef TRACK_FILE_CODES
 	reprap.GetPlatform().MessageF(mtype, "File codes read/handled: %d/%d, file macros open/closing: %d %d\n", (int)fileCodesRead, (int)fileCodesHandled, (int)fileMacrosRunning, (int)fileMacrosClosing);
 #endif
@@ -1237,9 +1251,16 @@ GCodeResult SbcInterface::HandleM576(GCodeBuffer& gb, const StringRef& reply) no
 		seen = true;
 	}
 
+	if (gb.Seen('C'))
+	{
+		transfer.SetDataChecksumChecking(gb.GetUIValue() != 0);
+		seen = true;
+	}
+
 	if (!seen)
 	{
-		reply.printf("Max transfer delay %" PRIu32 "ms, max number of events during delays: %" PRIu32, maxDelayBetweenTransfers, numMaxEvents);
+		reply.printf("Max transfer delay %" PRIu32 "ms, max number of events during delays: %" PRIu32 ", data checksums %s",
+						maxDelayBetweenTransfers, numMaxEvents, (transfer.IsCheckingDataChecksum()) ? "checked" : "not checked");
 	}
 	return GCodeResult::ok;
 }
@@ -1786,19 +1807,25 @@ void SbcInterface::DefragmentBufferedCodes() noexcept
 		if (txEnd == 0)
 		{
 			// Ring buffer data is sequential (rxPointer..txPointer, txEnd=0)
-			(void)DefragmentCodeBlock(rxPointer, txPointer);
+			if (DefragmentCodeBlock(rxPointer, txPointer))
+			{
+				++codeBufferDefragCount;
+			}
 		}
 		else
 		{
 			// Ring buffer overlapped (rxPointer..txEnd, 0..txPointer)
-			if (!DefragmentCodeBlock(rxPointer, txEnd) &&
-				!DefragmentCodeBlock(0, txPointer) &&
-				SpiCodeBufferSize - (size_t)txEnd > MaxCodeBufferSize)
+			if (DefragmentCodeBlock(rxPointer, txEnd) || DefragmentCodeBlock(0, txPointer))
+			{
+				++codeBufferDefragCount;
+			}
+			else if (SpiCodeBufferSize - (size_t)txEnd > MaxCodeBufferSize)
 			{
 				size_t endBufferSize = txEnd - rxPointer;
 				memmoveu32(reinterpret_cast<uint32_t*>(codeBuffer + SpiCodeBufferSize - endBufferSize), reinterpret_cast<uint32_t*>(codeBuffer + rxPointer), endBufferSize / sizeof(uint32_t));
 				rxPointer = SpiCodeBufferSize - endBufferSize;
 				txEnd = SpiCodeBufferSize;
+				++codeBufferDefragCount;
 			}
 		}
 	}
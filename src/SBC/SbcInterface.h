@@ -87,6 +87,8 @@ private:
 	char *codeBuffer;
 	volatile uint16_t rxPointer, txPointer, txEnd;
 	volatile bool sendBufferUpdate;
+	uint16_t maxCodeBufferUsed;											// high-water mark of the code buffer since the last diagnostics report
+	uint32_t codeBufferFullCount, codeBufferDefragCount;				// how often we couldn't store a code and how often we had to move buffered codes
 
 	uint32_t iapRamAvailable;											// must be at least 32Kb otherwise the SPI IAP can't work
 
@@ -142,8 +144,15 @@ private:
 	void DefragmentBufferedCodes() noexcept;								// Attempt to defragment the code buffer ring to avoid stalls
 	bool DefragmentCodeBlock(uint16_t start, volatile uint16_t &end) noexcept;	// Defragment a specific code buffer region returning true if anything was defragmented
 	void InvalidateBufferedCodes(GCodeChannel channel) noexcept;           	// Invalidate every buffered G-code of the corresponding channel from the buffer ring
+	uint16_t CodeBufferUsed() const noexcept;								// Return the number of bytes of the code buffer that are in use
 };
 
+// Return the number of bytes of the code buffer that are in use, including codes that have been processed but not yet removed from the buffer ring
+inline uint16_t SbcInterface::CodeBufferUsed() const noexcept
+{
+	return (txEnd == 0) ? txPointer - rxPointer : (txEnd - rxPointer) + txPointer;
+}
+
 inline void SbcInterface::SetPauseReason(FilePosition position, PrintPausedReason reason) noexcept
 {
 	TaskCriticalSectionLocker locker;
@@ -16,11 +16,23 @@
 
 FileInfoParser::FileInfoParser() noexcept
 	: parseState(notParsing), fileBeingParsed(nullptr), accumulatedParseTime(0), accumulatedReadTime(0), accumulatedSeekTime(0), fileOverlapLength(0)
+#if USE_FILE_INFO_CACHE
+	  , haveCachedFileInfoSeqs(false)
+#endif
 {
 	parsedFileInfo.Init();
 	parserMutex.Create("FileInfoParser");
 }
 
+// Return a pointer to the first comment in a null-terminated buffer, or to the null terminator if there are none.
+// Apart from the object height and the simulated time (which we search for including the preceding newline), everything that FileInfoParser looks for is in comments.
+// Most of the footer is moves without comments, so this saves a lot of string searching. memchr in newlib scans a word at a time.
+static inline const char *_ecv_array FindFirstComment(const char *_ecv_array bufp, size_t len) noexcept
+{
+	const char *_ecv_array const p = (const char *_ecv_array)memchr(bufp, ';', len);
+	return (p == nullptr) ? bufp + len : p;
+}
+
 // This following method needs to be called repeatedly until it returns true - this may take a few runs
 GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool quitEarly) noexcept
 {
@@ -99,6 +111,16 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 			info = parsedFileInfo;
 			return GCodeResult::ok;
 		}
+
+#if USE_FILE_INFO_CACHE
+		// If we parsed this file before then we can use the saved result
+		if (ReadCachedFileInfo(filePath, parsedFileInfo))
+		{
+			fileBeingParsed->Close();
+			info = parsedFileInfo;
+			return GCodeResult::ok;
+		}
+#endif
 		parseState = parsingHeader;
 	}
 
@@ -143,33 +165,36 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				accumulatedReadTime += now - startTime;
 				startTime = now;
 
+				// All the information we look for in the header is in comments, so we only need to search from the first comment onwards
+				const char *_ecv_array const commentStart = FindFirstComment(buf, sizeToScan);
+
 				// Search for filament usage (Cura puts it at the beginning of a G-code file)
 				if (parsedFileInfo.numFilaments == 0)
 				{
-					parsedFileInfo.numFilaments = FindFilamentUsed(buf);
+					parsedFileInfo.numFilaments = FindFilamentUsed(commentStart);
 					headerInfoComplete &= (parsedFileInfo.numFilaments != 0);
 				}
 
 				// Look for layer height
 				if (parsedFileInfo.layerHeight == 0.0)
 				{
-					headerInfoComplete &= FindLayerHeight(buf);
+					headerInfoComplete &= FindLayerHeight(commentStart);
 				}
 
 				// Look for slicer program
 				if (parsedFileInfo.generatedBy.IsEmpty())
 				{
-					headerInfoComplete &= FindSlicerInfo(buf);
+					headerInfoComplete &= FindSlicerInfo(commentStart);
 				}
 
 				// Look for print time
 				if (parsedFileInfo.printTime == 0)
 				{
-					headerInfoComplete &= FindPrintTime(buf);
+					headerInfoComplete &= FindPrintTime(commentStart);
 				}
 
 				// Look for thumbnail images
-				headerInfoComplete &= FindThumbnails(buf, bufferStartFileOffset);
+				headerInfoComplete &= FindThumbnails(commentStart, bufferStartFileOffset + (commentStart - buf));
 
 				// Keep track of the time stats
 				accumulatedParseTime += millis() - startTime;
@@ -194,9 +219,27 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				}
 				else
 				{
-					// No - copy the last chunk of the buffer for overlapping search
-					fileOverlapLength = min<size_t>(sizeToRead, GCODE_OVERLAP_SIZE);
-					memcpy(buf, &buf[sizeToRead - fileOverlapLength], fileOverlapLength);
+					// No. If we are part way through a thumbnail then skip the rest of the image data, because there is nothing else of interest in it.
+					// The size in the thumbnail header excludes the comment characters and line endings, so we may still scan the last part of it.
+					FilePosition thumbnailEnd = 0;
+					for (const GCodeFileInfo::ThumbnailInfo& th : parsedFileInfo.thumbnails)
+					{
+						if (th.IsValid())
+						{
+							thumbnailEnd = max<FilePosition>(thumbnailEnd, th.offset + th.size);
+						}
+					}
+
+					if (thumbnailEnd > pos + GCODE_READ_SIZE && thumbnailEnd < fileBeingParsed->Length() && fileBeingParsed->Seek(thumbnailEnd))
+					{
+						fileOverlapLength = 0;
+					}
+					else
+					{
+						// Copy the last chunk of the buffer for overlapping search
+						fileOverlapLength = min<size_t>(sizeToRead, GCODE_OVERLAP_SIZE);
+						memcpy(buf, &buf[sizeToRead - fileOverlapLength], fileOverlapLength);
+					}
 				}
 			}
 			break;
@@ -270,11 +313,12 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				startTime = now;
 
 				bool footerInfoComplete = true;
+				const char *_ecv_array const commentStart = FindFirstComment(buf, sizeToScan);
 
 				// Search for filament used
 				if (parsedFileInfo.numFilaments == 0)
 				{
-					parsedFileInfo.numFilaments = FindFilamentUsed(buf);
+					parsedFileInfo.numFilaments = FindFilamentUsed(commentStart);
 					if (parsedFileInfo.numFilaments == 0)
 					{
 						footerInfoComplete = false;
@@ -284,7 +328,7 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				// Search for layer height
 				if (parsedFileInfo.layerHeight == 0.0)
 				{
-					if (!FindLayerHeight(buf))
+					if (!FindLayerHeight(commentStart))
 					{
 						footerInfoComplete = false;
 					}
@@ -303,13 +347,13 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 				if (parsedFileInfo.numLayers == 0)
 				{
 					// Number of layers should come before the object height
-					(void)FindNumLayers(buf, sizeToScan);
+					(void)FindNumLayers(commentStart, sizeToScan - (commentStart - buf));
 				}
 
 				// Look for print time
 				if (parsedFileInfo.printTime == 0)
 				{
-					if (!FindPrintTime(buf) && fileBeingParsed->Length() - nextSeekPos <= GcodeFooterPrintTimeSearchSize)
+					if (!FindPrintTime(commentStart) && fileBeingParsed->Length() - nextSeekPos <= GcodeFooterPrintTimeSearchSize)
 					{
 						footerInfoComplete = false;
 					}
@@ -343,6 +387,9 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 						parsedFileInfo.numLayers = lrintf(parsedFileInfo.objectHeight / parsedFileInfo.layerHeight);
 					}
 					parsedFileInfo.incomplete = false;
+#if USE_FILE_INFO_CACHE
+					WriteCachedFileInfo(filePath, parsedFileInfo);
+#endif
 					info = parsedFileInfo;
 					return GCodeResult::ok;
 				}
@@ -374,6 +421,120 @@ GCodeResult FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& inf
 	return GCodeResult::notFinished;
 }
 
+#if USE_FILE_INFO_CACHE
+
+// Record stored in the file info cache. The magic number includes the size of GCodeFileInfo so that records written by firmware with a different layout are ignored.
+struct FileInfoCacheRecord
+{
+	uint32_t magic;
+	uint32_t pathHash1, pathHash2;					// two independent hashes of the path, to make false matches very unlikely
+	GCodeFileInfo info;
+
+	static constexpr uint32_t Magic = 0x46494301u ^ (uint32_t)sizeof(GCodeFileInfo);
+
+	static void HashPath(const char *_ecv_array filePath, uint32_t& hash1, uint32_t& hash2) noexcept;
+	static FilePosition Offset(uint32_t hash1) noexcept { return (hash1 % FileInfoCacheSlots) * sizeof(FileInfoCacheRecord); }
+	bool Matches(uint32_t hash1, uint32_t hash2) const noexcept { return magic == Magic && pathHash1 == hash1 && pathHash2 == hash2; }
+};
+
+// Hash the path, ignoring case because file names on the SD card are not case sensitive
+/*static*/ void FileInfoCacheRecord::HashPath(const char *_ecv_array filePath, uint32_t& hash1, uint32_t& hash2) noexcept
+{
+	hash1 = 2166136261u;							// FNV-1a
+	hash2 = 5381;									// djb2
+	while (*filePath != 0)
+	{
+		const uint8_t c = (uint8_t)tolower(*filePath++);
+		hash1 = (hash1 ^ c) * 16777619u;
+		hash2 = (hash2 * 33u) + c;
+	}
+}
+
+// Look up the file in the cache. On entry, info holds the size and last modified time of the file. Return true if info has been filled in from the cache.
+// We use the parser buffer to read the record, because we may be running in a task with a small stack.
+bool FileInfoParser::ReadCachedFileInfo(const char *_ecv_array filePath, GCodeFileInfo& info) noexcept
+{
+	static_assert(sizeof(FileInfoCacheRecord) <= sizeof(buf));
+
+	CheckCachedFileInfoSeqs();
+
+	uint32_t hash1, hash2;
+	FileInfoCacheRecord::HashPath(filePath, hash1, hash2);
+
+	FileStore * const f = reprap.GetPlatform().OpenSysFile(FileInfoCacheFileName, OpenMode::read);
+	if (f == nullptr)
+	{
+		return false;
+	}
+
+	bool found = false;
+	FileInfoCacheRecord * const record = reinterpret_cast<FileInfoCacheRecord*>(buf);
+	if (   f->Seek(FileInfoCacheRecord::Offset(hash1))
+		&& f->Read(buf, sizeof(FileInfoCacheRecord)) == (int)sizeof(FileInfoCacheRecord)
+		&& record->Matches(hash1, hash2)
+		&& record->info.fileSize == info.fileSize
+		&& record->info.lastModifiedTime == info.lastModifiedTime
+	   )
+	{
+		info = record->info;
+		found = true;
+	}
+	f->Close();
+	return found;
+}
+
+// If any volume has been written to, mounted or unmounted since we last looked at the cache then discard the whole cache.
+// We don't check this before saving a record, because a record saved after a change has been seen would then be trusted.
+// We can't tell what changed before we started, so the first time we get here we just record the sequence numbers.
+void FileInfoParser::CheckCachedFileInfoSeqs() noexcept
+{
+	const size_t numVolumes = min<size_t>(MassStorage::GetNumVolumes(), NumSdCards);
+	bool changed = !haveCachedFileInfoSeqs;
+	for (size_t i = 0; i < numVolumes && !changed; ++i)
+	{
+		if (cachedFileInfoSeqs[i] != MassStorage::GetVolumeSeq(i))
+		{
+			changed = true;
+		}
+	}
+
+	if (changed)
+	{
+		Platform& p = reprap.GetPlatform();
+		if (haveCachedFileInfoSeqs && p.SysFileExists(FileInfoCacheFileName))
+		{
+			(void)p.DeleteSysFile(FileInfoCacheFileName);
+		}
+
+		// Deleting the file changes the sequence number, so read them again
+		for (size_t i = 0; i < numVolumes; ++i)
+		{
+			cachedFileInfoSeqs[i] = MassStorage::GetVolumeSeq(i);
+		}
+		haveCachedFileInfoSeqs = true;
+	}
+}
+
+// Save the info for a file that we have finished parsing
+void FileInfoParser::WriteCachedFileInfo(const char *_ecv_array filePath, const GCodeFileInfo& info) noexcept
+{
+	FileStore * const f = reprap.GetPlatform().OpenSysFile(FileInfoCacheFileName, OpenMode::append);
+	if (f != nullptr)
+	{
+		FileInfoCacheRecord * const record = reinterpret_cast<FileInfoCacheRecord*>(buf);
+		record->magic = FileInfoCacheRecord::Magic;
+		FileInfoCacheRecord::HashPath(filePath, record->pathHash1, record->pathHash2);
+		record->info = info;
+		if (!f->Seek(FileInfoCacheRecord::Offset(record->pathHash1)) || !f->Write(buf, sizeof(FileInfoCacheRecord)))
+		{
+			reprap.GetPlatform().Message(WarningMessage, "Failed to update file info cache\n");
+		}
+		f->Close();
+	}
+}
+
+#endif
+
 // Scan the buffer for a G1 Zxxx command. The buffer is null-terminated.
 // This parsing algorithm needs to be fast. The old one sometimes took 5 seconds or more to parse about 120K of data.
 // To speed up parsing, we now parse forwards from the start of the buffer. This means we can't stop when we have found a G1 Z command,
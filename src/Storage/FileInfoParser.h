@@ -31,6 +31,19 @@ const size_t GCODE_OVERLAP_SIZE = 100;				// Size of the overlapping buffer for
 const uint32_t MAX_FILEINFO_PROCESS_TIME = 200;		// Maximum time to spend polling for file info in each call
 const uint32_t MaxFileParseInterval = 4000;			// Maximum interval between repeat requests to parse a file
 
+// Parsed file info is saved in a hash table in a file in /sys so that we don't have to parse the same file again.
+// Entries are keyed on the path, size and last modified time, so a file that has been replaced by an upload or edited is parsed again.
+// A file may be replaced by one with the same size and time, for example when the clock has not been set, so we also discard the whole cache
+// when the sequence number of any volume changes while we are running.
+#ifndef USE_FILE_INFO_CACHE
+# define USE_FILE_INFO_CACHE	(HAS_MASS_STORAGE)
+#endif
+
+#if USE_FILE_INFO_CACHE
+constexpr const char *_ecv_array FileInfoCacheFileName = ".fileinfo.cache";	// in the system directory
+constexpr unsigned int FileInfoCacheSlots = 256;								// number of records in the cache file
+#endif
+
 enum FileParseState
 {
 	notParsing,
@@ -62,6 +75,13 @@ private:
 	void FindFilamentUsedEmbedded(const char *_ecv_array p, const char *_ecv_array s1, const char *_ecv_array s2, unsigned int &filamentsFound) noexcept;
 	bool FindThumbnails(const char *_ecv_array bufp, FilePosition bufferStartFilePosition) noexcept;
 
+#if USE_FILE_INFO_CACHE
+	// File info cache methods
+	bool ReadCachedFileInfo(const char *_ecv_array filePath, GCodeFileInfo& info) noexcept;
+	void WriteCachedFileInfo(const char *_ecv_array filePath, const GCodeFileInfo& info) noexcept;
+	void CheckCachedFileInfoSeqs() noexcept;
+#endif
+
 	// We parse G-Code files in multiple stages. These variables hold the required information
 	Mutex parserMutex;
 
@@ -73,6 +93,10 @@ private:
 	uint32_t lastFileParseTime;
 	uint32_t accumulatedParseTime, accumulatedReadTime, accumulatedSeekTime;
 	size_t fileOverlapLength;
+#if USE_FILE_INFO_CACHE
+	uint16_t cachedFileInfoSeqs[NumSdCards];						// the volume sequence numbers when we last checked the file info cache
+	bool haveCachedFileInfoSeqs;
+#endif
 
 	// We used to allocate the following buffer on the stack; but now that this is called by more than one task
 	// it is more economical to allocate it permanently because that lets us use smaller stacks.
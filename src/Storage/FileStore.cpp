@@ -47,6 +47,10 @@ void FileStore::Init() noexcept
 #if HAS_EMBEDDED_FILES || HAS_SBC_INTERFACE
 	offset = 0;
 #endif
+#if SUPPORT_MACRO_CACHE
+	cacheOffset = 0;
+	cacheEntry = -1;
+#endif
 }
 
 // Open a local file (for example on an SD card).
@@ -180,6 +184,41 @@ bool FileStore::Open(const char *_ecv_array filePath, OpenMode mode, uint32_t pr
 #endif
 }
 
+#if SUPPORT_MACRO_CACHE
+
+// Open a macro file for reading. If the macro cache holds a current copy of the file then we read that instead of the file itself, otherwise we try to add the file to the cache.
+// Caller must own the file system mutex.
+bool FileStore::OpenMacro(const char *_ecv_array filePath) noexcept
+{
+# if HAS_SBC_INTERFACE
+	if (reprap.UsingSbcInterface())
+	{
+		return Open(filePath, OpenMode::read, 0);
+	}
+# endif
+
+	cacheEntry = MacroCache::Find(filePath);
+	if (cacheEntry >= 0)
+	{
+		cacheOffset = 0;
+		writeBuffer = nullptr;
+		file.obj.fs = nullptr;						// so that unmounting the volume doesn't invalidate this file, and it isn't mistaken for one that is open on the volume
+		closeRequested = false;
+		usageMode = FileUseMode::readOnly;
+		openCount = 1;
+		return true;
+	}
+
+	if (!Open(filePath, OpenMode::read, 0))
+	{
+		return false;
+	}
+	MacroCache::Store(filePath, *this);
+	return true;
+}
+
+#endif
+
 #if HAS_MASS_STORAGE || HAS_SBC_INTERFACE || HAS_EMBEDDED_FILES
 
 // This may be called from an ISR, in which case we need to defer the close
@@ -245,6 +284,13 @@ bool FileStore::Seek(FilePosition pos) noexcept
 
 	case FileUseMode::readOnly:
 	case FileUseMode::readWrite:
+#if SUPPORT_MACRO_CACHE
+		if (cacheEntry >= 0)
+		{
+			cacheOffset = min<FilePosition>(pos, MacroCache::Length(cacheEntry));
+			return true;
+		}
+#endif
 #if HAS_SBC_INTERFACE
 		if (reprap.UsingSbcInterface())
 		{
@@ -273,6 +319,12 @@ bool FileStore::Seek(FilePosition pos) noexcept
 
 FilePosition FileStore::Position() const noexcept
 {
+#if SUPPORT_MACRO_CACHE
+	if (cacheEntry >= 0)
+	{
+		return cacheOffset;
+	}
+#endif
 #if HAS_SBC_INTERFACE
 	if (reprap.UsingSbcInterface())
 	{
@@ -297,6 +349,12 @@ FilePosition FileStore::Length() const noexcept
 		return 0;
 
 	case FileUseMode::readOnly:
+#if SUPPORT_MACRO_CACHE
+		if (cacheEntry >= 0)
+		{
+			return MacroCache::Length(cacheEntry);
+		}
+#endif
 #if HAS_SBC_INTERFACE
 		if (reprap.UsingSbcInterface())
 		{
@@ -383,6 +441,14 @@ int FileStore::Read(char *_ecv_array extBuf, size_t nBytes) noexcept
 
 	case FileUseMode::readOnly:
 	case FileUseMode::readWrite:
+#if SUPPORT_MACRO_CACHE
+		if (cacheEntry >= 0)
+		{
+			const int ret = MacroCache::Read(cacheEntry, cacheOffset, extBuf, nBytes);
+			cacheOffset += ret;
+			return ret;
+		}
+#endif
 #if HAS_SBC_INTERFACE
 		if (reprap.UsingSbcInterface())
 		{
@@ -475,6 +541,18 @@ bool FileStore::ForceClose() noexcept
 	}
 #endif
 
+#if SUPPORT_MACRO_CACHE
+	if (cacheEntry >= 0)
+	{
+		MacroCache::Release(cacheEntry);
+		cacheEntry = -1;
+		usageMode = FileUseMode::free;
+		closeRequested = false;
+		openCount = 0;
+		return ok;
+	}
+#endif
+
 #if HAS_SBC_INTERFACE
 	if (reprap.UsingSbcInterface())
 	{
@@ -488,6 +566,12 @@ bool FileStore::ForceClose() noexcept
 
 #if HAS_MASS_STORAGE
 	const FRESULT fr = f_close(&file);
+# if SUPPORT_MACRO_CACHE
+	if (usageMode == FileUseMode::readWrite)
+	{
+		MacroCache::FileWritten();									// the file may be a macro that the cache holds an old copy of
+	}
+# endif
 	usageMode = FileUseMode::free;
 	closeRequested = false;
 	openCount = 0;
@@ -532,13 +616,9 @@ void FileStore::Duplicate() noexcept
 
 #if HAS_MASS_STORAGE || HAS_SBC_INTERFACE
 
+// Write data to the file system. The caller is responsible for updating the CRC.
 bool FileStore::Store(const char *_ecv_array s, size_t len, size_t *bytesWritten) noexcept
 {
-	if (calcCrc)
-	{
-		crc.Update(s, len);
-	}
-
 #if HAS_SBC_INTERFACE
 	if (reprap.UsingSbcInterface())
 	{
@@ -588,6 +668,13 @@ bool FileStore::Write(const char *_ecv_array s, size_t len) noexcept
 	case FileUseMode::readOnly:
 	case FileUseMode::readWrite:
 		{
+			// Calculate the CRC on the caller's data, which is typically still in cache, instead of when we write out the write buffer.
+			// On the SAME70 the write buffers are in non-cached memory so that the HSMCI can DMA from them, so reading them back is slow.
+			if (calcCrc)
+			{
+				crc.Update(s, len);
+			}
+
 			size_t totalBytesWritten = 0;
 			bool writeOk = true;
 			if (writeBuffer == nullptr)
@@ -731,7 +818,7 @@ bool FileStore::IsSameFile(const FIL& otherFile) const noexcept
 
 uint32_t FileStore::ClusterSize() const noexcept
 {
-	return (usageMode == FileUseMode::readOnly || usageMode == FileUseMode::readWrite) ? file.obj.fs->csize * 512u : 1;	// we divide by the cluster size so return 1 not 0 if there is an error
+	return ((usageMode == FileUseMode::readOnly || usageMode == FileUseMode::readWrite) && file.obj.fs != nullptr) ? file.obj.fs->csize * 512u : 1;	// we divide by the cluster size so return 1 not 0 if there is an error
 }
 
 #endif	// HAS_MASS_STORAGE
@@ -10,6 +10,7 @@
 #if HAS_MASS_STORAGE || HAS_SBC_INTERFACE
 # include "CRC32.h"
 #endif
+#include "MacroCache.h"
 
 class Platform;
 class FileWriteBuffer;
@@ -42,6 +43,9 @@ public:
 	FileStore() noexcept;
 
     bool Open(const char* filePath, OpenMode mode, uint32_t preAllocSize) noexcept;
+#if SUPPORT_MACRO_CACHE
+	bool OpenMacro(const char *_ecv_array filePath) noexcept;	// Open a macro file for reading, using the cached copy if there is one
+#endif
 	bool Read(char& b) noexcept
 		{ return Read((char *_ecv_array)&b, sizeof(char)); }					// Read 1 character
 	bool Read(uint8_t& b) noexcept
@@ -117,6 +121,11 @@ private:
 	FilePosition offset;
 #endif
 
+#if SUPPORT_MACRO_CACHE
+	FilePosition cacheOffset;
+	int cacheEntry;												// the macro cache entry we are reading from, or -1 if we are reading the file itself
+#endif
+
 	volatile bool closeRequested;
 	FileUseMode usageMode;
 
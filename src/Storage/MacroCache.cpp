@@ -0,0 +1,214 @@
+/*
+ * MacroCache.cpp
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ */
+
+#include "MacroCache.h"
+
+#if SUPPORT_MACRO_CACHE
+
+#include "FileStore.h"
+#include "MassStorage.h"
+#include <Platform/RepRap.h>
+#include <Platform/Platform.h>
+
+MacroCache::Entry MacroCache::entries[NumEntries];
+size_t MacroCache::bytesUsed = 0;
+uint32_t MacroCache::useCounter = 0;
+unsigned int MacroCache::hits = 0;
+unsigned int MacroCache::misses = 0;
+volatile uint32_t MacroCache::filesWritten = 0;
+
+static uint16_t GetSeq(const char *_ecv_array path) noexcept
+{
+	const unsigned int volume = MassStorage::VolumeFromPath(path);
+	return (volume < MassStorage::GetNumVolumes()) ? MassStorage::GetVolumeSeq(volume) : 0;
+}
+
+// Free the data of an entry. It must not have any users.
+void MacroCache::Free(Entry& e) noexcept
+{
+	if (e.data != nullptr)
+	{
+		delete[] e.data;
+		e.data = nullptr;
+		bytesUsed -= e.length;
+	}
+	e.path.Clear();
+	e.stale = false;
+}
+
+// Return true if the entry holds data and the file may not have changed since we read it
+bool MacroCache::IsCurrent(const Entry& e) noexcept
+{
+	return e.data != nullptr && !e.stale && e.volumeSeq == GetSeq(e.path.c_str()) && e.filesWritten == filesWritten;
+}
+
+int MacroCache::Find(const char *_ecv_array filePath) noexcept
+{
+	for (size_t i = 0; i < NumEntries; ++i)
+	{
+		Entry& e = entries[i];
+		if (e.data != nullptr && StringEqualsIgnoreCase(e.path.c_str(), filePath))
+		{
+			if (IsCurrent(e))
+			{
+				const irqflags_t flags = IrqSave();
+				++e.users;
+				IrqRestore(flags);
+				e.lastUsed = ++useCounter;
+				++hits;
+				return (int)i;
+			}
+
+			// The file may have changed, so discard this copy now or when the last user has finished with it
+			e.stale = true;
+			if (e.users == 0)
+			{
+				Free(e);
+			}
+		}
+	}
+	++misses;
+	return -1;
+}
+
+void MacroCache::Store(const char *_ecv_array filePath, FileStore& f) noexcept
+{
+	const FilePosition length = f.Length();
+	if (length == 0 || length > MaxFileLength || strlen(filePath) >= MaxFilenameLength)
+	{
+		return;
+	}
+
+	// Record the write count before we read the file, so that if a file is written and closed while we read it then the copy we make is discarded
+	const uint32_t locFilesWritten = filesWritten;
+
+	// Choose an entry to use, reclaiming stale entries and then evicting the least recently used ones until there is room
+	Entry *_ecv_null slot = nullptr;
+	for (;;)
+	{
+		Entry *_ecv_null lru = nullptr;
+		for (Entry& e : entries)
+		{
+			if (e.users == 0)
+			{
+				if (e.data != nullptr && !IsCurrent(e))
+				{
+					Free(e);
+				}
+				if (e.data == nullptr)
+				{
+					if (slot == nullptr)
+					{
+						slot = &e;
+					}
+				}
+				else if (lru == nullptr || (int32_t)(e.lastUsed - lru->lastUsed) < 0)
+				{
+					lru = &e;
+				}
+			}
+		}
+
+		if (slot != nullptr && bytesUsed + length <= MACRO_CACHE_SIZE)
+		{
+			break;
+		}
+		if (lru == nullptr)
+		{
+			return;								// everything that might be evicted is in use
+		}
+		Free(*lru);
+	}
+
+	char *_ecv_array const data = new char[length];
+	if (f.Read(data, length) == (int)length && f.Seek(0))
+	{
+		slot->path.copy(filePath);
+		slot->data = data;
+		slot->length = length;
+		slot->lastUsed = ++useCounter;
+		slot->volumeSeq = GetSeq(filePath);
+		slot->filesWritten = locFilesWritten;
+		slot->users = 0;
+		slot->stale = false;
+		bytesUsed += length;
+	}
+	else
+	{
+		delete[] data;
+		(void)f.Seek(0);
+	}
+}
+
+void MacroCache::Invalidate(const char *_ecv_array filePath) noexcept
+{
+	for (Entry& e : entries)
+	{
+		if (e.data != nullptr && StringEqualsIgnoreCase(e.path.c_str(), filePath))
+		{
+			e.stale = true;
+			if (e.users == 0)
+			{
+				Free(e);
+			}
+		}
+	}
+}
+
+// Record that a file that was open for writing has been closed. Writing to a file doesn't change the volume sequence number,
+// and we don't know which path the file has, so this makes all entries stale. This may be called without owning the file system mutex.
+void MacroCache::FileWritten() noexcept
+{
+	++filesWritten;
+}
+
+FilePosition MacroCache::Length(int entry) noexcept
+{
+	return entries[entry].length;
+}
+
+int MacroCache::Read(int entry, FilePosition pos, char *_ecv_array buf, size_t nBytes) noexcept
+{
+	const Entry& e = entries[entry];
+	if (pos >= e.length)
+	{
+		return 0;
+	}
+	const size_t bytesToCopy = min<size_t>(nBytes, e.length - pos);
+	memcpy(buf, e.data + pos, bytesToCopy);
+	return (int)bytesToCopy;
+}
+
+// Release an entry. If it has become stale then it will be freed the next time we look for a file or store one.
+void MacroCache::Release(int entry) noexcept
+{
+	Entry& e = entries[entry];
+	const irqflags_t flags = IrqSave();
+	if (e.users != 0)
+	{
+		--e.users;
+	}
+	IrqRestore(flags);
+}
+
+void MacroCache::Diagnostics(MessageType mtype) noexcept
+{
+	unsigned int numCached = 0;
+	for (const Entry& e : entries)
+	{
+		if (e.data != nullptr)
+		{
+			++numCached;
+		}
+	}
+	reprap.GetPlatform().MessageF(mtype, "Macro cache: %u files using %u bytes, hits %u, misses %u\n", numCached, bytesUsed, hits, misses);
+	hits = misses = 0;
+}
+
+#endif
+
+// End
@@ -0,0 +1,85 @@
+/*
+ * MacroCache.h
+ *
+ *  Created on: 14 Oct 2026
+ *      Author: agent
+ *
+ * This class keeps copies of recently used macro files in RAM, so that macros that are run many times per job (e.g. tool change macros) can be read without
+ * opening the file on the SD card again. An entry is discarded when the sequence number of its volume changes, which happens whenever a file on that volume is
+ * written, deleted or renamed, or the volume is mounted or unmounted. Files opened in append mode don't change the sequence number, so they discard any entry
+ * for the same path explicitly. Data written after a file was opened doesn't change the sequence number either, so all entries are discarded when a file
+ * that was open for writing is closed.
+ */
+
+#ifndef SRC_STORAGE_MACROCACHE_H_
+#define SRC_STORAGE_MACROCACHE_H_
+
+#include <RepRapFirmware.h>
+
+#ifndef SUPPORT_MACRO_CACHE
+# define SUPPORT_MACRO_CACHE	0
+#endif
+
+#if SUPPORT_MACRO_CACHE
+
+#if !HAS_MASS_STORAGE
+# error "Macro cache support requires mass storage"
+#endif
+
+#ifndef MACRO_CACHE_SIZE
+# define MACRO_CACHE_SIZE		(8 * 1024)			// total RAM in bytes that the cached file contents may occupy
+#endif
+
+class FileStore;
+
+class MacroCache
+{
+public:
+	static constexpr size_t NumEntries = 8;
+	static constexpr size_t MaxFileLength = MACRO_CACHE_SIZE/2;
+
+	// Find a valid cached copy of a file and register a new user of it. Returns the entry number, or -1 if the file is not cached. Caller must own the file system mutex.
+	static int Find(const char *_ecv_array filePath) noexcept;
+
+	// Copy the contents of an open file into the cache if it is small enough, leaving the file positioned at the start. Caller must own the file system mutex.
+	static void Store(const char *_ecv_array filePath, FileStore& f) noexcept;
+
+	// Discard any cached copy of the specified file. Caller must own the file system mutex.
+	static void Invalidate(const char *_ecv_array filePath) noexcept;
+
+	// Discard all cached copies because a file that was open for writing has been closed
+	static void FileWritten() noexcept;
+
+	// Functions used by FileStore to read the cached data. The entry stays valid until the user releases it.
+	static FilePosition Length(int entry) noexcept;
+	static int Read(int entry, FilePosition pos, char *_ecv_array buf, size_t nBytes) noexcept;
+	static void Release(int entry) noexcept;
+
+	static void Diagnostics(MessageType mtype) noexcept;
+
+private:
+	struct Entry
+	{
+		String<MaxFilenameLength> path;
+		char *_ecv_array _ecv_null data;
+		FilePosition length;
+		uint32_t lastUsed;
+		uint32_t filesWritten;											// the value of filesWritten when we read the file
+		uint16_t volumeSeq;
+		volatile uint8_t users;
+		bool stale;
+	};
+
+	static void Free(Entry& e) noexcept;
+	static bool IsCurrent(const Entry& e) noexcept;
+
+	static Entry entries[NumEntries];
+	static size_t bytesUsed;
+	static uint32_t useCounter;
+	static unsigned int hits, misses;
+	static volatile uint32_t filesWritten;								// how many files that were open for writing have been closed
+};
+
+#endif
+
+#endif /* SRC_STORAGE_MACROCACHE_H_ */
@@ -134,6 +134,25 @@ DEFINE_GET_OBJECT_MODEL_TABLE(SdCardInfo)
 
 static SdCardInfo info[NumSdCards];
 static DIR findDir;
+static DIR findDirBeforeLastRead;					// the state of findDir before the most recent call to f_readdir
+static String<MaxFilenameLength> findDirPath;
+
+// Positions at which recent paged file listings stopped, so that the next page can resume there instead of enumerating the directory from the start.
+// A cursor is a copy of the FatFs DIR object. This is only safe because we don't use FatFs file locking, and the cursor is discarded if the volume sequence number changes.
+static_assert(FF_FS_LOCK == 0, "Directory cursors need FF_FS_LOCK == 0");
+
+struct DirCursor
+{
+	String<MaxFilenameLength> path;
+	DIR dir;
+	unsigned int index;
+	uint16_t seq;
+	bool valid;
+};
+
+constexpr size_t NumDirCursors = 2;
+static DirCursor dirCursors[NumDirCursors];
+static size_t nextDirCursor = 0;
 #endif
 
 #if HAS_MASS_STORAGE || HAS_EMBEDDED_FILES
@@ -233,6 +252,11 @@ uint16_t MassStorage::GetVolumeSeq(unsigned int volume) noexcept
 	return info[volume].seq;
 }
 
+unsigned int MassStorage::VolumeFromPath(const char *_ecv_array path) noexcept
+{
+	return (isdigit(path[0]) && path[1] == ':') ? path[0] - '0' : 0;
+}
+
 // If 'path' is not the name of a temporary file, update the sequence number of its volume
 // Return true if we did update the sequence number
 static bool VolumeUpdated(const char *path) noexcept
@@ -243,7 +267,7 @@ static bool VolumeUpdated(const char *path) noexcept
 #endif
 	   )
 	{
-		const unsigned int volume = (isdigit(path[0]) && path[1] == ':') ? path[0] - '0' : 0;
+		const unsigned int volume = MassStorage::VolumeFromPath(path);
 		if (volume < ARRAY_SIZE(info))
 		{
 			++info[volume].seq;
@@ -463,6 +487,12 @@ FileStore* MassStorage::OpenFile(const char* filePath, OpenMode mode, uint32_t p
 				{
 					(void)VolumeUpdated(filePath);
 				}
+# endif
+# if SUPPORT_MACRO_CACHE
+				if (ret != nullptr && mode == OpenMode::append)
+				{
+					MacroCache::Invalidate(filePath);				// appending doesn't change the volume sequence number
+				}
 # endif
 				return ret;
 			}
@@ -472,6 +502,26 @@ FileStore* MassStorage::OpenFile(const char* filePath, OpenMode mode, uint32_t p
 	return nullptr;
 }
 
+# if SUPPORT_MACRO_CACHE
+
+FileStore* MassStorage::OpenMacroFile(const char *_ecv_array filePath) noexcept
+{
+	{
+		MutexLocker lock(fsMutex);
+		for (size_t i = 0; i < MAX_FILES; i++)
+		{
+			if (files[i].IsFree())
+			{
+				return (files[i].OpenMacro(filePath)) ? &files[i]: nullptr;
+			}
+		}
+	}
+	reprap.GetPlatform().Message(ErrorMessage, "Max open file count exceeded.\n");
+	return nullptr;
+}
+
+# endif
+
 // Close all files
 void MassStorage::CloseAllFiles() noexcept
 {
@@ -678,6 +728,18 @@ bool MassStorage::Delete(const char* filePath, bool messageIfFailed) noexcept
 // by calling FindNext until it returns false, or by calling AbandonFindNext.
 bool MassStorage::FindFirst(const char *directory, FileInfo &file_info) noexcept
 {
+	unsigned int startIndex = 0;
+	return FindFirst(directory, file_info, startIndex);
+}
+
+// As above, but on entry 'startIndex' is the index of the first entry the caller is interested in.
+// If RememberFindPosition was called with that index for this directory and nothing on the volume has changed since, enumeration resumes there.
+// On return 'startIndex' is the index of the entry returned, which is either 0 or the value passed.
+bool MassStorage::FindFirst(const char *directory, FileInfo &file_info, unsigned int& startIndex) noexcept
+{
+	const unsigned int wantedIndex = startIndex;
+	startIndex = 0;
+
 	// Remove any trailing '/' from the directory name, it sometimes (but not always) confuses f_opendir
 	String<MaxFilenameLength> loc;
 	loc.copy(directory);
@@ -693,13 +755,36 @@ bool MassStorage::FindFirst(const char *directory, FileInfo &file_info) noexcept
 	}
 
 #if HAS_MASS_STORAGE
-	FRESULT res = f_opendir(&findDir, loc.c_str());
+	FRESULT res = FR_NO_PATH;
+	if (wantedIndex != 0)
+	{
+		const unsigned int volume = VolumeFromPath(loc.c_str());
+		for (DirCursor& cursor : dirCursors)
+		{
+			if (cursor.valid && cursor.index == wantedIndex && volume < ARRAY_SIZE(info) && cursor.seq == info[volume].seq && StringEqualsIgnoreCase(cursor.path.c_str(), loc.c_str()))
+			{
+				findDir = cursor.dir;
+				cursor.valid = false;
+				startIndex = wantedIndex;
+				res = FR_OK;
+				break;
+			}
+		}
+	}
+
+	if (res != FR_OK)
+	{
+		res = f_opendir(&findDir, loc.c_str());
+	}
+
 	if (res == FR_OK)
 	{
 		FILINFO entry;
+		findDirPath.copy(loc.c_str());
 
 		for (;;)
 		{
+			findDirBeforeLastRead = findDir;
 			res = f_readdir(&findDir, &entry);
 			if (res != FR_OK || entry.fname[0] == 0) break;
 			if (!StringEqualsIgnoreCase(entry.fname, ".") && !StringEqualsIgnoreCase(entry.fname, ".."))
@@ -736,6 +821,7 @@ bool MassStorage::FindNext(FileInfo &file_info) noexcept
 #if HAS_MASS_STORAGE
 	FILINFO entry;
 
+	findDirBeforeLastRead = findDir;
 	if (f_readdir(&findDir, &entry) == FR_OK && entry.fname[0] != 0)
 	{
 		file_info.isDirectory = (entry.fattrib & AM_DIR);
@@ -758,6 +844,40 @@ bool MassStorage::FindNext(FileInfo &file_info) noexcept
 	return false;
 }
 
+#if HAS_MASS_STORAGE
+
+// Remember the position of the entry most recently returned by FindFirst or FindNext, so that a later call to FindFirst with the same index can resume from it.
+// The caller must hold the mutex, i.e. the last call to FindFirst or FindNext must have returned true.
+void MassStorage::RememberFindPosition(unsigned int index) noexcept
+{
+	if (dirMutex.GetHolder() == RTOSIface::GetCurrentTask())
+	{
+		// Reuse the cursor for this directory if we have one, else the oldest one
+		DirCursor *cursor = &dirCursors[nextDirCursor];
+		for (DirCursor& c : dirCursors)
+		{
+			if (c.valid && StringEqualsIgnoreCase(c.path.c_str(), findDirPath.c_str()))
+			{
+				cursor = &c;
+				break;
+			}
+		}
+		if (cursor == &dirCursors[nextDirCursor])
+		{
+			nextDirCursor = (nextDirCursor + 1) % NumDirCursors;
+		}
+
+		const unsigned int volume = VolumeFromPath(findDirPath.c_str());
+		cursor->path.copy(findDirPath.c_str());
+		cursor->dir = findDirBeforeLastRead;
+		cursor->index = index;
+		cursor->seq = (volume < ARRAY_SIZE(info)) ? info[volume].seq : 0;
+		cursor->valid = true;
+	}
+}
+
+#endif
+
 // Quit searching for files. Needed to avoid hanging on to the mutex. Safe to call even if the caller doesn't hold the mutex.
 void MassStorage::AbandonFindNext() noexcept
 {
@@ -1158,6 +1278,9 @@ void MassStorage::Diagnostics(MessageType mtype) noexcept
 	platform.MessageF(mtype, "SD card longest read time %.1fms, write time %.1fms, max retries %u\n",
 								(double)DiskioGetAndClearLongestReadTime(), (double)DiskioGetAndClearLongestWriteTime(), DiskioGetAndClearMaxRetryCount());
 # endif
+# if SUPPORT_MACRO_CACHE
+	MacroCache::Diagnostics(mtype);
+# endif
 }
 
 #endif
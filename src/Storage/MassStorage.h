@@ -44,6 +44,9 @@ namespace MassStorage
 #if HAS_MASS_STORAGE || HAS_SBC_INTERFACE || HAS_EMBEDDED_FILES
 	void Init() noexcept;
 	FileStore* OpenFile(const char* filePath, OpenMode mode, uint32_t preAllocSize) noexcept;
+# if SUPPORT_MACRO_CACHE
+	FileStore* OpenMacroFile(const char *_ecv_array filePath) noexcept;						// Open a macro file for reading, using the macro cache
+# endif
 	bool FileExists(const char *filePath) noexcept;
 	void CloseAllFiles() noexcept;
 	void Spin() noexcept;
@@ -73,6 +76,7 @@ namespace MassStorage
 	unsigned int GetNumFreeFiles() noexcept;
 	bool IsDriveMounted(size_t drive) noexcept;
 	bool FindFirst(const char *_ecv_array directory, FileInfo &file_info) noexcept;
+	bool FindFirst(const char *_ecv_array directory, FileInfo &file_info, unsigned int& startIndex) noexcept;
 	bool FindNext(FileInfo &file_info) noexcept;
 	void AbandonFindNext() noexcept;
 	GCodeResult GetFileInfo(const char *_ecv_array filePath, GCodeFileInfo& info, bool quitEarly) noexcept;
@@ -94,6 +98,8 @@ namespace MassStorage
 	Mutex& GetVolumeMutex(size_t vol) noexcept;
 	void RecordSimulationTime(const char *_ecv_array printingFilePath, uint32_t simSeconds) noexcept;	// Append the simulated printing time to the end of the file
 	uint16_t GetVolumeSeq(unsigned int volume) noexcept;
+	unsigned int VolumeFromPath(const char *_ecv_array path) noexcept;						// Return the volume number that a path refers to
+	void RememberFindPosition(unsigned int index) noexcept;								// Remember where a paged file listing stopped so that the next page can start there
 
 	enum class InfoResult : uint8_t
 	{